@@ -0,0 +1,717 @@
+// Benchmark the browser pipeline headlessly over a generated corpus.
+//
+//   CBrowserBench [-corpus <dir>] [-page <name>] [-iterations <n>] [-output <file>] ...
+//
+// Each corpus page (nesting, table, text, css, images, svg, forms) is loaded and painted
+// at the viewport size and per-phase self time (parse, dom, style, layout, image, paint)
+// and allocation counts are reported with totals and peak RSS as JSON. Page sizes can be
+// set with -depth, -rows, -cols, -paragraphs, -rules, -images, -shapes and -controls.
+//
+// Trace counters of the last load are also reported for each page, e.g. bytes per
+// object with shared style values (object_bytes) and with a copy of every style group
+// (object_unshared_bytes), and SVG objects pre-rendered on worker threads
+// (svg_thread_renders), serially (svg_serial_renders) or rendered when drawn
+// (svg_draw_renders).
+//
+// Peak RSS is for the process so far, run a single page (-page) for isolated values.
+//
+// The SVG filter color operations are also timed against a reference per-pixel
+// implementation using the public getPixel/setPixel interface (-image_size sets the
+// image width and height, -no_image_data skips). This includes even order convolve
+// kernels, max_diff checks the results agree.
+
+#include <CBrowserBenchCorpus.h>
+#include <CBrowserMain.h>
+#include <CBrowserMainWindow.h>
+#include <CBrowserScrolledWindow.h>
+#include <CBrowserWindow.h>
+#include <CBrowserTrace.h>
+#include <CQSVGImageData.h>
+#include <CQApp.h>
+#include <CArgs.h>
+#include <QImage>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+//---
+
+// count operator new calls (and bytes) made by the whole process
+namespace {
+
+std::atomic<long> numAllocs { 0 };
+std::atomic<long> numAllocBytes { 0 };
+
+long allocCount() { return numAllocs; }
+
+}
+
+void *
+operator new(size_t n)
+{
+  ++numAllocs;
+
+  numAllocBytes += n;
+
+  void *p = malloc(n > 0 ? n : 1);
+
+  if (! p)
+    throw std::bad_alloc();
+
+  return p;
+}
+
+void *
+operator new[](size_t n)
+{
+  return operator new(n);
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete[](void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+
+void
+operator delete[](void *p, size_t) noexcept
+{
+  free(p);
+}
+
+//---
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(const Clock::time_point &start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// peak resident set size (KB)
+long peakRSS() {
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  return usage.ru_maxrss;
+}
+
+// current resident set size (KB)
+long currentRSS() {
+  std::ifstream is("/proc/self/statm");
+
+  long size = 0, resident = 0;
+
+  if (! (is >> size >> resident))
+    return 0;
+
+  return resident*(sysconf(_SC_PAGESIZE)/1024);
+}
+
+std::string jsonString(const std::string &str) {
+  std::string str1 = "\"";
+
+  for (auto c : str) {
+    if      (c == '"' || c == '\\') { str1 += '\\'; str1 += c; }
+    else if (c == '\n')             str1 += "\\n";
+    else                            str1 += c;
+  }
+
+  return str1 + "\"";
+}
+
+std::string jsonReal(double r) {
+  char buffer[64];
+
+  snprintf(buffer, sizeof(buffer), "%.3f", r);
+
+  return buffer;
+}
+
+//---
+
+struct PhaseResult {
+  std::string name;
+  double      totalMs { 0 };
+  double      minMs   { -1 };
+  int         count   { 0 };
+  long        allocs  { 0 };
+};
+
+struct PageResult {
+  CBrowserBenchCorpus::Page page;
+  int                       iterations { 0 };
+  double                    totalMs    { 0 };
+  double                    minMs      { -1 };
+  long                      allocs     { 0 };
+  long                      allocBytes { 0 };
+  long                      rss        { 0 };
+  long                      peakRSS    { 0 };
+  std::vector<PhaseResult>  phases;
+  CBrowserTrace::Counters   counters;
+  bool                      ok         { true };
+};
+
+// load and paint page for number of iterations
+PageResult
+runPage(const CBrowserBenchCorpus::Page &page, int iterations, int width, int height)
+{
+  PageResult result;
+
+  result.page = page;
+
+  CBrowserScrolledWindow *swindow = CBrowserMainInst->iface()->currentWindow();
+
+  if (! swindow) {
+    result.ok = false;
+    return result;
+  }
+
+  CBrowserWindow *window = swindow->getWindow();
+
+  swindow->setViewportSize(width, height);
+
+  CUrl url(page.filename);
+
+  QImage image(width, height, QImage::Format_ARGB32);
+
+  for (int i = 0; i < iterations; ++i) {
+    long allocs0 = numAllocs;
+    long bytes0  = numAllocBytes;
+
+    auto start = Clock::now();
+
+    // parse, dom, style and layout (trace is reset for each document)
+    swindow->setDocument(url);
+
+    if (! window->getDocument()) {
+      result.ok = false;
+      break;
+    }
+
+    swindow->renderImage(image);
+
+    double ms = elapsedMs(start);
+
+    //---
+
+    ++result.iterations;
+
+    result.totalMs    += ms;
+    result.allocs     += numAllocs     - allocs0;
+    result.allocBytes += numAllocBytes - bytes0;
+
+    if (result.minMs < 0 || ms < result.minMs)
+      result.minMs = ms;
+
+    for (const auto &stat : CBrowserTraceInst->phaseStats()) {
+      auto p = std::find_if(result.phases.begin(), result.phases.end(),
+                            [&](const PhaseResult &r) { return r.name == stat.name; });
+
+      if (p == result.phases.end()) {
+        PhaseResult phase;
+
+        phase.name = stat.name;
+
+        p = result.phases.insert(result.phases.end(), phase);
+      }
+
+      double phaseMs = stat.time/1000.0;
+
+      (*p).totalMs += phaseMs;
+      (*p).count   += stat.count;
+      (*p).allocs  += stat.allocs;
+
+      if ((*p).minMs < 0 || phaseMs < (*p).minMs)
+        (*p).minMs = phaseMs;
+    }
+
+    // counters of last document (same for each iteration)
+    result.counters = CBrowserTraceInst->counters();
+  }
+
+  result.rss     = currentRSS();
+  result.peakRSS = peakRSS();
+
+  return result;
+}
+
+//---
+
+struct ImageDataResult {
+  std::string name;
+  double      perPixelMs { 0 };
+  double      scanlineMs { 0 };
+  int         maxDiff    { 0 };
+};
+
+// test image with gradients and runs of repeated colors
+void
+initImageData(CQSVGImageData &data, int size)
+{
+  data.setSize(size, size);
+
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      if ((x/16 + y/16) % 3 == 0)
+        data.setPixel(x, y, CRGBA(0.2, 0.4, 0.6, 1.0));
+      else
+        data.setPixel(x, y, CRGBA(double(x)/size, double(y)/size,
+                                  double((x + y) % size)/size, double(x ^ y)/(2*size) + 0.5));
+    }
+  }
+}
+
+// maximum difference in any byte component of two images
+int
+maxImageDiff(const CQSVGImageData &data1, const CQSVGImageData &data2)
+{
+  const QImage &image1 = data1.qimage();
+  const QImage &image2 = data2.qimage();
+
+  int d = 0;
+
+  for (int y = 0; y < image1.height(); ++y) {
+    for (int x = 0; x < image1.width(); ++x) {
+      QRgb p1 = image1.pixel(x, y);
+      QRgb p2 = image2.pixel(x, y);
+
+      d = std::max(d, std::abs(qRed  (p1) - qRed  (p2)));
+      d = std::max(d, std::abs(qGreen(p1) - qGreen(p2)));
+      d = std::max(d, std::abs(qBlue (p1) - qBlue (p2)));
+      d = std::max(d, std::abs(qAlpha(p1) - qAlpha(p2)));
+    }
+  }
+
+  return d;
+}
+
+// time reference per-pixel operation and image data operation on same input
+ImageDataResult
+compareImageData(const std::string &name, int size,
+                 std::function<void (CQSVGImageData &)> perPixel,
+                 std::function<void (CQSVGImageData &)> scanline)
+{
+  ImageDataResult result;
+
+  result.name = name;
+
+  CQSVGImageData data1, data2;
+
+  initImageData(data1, size);
+  initImageData(data2, size);
+
+  auto start1 = Clock::now();
+
+  perPixel(data1);
+
+  result.perPixelMs = elapsedMs(start1);
+
+  auto start2 = Clock::now();
+
+  scanline(data2);
+
+  result.scanlineMs = elapsedMs(start2);
+
+  result.maxDiff = maxImageDiff(data1, data2);
+
+  return result;
+}
+
+// reference implementations using public getPixel/setPixel (as before scanline kernels)
+void
+perPixelColorMatrix(CQSVGImageData &data, const std::vector<double> &m)
+{
+  for (int y = 0; y < data.getHeight(); ++y) {
+    for (int x = 0; x < data.getWidth(); ++x) {
+      double r, g, b, a;
+
+      data.getPixel(x, y).getRGBA(&r, &g, &b, &a);
+
+      double a1 = m[15]*r + m[16]*g + m[17]*b + m[18]*a + m[19];
+
+      if (a1 > 0) {
+        double r1 = m[ 0]*r + m[ 1]*g + m[ 2]*b + m[ 3]*a + m[ 4];
+        double g1 = m[ 5]*r + m[ 6]*g + m[ 7]*b + m[ 8]*a + m[ 9];
+        double b1 = m[10]*r + m[11]*g + m[12]*b + m[13]*a + m[14];
+
+        data.setPixel(x, y, CRGBA(r1, g1, b1, a1).clamp());
+      }
+      else
+        data.setPixel(x, y, CRGBA(0, 0, 0, 0));
+    }
+  }
+}
+
+void
+perPixelLuminanceToAlpha(CQSVGImageData &data)
+{
+  for (int y = 0; y < data.getHeight(); ++y) {
+    for (int x = 0; x < data.getWidth(); ++x) {
+      CRGBA rgba = data.getPixel(x, y);
+
+      double a = 0.2125*rgba.getRed() + 0.7154*rgba.getGreen() + 0.0721*rgba.getBlue();
+
+      double a1 = a*rgba.getAlpha();
+
+      data.setPixel(x, y, CRGBA(a1, a1, a1, a1));
+    }
+  }
+}
+
+void
+perPixelScaleAlpha(CQSVGImageData &data, double alpha)
+{
+  for (int y = 0; y < data.getHeight(); ++y) {
+    for (int x = 0; x < data.getWidth(); ++x) {
+      CRGBA rgba = data.getPixel(x, y);
+
+      rgba.setAlpha(alpha*rgba.getAlpha());
+
+      data.setPixel(x, y, rgba);
+    }
+  }
+}
+
+// kernel taps are read from (x - (xsize - 1)/2, y - (ysize - 1)/2), edge pixels are copied
+void
+perPixelConvolve(CQSVGImageData &data, const std::vector<double> &kernel, int xsize, int ysize)
+{
+  CQSVGImageData src(data);
+
+  double divisor = 0;
+
+  for (const auto &k : kernel)
+    divisor += k;
+
+  if (divisor == 0)
+    divisor = 1;
+
+  int x1 = (xsize - 1)/2, x2 = xsize - 1 - x1;
+  int y1 = (ysize - 1)/2, y2 = ysize - 1 - y1;
+
+  for (int y = y1; y < data.getHeight() - y2; ++y) {
+    for (int x = x1; x < data.getWidth() - x2; ++x) {
+      double sum[4] = { 0, 0, 0, 0 };
+
+      for (int yk = 0; yk < ysize; ++yk) {
+        for (int xk = 0; xk < xsize; ++xk) {
+          double r, g, b, a;
+
+          src.getPixel(x - x1 + xk, y - y1 + yk).getRGBA(&r, &g, &b, &a);
+
+          double k = kernel[yk*xsize + xk];
+
+          sum[0] += k*r; sum[1] += k*g; sum[2] += k*b; sum[3] += k*a;
+        }
+      }
+
+      data.setPixel(x, y, CRGBA(sum[0]/divisor, sum[1]/divisor,
+                                sum[2]/divisor, sum[3]/divisor).clamp());
+    }
+  }
+}
+
+void
+convolveImageData(CQSVGImageData &data, const std::vector<double> &kernel,
+                  int xsize, int ysize)
+{
+  CImageConvolveData cdata;
+
+  cdata.kernel        = kernel;
+  cdata.xsize         = xsize;
+  cdata.ysize         = ysize;
+  cdata.divisor       = -1;
+  cdata.preserveAlpha = false;
+
+  CQSVGImageData *dst = data.newImage(data.getWidth(), data.getHeight());
+
+  data.convolve(dst, cdata);
+
+  data.setQImage(dst->qimage());
+
+  delete dst;
+}
+
+std::vector<ImageDataResult>
+runImageData(int size)
+{
+  std::vector<ImageDataResult> results;
+
+  // sepia tone
+  std::vector<double> m = {
+    0.393, 0.769, 0.189, 0, 0,
+    0.349, 0.686, 0.168, 0, 0,
+    0.272, 0.534, 0.131, 0, 0,
+    0    , 0    , 0    , 1, 0 };
+
+  results.push_back(compareImageData("colorMatrix", size,
+    [&](CQSVGImageData &data) { perPixelColorMatrix(data, m); },
+    [&](CQSVGImageData &data) { data.applyColorMatrix(m); }));
+
+  results.push_back(compareImageData("luminanceToAlpha", size,
+    [&](CQSVGImageData &data) { perPixelLuminanceToAlpha(data); },
+    [&](CQSVGImageData &data) { data.luminanceToAlpha(); }));
+
+  results.push_back(compareImageData("scaleAlpha", size,
+    [&](CQSVGImageData &data) { perPixelScaleAlpha(data, 0.5); },
+    [&](CQSVGImageData &data) { data.scaleAlpha(0.5); }));
+
+  // even order kernels (more taps right of/below target than left of/above it)
+  std::vector<double> k4 = {
+    1, 3, 3, 1,
+    3, 9, 9, 3,
+    3, 9, 9, 3,
+    1, 3, 3, 1 };
+
+  results.push_back(compareImageData("convolveSeparable4", size,
+    [&](CQSVGImageData &data) { perPixelConvolve(data, k4, 4, 4); },
+    [&](CQSVGImageData &data) { convolveImageData(data, k4, 4, 4); }));
+
+  std::vector<double> k2 = {
+    1, 2,
+    3, 1 };
+
+  results.push_back(compareImageData("convolveGeneral2", size,
+    [&](CQSVGImageData &data) { perPixelConvolve(data, k2, 2, 2); },
+    [&](CQSVGImageData &data) { convolveImageData(data, k2, 2, 2); }));
+
+  return results;
+}
+
+//---
+
+void
+writeResults(std::ostream &os, const CBrowserBenchCorpus &corpus, int width, int height,
+             const std::vector<PageResult> &pages, int imageSize,
+             const std::vector<ImageDataResult> &imageData)
+{
+  os << "{\n";
+
+  os << "\"settings\":{\"width\":" << width << ",\"height\":" << height <<
+        ",\"depth\":" << corpus.depth() << ",\"rows\":" << corpus.rows() <<
+        ",\"cols\":" << corpus.cols() << ",\"paragraphs\":" << corpus.paragraphs() <<
+        ",\"rules\":" << corpus.rules() << ",\"images\":" << corpus.images() <<
+        ",\"shapes\":" << corpus.shapes() << ",\"controls\":" << corpus.controls() <<
+        ",\"image_size\":" << imageSize << "},\n";
+
+  os << "\"pages\":[\n";
+
+  bool first = true;
+
+  for (const auto &page : pages) {
+    if (! first) os << ",\n";
+
+    int n = std::max(page.iterations, 1);
+
+    os << "{\"name\":" << jsonString(page.page.name) <<
+          ",\"file\":" << jsonString(page.page.filename) <<
+          ",\"bytes\":" << page.page.bytes <<
+          ",\"ok\":" << (page.ok ? "true" : "false") <<
+          ",\"iterations\":" << page.iterations <<
+          ",\"mean_ms\":" << jsonReal(page.totalMs/n) <<
+          ",\"min_ms\":" << jsonReal(std::max(page.minMs, 0.0)) <<
+          ",\"allocs\":" << page.allocs/n <<
+          ",\"alloc_bytes\":" << page.allocBytes/n <<
+          ",\"rss_kb\":" << page.rss <<
+          ",\"peak_rss_kb\":" << page.peakRSS;
+
+    os << ",\"phases\":{";
+
+    bool first1 = true;
+
+    for (const auto &phase : page.phases) {
+      if (! first1) os << ",";
+
+      os << jsonString(phase.name) << ":{\"mean_ms\":" << jsonReal(phase.totalMs/n) <<
+            ",\"min_ms\":" << jsonReal(std::max(phase.minMs, 0.0)) <<
+            ",\"count\":" << phase.count/n << ",\"allocs\":" << phase.allocs/n << "}";
+
+      first1 = false;
+    }
+
+    os << "},\"counters\":{";
+
+    first1 = true;
+
+    for (const auto &counter : page.counters) {
+      if (! first1) os << ",";
+
+      os << jsonString(counter.first) << ":" << counter.second;
+
+      first1 = false;
+    }
+
+    os << "}}";
+
+    first = false;
+  }
+
+  os << "\n],\n";
+
+  os << "\"image_data\":[\n";
+
+  first = true;
+
+  for (const auto &result : imageData) {
+    if (! first) os << ",\n";
+
+    double speedup = (result.scanlineMs > 0 ? result.perPixelMs/result.scanlineMs : 0.0);
+
+    os << "{\"name\":" << jsonString(result.name) <<
+          ",\"per_pixel_ms\":" << jsonReal(result.perPixelMs) <<
+          ",\"scanline_ms\":" << jsonReal(result.scanlineMs) <<
+          ",\"speedup\":" << jsonReal(speedup) <<
+          ",\"max_diff\":" << result.maxDiff << "}";
+
+    first = false;
+  }
+
+  os << "\n]\n}\n";
+}
+
+}
+
+//---
+
+int
+main(int argc, char **argv)
+{
+  // render without a display
+  setenv("QT_QPA_PLATFORM", "offscreen", 0);
+
+  CQApp app(argc, argv);
+
+  CArgs cargs("-corpus:s -page:s -generate:f -iterations:i -output:s -width:i -height:i "
+              "-depth:i -rows:i -cols:i -paragraphs:i -rules:i -images:i -shapes:i "
+              "-controls:i -image_size:i -no_image_data:f");
+
+  cargs.parse(&argc, argv);
+
+  std::string corpusDir  = cargs.getStringArg ("-corpus");
+  std::string pageName   = cargs.getStringArg ("-page");
+  bool        generate   = cargs.getBooleanArg("-generate");
+  int         iterations = cargs.getIntegerArg("-iterations");
+  std::string output     = cargs.getStringArg ("-output");
+  int         width      = cargs.getIntegerArg("-width");
+  int         height     = cargs.getIntegerArg("-height");
+
+  if (corpusDir == "") corpusDir  = "/tmp/CBrowserBench";
+  if (iterations < 1 ) iterations = 3;
+  if (width      < 1 ) width      = 800;
+  if (height     < 1 ) height     = 600;
+
+  //---
+
+  CBrowserBenchCorpus corpus;
+
+  auto setSize = [&](const char *name, void (CBrowserBenchCorpus::*proc)(int)) {
+    int i = cargs.getIntegerArg(name);
+
+    if (i > 0)
+      (corpus.*proc)(i);
+  };
+
+  setSize("-depth"     , &CBrowserBenchCorpus::setDepth);
+  setSize("-rows"      , &CBrowserBenchCorpus::setRows);
+  setSize("-cols"      , &CBrowserBenchCorpus::setCols);
+  setSize("-paragraphs", &CBrowserBenchCorpus::setParagraphs);
+  setSize("-rules"     , &CBrowserBenchCorpus::setRules);
+  setSize("-images"    , &CBrowserBenchCorpus::setImages);
+  setSize("-shapes"    , &CBrowserBenchCorpus::setShapes);
+  setSize("-controls"  , &CBrowserBenchCorpus::setControls);
+
+  CBrowserBenchCorpus::Pages pages;
+
+  if (! corpus.generate(corpusDir, pages, pageName))
+    return 1;
+
+  if (generate) {
+    for (const auto &page : pages)
+      std::cout << page.filename << " " << page.bytes << std::endl;
+
+    return 0;
+  }
+
+  //---
+
+  // image data comparison size
+  int imageSize = cargs.getIntegerArg("-image_size");
+
+  if (imageSize < 1)
+    imageSize = 512;
+
+  if (cargs.getBooleanArg("-no_image_data"))
+    imageSize = 0;
+
+  //---
+
+  CBrowserMain *browser = CBrowserMainInst;
+
+  browser->setBatch(true);
+  browser->setDocCacheSize(0);
+
+  CBrowserTraceInst->setAllocCountProc(allocCount);
+  CBrowserTraceInst->setEnabled(true);
+
+  std::vector<PageResult> results;
+
+  int rc = 0;
+
+  for (const auto &page : pages) {
+    results.push_back(runPage(page, iterations, width, height));
+
+    if (! results.back().ok) {
+      std::cerr << "Failed to load '" << page.filename << "'" << std::endl;
+      rc = 1;
+    }
+  }
+
+  std::vector<ImageDataResult> imageData;
+
+  if (imageSize > 0 && pageName == "")
+    imageData = runImageData(imageSize);
+
+  //---
+
+  if (output != "") {
+    std::ofstream os(output.c_str());
+
+    if (! os) {
+      std::cerr << "Failed to write '" << output << "'" << std::endl;
+      return 1;
+    }
+
+    writeResults(os, corpus, width, height, results, imageSize, imageData);
+  }
+  else
+    writeResults(std::cout, corpus, width, height, results, imageSize, imageData);
+
+  return rc;
+}
@@ -0,0 +1,455 @@
+#include <CBrowserBenchCorpus.h>
+#include <QColor>
+#include <QDir>
+#include <QImage>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// number of distinct image files (pages reference them repeatedly)
+const int numImageFiles = 32;
+
+const char *words[] = {
+  "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+  "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore", "et", "dolore",
+  "magna", "aliqua", "enim", "ad", "minim", "veniam", "quis", "nostrud",
+  "exercitation", "ullamco", "laboris", "nisi", "aliquip", "ex", "ea", "commodo",
+  "consequat", "duis", "aute", "irure", "in", "reprehenderit", "voluptate", "velit",
+  "esse", "cillum", "fugiat", "nulla", "pariatur", "excepteur", "sint", "occaecat"
+};
+
+const int numWords = sizeof(words)/sizeof(words[0]);
+
+const char *colors[] = {
+  "red", "green", "blue", "orange", "purple", "teal", "navy", "maroon", "olive", "gray"
+};
+
+const int numColors = sizeof(colors)/sizeof(colors[0]);
+
+std::string pageStart(const std::string &title, const std::string &head="") {
+  return "<html>\n<head>\n<title>" + title + "</title>\n" + head + "</head>\n<body>\n";
+}
+
+std::string pageEnd() {
+  return "</body>\n</html>\n";
+}
+
+}
+
+//---
+
+CBrowserBenchCorpus::
+CBrowserBenchCorpus()
+{
+}
+
+std::vector<std::string>
+CBrowserBenchCorpus::
+pageNames()
+{
+  return std::vector<std::string>({
+    "nesting", "table", "text", "css", "images", "svg", "forms" });
+}
+
+bool
+CBrowserBenchCorpus::
+generate(const std::string &dir, Pages &pages, const std::string &name)
+{
+  if (! QDir().mkpath(dir.c_str())) {
+    std::cerr << "Failed to create '" << dir << "'" << std::endl;
+    return false;
+  }
+
+  if ((name == "" || name == "images") && ! writeImages(dir))
+    return false;
+
+  for (const auto &pageName : pageNames()) {
+    if (name != "" && pageName != name)
+      continue;
+
+    // same content for page whatever other pages are generated
+    seed_ = 1;
+
+    std::string text = pageText(pageName);
+
+    Page page;
+
+    page.name     = pageName;
+    page.filename = dir + "/" + pageName + ".html";
+    page.bytes    = text.size();
+
+    std::ofstream os(page.filename.c_str());
+
+    if (! os || ! os.write(text.c_str(), text.size())) {
+      std::cerr << "Failed to write '" << page.filename << "'" << std::endl;
+      return false;
+    }
+
+    pages.push_back(page);
+  }
+
+  if (pages.empty()) {
+    std::cerr << "Invalid page '" << name << "'" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+std::string
+CBrowserBenchCorpus::
+pageText(const std::string &name)
+{
+  if      (name == "nesting") return nestingPage();
+  else if (name == "table"  ) return tablePage();
+  else if (name == "text"   ) return textPage();
+  else if (name == "css"    ) return cssPage();
+  else if (name == "images" ) return imagesPage();
+  else if (name == "svg"    ) return svgPage();
+  else if (name == "forms"  ) return formsPage();
+
+  return "";
+}
+
+// deeply nested blocks (stresses tree depth in style and layout)
+std::string
+CBrowserBenchCorpus::
+nestingPage()
+{
+  std::string str = pageStart("nesting");
+
+  const char *tags[] = { "div", "blockquote", "ul", "li", "span", "b", "i" };
+
+  const int numTags = sizeof(tags)/sizeof(tags[0]);
+
+  std::vector<const char *> stack;
+
+  for (int i = 0; i < depth_; ++i) {
+    const char *tag = tags[i % numTags];
+
+    str += "<" + std::string(tag) + " class=\"level" + std::to_string(i % 10) + "\">" +
+           sentence(4) + "\n";
+
+    stack.push_back(tag);
+  }
+
+  for (auto p = stack.rbegin(); p != stack.rend(); ++p)
+    str += "</" + std::string(*p) + ">\n";
+
+  str += pageEnd();
+
+  return str;
+}
+
+// wide table (stresses table column width calculation)
+std::string
+CBrowserBenchCorpus::
+tablePage()
+{
+  std::string str = pageStart("table");
+
+  str += "<table border=\"1\" cellpadding=\"2\">\n";
+
+  str += "<tr>";
+
+  for (int c = 0; c < cols_; ++c)
+    str += "<th>col" + std::to_string(c) + "</th>";
+
+  str += "</tr>\n";
+
+  for (int r = 0; r < rows_; ++r) {
+    str += "<tr>";
+
+    for (int c = 0; c < cols_; ++c) {
+      if ((r + c) % 7 == 0)
+        str += "<td bgcolor=\"" + std::string(colors[random(numColors)]) + "\">" +
+               sentence(1 + random(3)) + "</td>";
+      else
+        str += "<td>" + std::to_string(r*cols_ + c) + "</td>";
+    }
+
+    str += "</tr>\n";
+  }
+
+  str += "</table>\n";
+
+  str += pageEnd();
+
+  return str;
+}
+
+// long flowing text (stresses text parsing, line breaking and text painting)
+std::string
+CBrowserBenchCorpus::
+textPage()
+{
+  std::string str = pageStart("text");
+
+  for (int i = 0; i < paragraphs_; ++i) {
+    if (i % 50 == 0)
+      str += "<h2>" + sentence(3) + "</h2>\n";
+
+    str += "<p>";
+
+    int ns = 3 + random(5);
+
+    for (int j = 0; j < ns; ++j) {
+      int style = random(10);
+
+      if      (style == 0) str += "<b>" + sentence(8) + "</b> ";
+      else if (style == 1) str += "<i>" + sentence(8) + "</i> ";
+      else if (style == 2) str += "<a href=\"#p" + std::to_string(i) + "\">" +
+                                  sentence(3) + "</a> ";
+      else                 str += sentence(8 + random(8)) + " ";
+    }
+
+    str += "</p>\n";
+  }
+
+  str += pageEnd();
+
+  return str;
+}
+
+// many CSS rules with class, id and descendant selectors (stresses style matching)
+std::string
+CBrowserBenchCorpus::
+cssPage()
+{
+  int nclasses = std::max(rules_/4, 1);
+
+  std::string css = "<style>\n";
+
+  for (int i = 0; i < rules_; ++i) {
+    int n = i % nclasses;
+
+    std::string color = colors[random(numColors)];
+
+    switch (i % 4) {
+      case 0:
+        css += ".c" + std::to_string(n) + " { color: " + color + "; }\n"; break;
+      case 1:
+        css += "#id" + std::to_string(n) + " { margin-left: " +
+               std::to_string(random(20)) + "px; }\n"; break;
+      case 2:
+        css += "div.c" + std::to_string(n) + " p { font-weight: bold; }\n"; break;
+      default:
+        css += "div > span.c" + std::to_string(n) + " { background: " + color + "; }\n"; break;
+    }
+  }
+
+  css += "</style>\n";
+
+  std::string str = pageStart("css", css);
+
+  int nelements = std::max(rules_/2, 1);
+
+  for (int i = 0; i < nelements; ++i) {
+    int n = random(nclasses);
+
+    str += "<div class=\"c" + std::to_string(n) + "\" id=\"id" + std::to_string(i) + "\">" +
+           "<span class=\"c" + std::to_string(random(nclasses)) + "\">" + sentence(3) +
+           "</span><p>" + sentence(6) + "</p></div>\n";
+  }
+
+  str += pageEnd();
+
+  return str;
+}
+
+// many images (stresses image loading, scaling and painting)
+std::string
+CBrowserBenchCorpus::
+imagesPage()
+{
+  std::string str = pageStart("images");
+
+  for (int i = 0; i < images_; ++i) {
+    int w = 16 + random(8)*16;
+    int h = 16 + random(8)*12;
+
+    str += "<img src=\"img/img" + std::to_string(i % numImageFiles) + ".png\" width=\"" +
+           std::to_string(w) + "\" height=\"" + std::to_string(h) + "\" alt=\"image" +
+           std::to_string(i) + "\">\n";
+
+    if (i % 10 == 9)
+      str += "<br>\n";
+  }
+
+  str += pageEnd();
+
+  return str;
+}
+
+// inline SVG drawings (stresses SVG rendering)
+std::string
+CBrowserBenchCorpus::
+svgPage()
+{
+  std::string str = pageStart("svg");
+
+  int perSvg = 100;
+
+  for (int i = 0; i < shapes_; i += perSvg) {
+    str += "<svg width=\"400\" height=\"300\" xmlns=\"http://www.w3.org/2000/svg\">\n";
+
+    int n = std::min(perSvg, shapes_ - i);
+
+    for (int j = 0; j < n; ++j) {
+      std::string fill   = colors[random(numColors)];
+      std::string stroke = colors[random(numColors)];
+
+      std::string style = " fill=\"" + fill + "\" stroke=\"" + stroke + "\" stroke-width=\"" +
+                          std::to_string(1 + random(3)) + "\"";
+
+      int x = random(380), y = random(280);
+
+      switch (j % 5) {
+        case 0:
+          str += "<rect x=\"" + std::to_string(x) + "\" y=\"" + std::to_string(y) +
+                 "\" width=\"" + std::to_string(5 + random(40)) + "\" height=\"" +
+                 std::to_string(5 + random(40)) + "\"" + style + "/>\n"; break;
+        case 1:
+          str += "<circle cx=\"" + std::to_string(x) + "\" cy=\"" + std::to_string(y) +
+                 "\" r=\"" + std::to_string(3 + random(20)) + "\"" + style + "/>\n"; break;
+        case 2:
+          str += "<ellipse cx=\"" + std::to_string(x) + "\" cy=\"" + std::to_string(y) +
+                 "\" rx=\"" + std::to_string(3 + random(30)) + "\" ry=\"" +
+                 std::to_string(3 + random(20)) + "\"" + style + "/>\n"; break;
+        case 3:
+          str += "<path d=\"M " + std::to_string(x) + " " + std::to_string(y) +
+                 " q " + std::to_string(random(40)) + " " + std::to_string(random(40) - 20) +
+                 " " + std::to_string(random(60)) + " 0 l " + std::to_string(random(30)) +
+                 " " + std::to_string(random(30)) + " z\"" + style + "/>\n"; break;
+        default:
+          str += "<text x=\"" + std::to_string(x) + "\" y=\"" + std::to_string(y) +
+                 "\" fill=\"" + fill + "\">" + word() + "</text>\n"; break;
+      }
+    }
+
+    str += "</svg>\n";
+  }
+
+  str += pageEnd();
+
+  return str;
+}
+
+// form controls (stresses control creation and painting)
+std::string
+CBrowserBenchCorpus::
+formsPage()
+{
+  std::string str = pageStart("forms");
+
+  str += "<form action=\"submit\" method=\"get\">\n";
+
+  for (int i = 0; i < controls_; ++i) {
+    std::string name = "f" + std::to_string(i);
+
+    switch (i % 6) {
+      case 0:
+        str += word() + " <input type=\"text\" name=\"" + name + "\" value=\"" + word() +
+               "\">\n"; break;
+      case 1:
+        str += "<input type=\"checkbox\" name=\"" + name + "\"" +
+               (random(2) ? " checked" : "") + "> " + word() + "\n"; break;
+      case 2:
+        str += "<input type=\"radio\" name=\"r" + std::to_string(i/30) + "\" value=\"" +
+               name + "\"> " + word() + "\n"; break;
+      case 3:
+        str += "<input type=\"button\" name=\"" + name + "\" value=\"" + word() + "\">\n";
+        break;
+      case 4: {
+        str += "<select name=\"" + name + "\">";
+
+        for (int j = 0; j < 5; ++j)
+          str += "<option>" + word() + "</option>";
+
+        str += "</select>\n";
+
+        break;
+      }
+      default:
+        str += "<textarea name=\"" + name + "\" rows=\"2\" cols=\"20\">" + sentence(5) +
+               "</textarea><br>\n"; break;
+    }
+  }
+
+  str += "<input type=\"submit\" value=\"Submit\">\n";
+  str += "</form>\n";
+
+  str += pageEnd();
+
+  return str;
+}
+
+bool
+CBrowserBenchCorpus::
+writeImages(const std::string &dir)
+{
+  std::string imageDir = dir + "/img";
+
+  if (! QDir().mkpath(imageDir.c_str())) {
+    std::cerr << "Failed to create '" << imageDir << "'" << std::endl;
+    return false;
+  }
+
+  for (int i = 0; i < numImageFiles; ++i) {
+    std::string filename = imageDir + "/img" + std::to_string(i) + ".png";
+
+    QImage image(64, 48, QImage::Format_ARGB32);
+
+    int hue = (i*360)/numImageFiles;
+
+    for (int y = 0; y < image.height(); ++y) {
+      for (int x = 0; x < image.width(); ++x) {
+        QColor c = QColor::fromHsv(hue, 64 + (191*x)/image.width(),
+                                   64 + (191*y)/image.height());
+
+        image.setPixel(x, y, c.rgba());
+      }
+    }
+
+    if (! image.save(filename.c_str(), "PNG")) {
+      std::cerr << "Failed to write '" << filename << "'" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::string
+CBrowserBenchCorpus::
+sentence(int nwords)
+{
+  std::string str;
+
+  for (int i = 0; i < nwords; ++i) {
+    if (i > 0) str += " ";
+
+    str += word();
+  }
+
+  return str;
+}
+
+std::string
+CBrowserBenchCorpus::
+word()
+{
+  return words[random(numWords)];
+}
+
+// deterministic pseudo random number in range [0, n)
+int
+CBrowserBenchCorpus::
+random(int n)
+{
+  seed_ = seed_*1103515245 + 12345;
+
+  return int((seed_ >> 16) & 0x7fff) % n;
+}
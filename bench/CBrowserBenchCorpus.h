@@ -0,0 +1,84 @@
+#ifndef CBrowserBenchCorpus_H
+#define CBrowserBenchCorpus_H
+
+#include <string>
+#include <vector>
+
+// generate benchmark HTML pages which each stress one part of the browser pipeline
+//
+// Pages are deterministic for a given set of sizes so runs on different commits can
+// be compared.
+class CBrowserBenchCorpus {
+ public:
+  struct Page {
+    std::string name;
+    std::string filename;
+    size_t      bytes { 0 };
+  };
+
+  typedef std::vector<Page> Pages;
+
+ public:
+  CBrowserBenchCorpus();
+
+  int depth() const { return depth_; }
+  void setDepth(int i) { depth_ = i; }
+
+  int rows() const { return rows_; }
+  void setRows(int i) { rows_ = i; }
+
+  int cols() const { return cols_; }
+  void setCols(int i) { cols_ = i; }
+
+  int paragraphs() const { return paragraphs_; }
+  void setParagraphs(int i) { paragraphs_ = i; }
+
+  int rules() const { return rules_; }
+  void setRules(int i) { rules_ = i; }
+
+  int images() const { return images_; }
+  void setImages(int i) { images_ = i; }
+
+  int shapes() const { return shapes_; }
+  void setShapes(int i) { shapes_ = i; }
+
+  int controls() const { return controls_; }
+  void setControls(int i) { controls_ = i; }
+
+  // page names (in generation order)
+  static std::vector<std::string> pageNames();
+
+  // write pages (and images) to directory, only named page if name not empty
+  bool generate(const std::string &dir, Pages &pages, const std::string &name="");
+
+ private:
+  std::string pageText(const std::string &name);
+
+  std::string nestingPage();
+  std::string tablePage();
+  std::string textPage();
+  std::string cssPage();
+  std::string imagesPage();
+  std::string svgPage();
+  std::string formsPage();
+
+  bool writeImages(const std::string &dir);
+
+  std::string sentence(int nwords);
+  std::string word();
+
+  int random(int n);
+
+ private:
+  int          depth_      { 200 };
+  int          rows_       { 500 };
+  int          cols_       { 20 };
+  int          paragraphs_ { 2000 };
+  int          rules_      { 2000 };
+  int          images_     { 500 };
+  int          shapes_     { 2000 };
+  int          controls_   { 500 };
+  unsigned int seed_       { 1 };
+};
+
+#endif
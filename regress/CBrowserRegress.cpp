@@ -0,0 +1,525 @@
+// Layout and paint regression test.
+//
+//   CBrowserRegress [-golden <dir>] [-output <dir>] [-update] [-jobs <n>] <files>
+//
+// Each file is loaded headlessly (offscreen) at a fixed viewport size and its box tree
+// (type, id, position and sizes of every layout object) and rendered image are written
+// to the output directory and compared against <name>.boxes and <name>.png in the golden
+// directory. Box values may differ by -box_tolerance pixels, image pixels by
+// -pixel_tolerance per channel and up to -max_diff_pixels pixels may differ. A diff
+// image (<name>.diff.png) is written for image failures. -update writes the results as
+// the new golden files.
+//
+// With -compare <mode> (old_layout or incremental) goldens are not used and each page
+// is instead compared against itself rendered with the default (reference) settings.
+//
+// Qt widgets can only be used from the main thread so files are run in parallel as
+// worker processes (-jobs, default number of cores).
+
+#include <CBrowserMain.h>
+#include <CBrowserMainWindow.h>
+#include <CBrowserScrolledWindow.h>
+#include <CBrowserWindow.h>
+#include <CBrowserObject.h>
+#include <CQApp.h>
+#include <CArgs.h>
+#include <QCoreApplication>
+#include <QDir>
+#include <QImage>
+#include <QProcess>
+#include <QThread>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct Options {
+  std::string goldenDir      { "golden" };
+  std::string outputDir      { "regress.out" };
+  std::string compare;
+  bool        update         { false };
+  int         width          { 800 };
+  int         height         { 600 };
+  int         boxTolerance   { 0 };
+  int         pixelTolerance { 0 };
+  int         maxDiffPixels  { 0 };
+};
+
+// page name from filename (no directory or extension)
+std::string pageName(const std::string &filename) {
+  std::string name = filename;
+
+  auto p1 = name.rfind('/');
+
+  if (p1 != std::string::npos)
+    name = name.substr(p1 + 1);
+
+  auto p2 = name.rfind('.');
+
+  if (p2 != std::string::npos && p2 > 0)
+    name = name.substr(0, p2);
+
+  return name;
+}
+
+bool readFile(const std::string &filename, std::string &str) {
+  std::ifstream is(filename.c_str());
+
+  if (! is)
+    return false;
+
+  std::stringstream ss;
+
+  ss << is.rdbuf();
+
+  str = ss.str();
+
+  return true;
+}
+
+bool writeFile(const std::string &filename, const std::string &str) {
+  std::ofstream os(filename.c_str());
+
+  if (! os || ! os.write(str.c_str(), str.size())) {
+    std::cerr << "Failed to write '" << filename << "'" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//---
+
+// box tree of object and its children (one line per object, children indented)
+void
+dumpBoxes(std::ostream &os, const CBrowserObject *obj, int depth)
+{
+  os << std::string(2*depth, ' ') << obj->typeName();
+
+  if (obj->id() != "")
+    os << " #" << obj->id();
+
+  os << " " << obj->x() << " " << obj->y() << " " << obj->width() << " " << obj->height() <<
+        " " << obj->contentWidth() << " " << obj->contentHeight() << "\n";
+
+  for (const auto &child : obj->children())
+    dumpBoxes(os, child, depth + 1);
+}
+
+std::vector<std::string> splitLines(const std::string &str) {
+  std::vector<std::string> lines;
+
+  std::stringstream ss(str);
+
+  std::string line;
+
+  while (std::getline(ss, line))
+    lines.push_back(line);
+
+  return lines;
+}
+
+std::vector<std::string> splitWords(const std::string &str) {
+  std::vector<std::string> words;
+
+  std::stringstream ss(str);
+
+  std::string word;
+
+  while (ss >> word)
+    words.push_back(word);
+
+  return words;
+}
+
+bool isNumber(const std::string &str, long &l) {
+  char *p;
+
+  l = strtol(str.c_str(), &p, 10);
+
+  return (p != str.c_str() && *p == '\0');
+}
+
+// compare box trees (structure must match, positions and sizes within tolerance)
+bool
+compareBoxes(const std::string &boxes1, const std::string &boxes2, int tolerance,
+             std::string &msg)
+{
+  std::vector<std::string> lines1 = splitLines(boxes1);
+  std::vector<std::string> lines2 = splitLines(boxes2);
+
+  size_t n = std::min(lines1.size(), lines2.size());
+
+  for (size_t i = 0; i < n; ++i) {
+    std::vector<std::string> words1 = splitWords(lines1[i]);
+    std::vector<std::string> words2 = splitWords(lines2[i]);
+
+    bool match = (words1.size() == words2.size() &&
+                  lines1[i].find_first_not_of(' ') == lines2[i].find_first_not_of(' '));
+
+    for (size_t j = 0; match && j < words1.size(); ++j) {
+      long l1, l2;
+
+      if (isNumber(words1[j], l1) && isNumber(words2[j], l2))
+        match = (std::abs(l1 - l2) <= tolerance);
+      else
+        match = (words1[j] == words2[j]);
+    }
+
+    if (! match) {
+      msg = "box " + std::to_string(i + 1) + " '" + lines2[i] + "' expected '" +
+            lines1[i] + "'";
+      return false;
+    }
+  }
+
+  if (lines1.size() != lines2.size()) {
+    msg = std::to_string(lines2.size()) + " boxes, expected " + std::to_string(lines1.size());
+    return false;
+  }
+
+  return true;
+}
+
+// compare images (pixels differ if any channel differs by more than tolerance)
+bool
+compareImages(const QImage &image1, const QImage &image2, const Options &options,
+              QImage &diffImage, std::string &msg)
+{
+  if (image1.size() != image2.size()) {
+    msg = "image size " + std::to_string(image2.width()) + "x" +
+          std::to_string(image2.height()) + ", expected " +
+          std::to_string(image1.width()) + "x" + std::to_string(image1.height());
+    return false;
+  }
+
+  QImage i1 = image1.convertToFormat(QImage::Format_ARGB32);
+  QImage i2 = image2.convertToFormat(QImage::Format_ARGB32);
+
+  diffImage = QImage(i1.size(), QImage::Format_ARGB32);
+
+  int ndiff = 0;
+
+  for (int y = 0; y < i1.height(); ++y) {
+    const QRgb *line1 = reinterpret_cast<const QRgb *>(i1.constScanLine(y));
+    const QRgb *line2 = reinterpret_cast<const QRgb *>(i2.constScanLine(y));
+
+    QRgb *dline = reinterpret_cast<QRgb *>(diffImage.scanLine(y));
+
+    for (int x = 0; x < i1.width(); ++x) {
+      QRgb p1 = line1[x], p2 = line2[x];
+
+      int d = std::max(std::max(std::abs(qRed  (p1) - qRed  (p2)),
+                                std::abs(qGreen(p1) - qGreen(p2))),
+                       std::max(std::abs(qBlue (p1) - qBlue (p2)),
+                                std::abs(qAlpha(p1) - qAlpha(p2))));
+
+      if (d > options.pixelTolerance) {
+        ++ndiff;
+
+        dline[x] = qRgb(255, 0, 0);
+      }
+      else {
+        // faded expected image
+        int g = 192 + qGray(p1)/4;
+
+        dline[x] = qRgb(g, g, g);
+      }
+    }
+  }
+
+  if (ndiff > options.maxDiffPixels) {
+    msg = std::to_string(ndiff) + " pixels differ";
+    return false;
+  }
+
+  return true;
+}
+
+//---
+
+// load and render file, returns box tree and image
+bool
+renderPage(const std::string &filename, const Options &options, std::string &boxes,
+           QImage &image)
+{
+  CBrowserScrolledWindow *swindow = CBrowserMainInst->iface()->currentWindow();
+
+  if (! swindow)
+    return false;
+
+  CBrowserWindow *window = swindow->getWindow();
+
+  swindow->setViewportSize(options.width, options.height);
+
+  swindow->setDocument(CUrl(filename));
+
+  if (! window->getDocument() || ! window->rootObject())
+    return false;
+
+  std::stringstream ss;
+
+  dumpBoxes(ss, window->rootObject(), 0);
+
+  boxes = ss.str();
+
+  image = QImage(options.width, options.height, QImage::Format_ARGB32);
+
+  image.fill(Qt::white);
+
+  swindow->renderImage(image);
+
+  return true;
+}
+
+// enable (or disable) compared mode
+void
+setCompareMode(const std::string &mode, bool enabled)
+{
+  CBrowserMain *browser = CBrowserMainInst;
+
+  if      (mode == "old_layout")
+    browser->setOldLayout(enabled);
+  else if (mode == "incremental") {
+    // incremental output is not used in batch mode
+    browser->setIncremental(enabled);
+    browser->setBatch(! enabled);
+  }
+}
+
+// test single file, returns 0 on pass, 1 on failure
+int
+testPage(const std::string &filename, const Options &options)
+{
+  std::string name = pageName(filename);
+
+  auto fail = [&](const std::string &msg) {
+    std::cout << "FAIL " << name << ": " << msg << std::endl;
+    return 1;
+  };
+
+  //---
+
+  std::string expectedBoxes;
+  QImage      expectedImage;
+
+  if (options.compare != "") {
+    setCompareMode(options.compare, false);
+
+    if (! renderPage(filename, options, expectedBoxes, expectedImage))
+      return fail("failed to load (reference)");
+
+    setCompareMode(options.compare, true);
+  }
+
+  std::string boxes;
+  QImage      image;
+
+  if (! renderPage(filename, options, boxes, image))
+    return fail("failed to load");
+
+  //---
+
+  std::string outputBase = options.outputDir + "/" + name;
+
+  if (! writeFile(outputBase + ".boxes", boxes) ||
+      ! image.save((outputBase + ".png").c_str(), "PNG"))
+    return fail("failed to write output");
+
+  if (options.update) {
+    std::string goldenBase = options.goldenDir + "/" + name;
+
+    if (! writeFile(goldenBase + ".boxes", boxes) ||
+        ! image.save((goldenBase + ".png").c_str(), "PNG"))
+      return fail("failed to write golden");
+
+    std::cout << "UPDATE " << name << std::endl;
+
+    return 0;
+  }
+
+  if (options.compare == "") {
+    std::string goldenBase = options.goldenDir + "/" + name;
+
+    if (! readFile(goldenBase + ".boxes", expectedBoxes) ||
+        ! expectedImage.load((goldenBase + ".png").c_str()))
+      return fail("no golden files in '" + options.goldenDir + "'");
+  }
+
+  //---
+
+  std::string msg;
+
+  if (! compareBoxes(expectedBoxes, boxes, options.boxTolerance, msg))
+    return fail(msg);
+
+  QImage diffImage;
+
+  if (! compareImages(expectedImage, image, options, diffImage, msg)) {
+    diffImage.save((outputBase + ".diff.png").c_str(), "PNG");
+
+    return fail(msg);
+  }
+
+  std::cout << "PASS " << name << std::endl;
+
+  return 0;
+}
+
+//---
+
+// run files as worker processes (at most jobs at once), returns number of failures
+int
+runWorkers(const std::vector<std::string> &files, const QStringList &args, int jobs)
+{
+  QString program = QCoreApplication::applicationFilePath();
+
+  std::list<QProcess *> running;
+
+  size_t next = 0;
+
+  int nfail = 0;
+
+  while (next < files.size() || ! running.empty()) {
+    while (next < files.size() && int(running.size()) < jobs) {
+      QProcess *process = new QProcess;
+
+      process->setProcessChannelMode(QProcess::ForwardedChannels);
+
+      process->start(program, QStringList(args) << "-worker" << files[next].c_str());
+
+      running.push_back(process);
+
+      ++next;
+    }
+
+    for (auto p = running.begin(); p != running.end(); ) {
+      QProcess *process = *p;
+
+      if (process->state() != QProcess::NotRunning && ! process->waitForFinished(10)) {
+        ++p;
+        continue;
+      }
+
+      if (process->exitStatus() != QProcess::NormalExit || process->exitCode() != 0)
+        ++nfail;
+
+      delete process;
+
+      p = running.erase(p);
+    }
+  }
+
+  return nfail;
+}
+
+}
+
+//---
+
+int
+main(int argc, char **argv)
+{
+  // render without a display
+  setenv("QT_QPA_PLATFORM", "offscreen", 0);
+
+  CQApp app(argc, argv);
+
+  CArgs cargs("-golden:s -output:s -update:f -compare:s -jobs:i -worker:f "
+              "-width:i -height:i -box_tolerance:i -pixel_tolerance:i -max_diff_pixels:i");
+
+  cargs.parse(&argc, argv);
+
+  Options options;
+
+  if (cargs.getStringArg("-golden") != "") options.goldenDir = cargs.getStringArg("-golden");
+  if (cargs.getStringArg("-output") != "") options.outputDir = cargs.getStringArg("-output");
+
+  options.compare = cargs.getStringArg ("-compare");
+  options.update  = cargs.getBooleanArg("-update");
+
+  if (cargs.getIntegerArg("-width" ) > 0) options.width  = cargs.getIntegerArg("-width");
+  if (cargs.getIntegerArg("-height") > 0) options.height = cargs.getIntegerArg("-height");
+
+  options.boxTolerance   = std::max(cargs.getIntegerArg("-box_tolerance"  ), 0);
+  options.pixelTolerance = std::max(cargs.getIntegerArg("-pixel_tolerance"), 0);
+  options.maxDiffPixels  = std::max(cargs.getIntegerArg("-max_diff_pixels"), 0);
+
+  if (options.compare != "" && options.compare != "old_layout" &&
+      options.compare != "incremental") {
+    std::cerr << "Invalid compare mode '" << options.compare << "'" << std::endl;
+    return 1;
+  }
+
+  if (options.compare != "" && options.update) {
+    std::cerr << "Can't update golden files in compare mode" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; ++i)
+    files.push_back(argv[i]);
+
+  if (files.empty()) {
+    std::cerr << "No files" << std::endl;
+    return 1;
+  }
+
+  //---
+
+  if (! QDir().mkpath(options.outputDir.c_str()) ||
+      (options.update && ! QDir().mkpath(options.goldenDir.c_str()))) {
+    std::cerr << "Failed to create output directories" << std::endl;
+    return 1;
+  }
+
+  // single file in this process
+  if (cargs.getBooleanArg("-worker") || files.size() == 1) {
+    CBrowserMain *browser = CBrowserMainInst;
+
+    browser->setBatch(true);
+    browser->setDocCacheSize(0);
+
+    int nfail = 0;
+
+    for (const auto &file : files)
+      nfail += testPage(file, options);
+
+    return (nfail > 0 ? 1 : 0);
+  }
+
+  //---
+
+  int jobs = cargs.getIntegerArg("-jobs");
+
+  if (jobs < 1)
+    jobs = std::max(QThread::idealThreadCount(), 1);
+
+  // pass options on to workers
+  QStringList args;
+
+  args << "-golden" << options.goldenDir.c_str() << "-output" << options.outputDir.c_str() <<
+          "-width" << QString::number(options.width) <<
+          "-height" << QString::number(options.height) <<
+          "-box_tolerance" << QString::number(options.boxTolerance) <<
+          "-pixel_tolerance" << QString::number(options.pixelTolerance) <<
+          "-max_diff_pixels" << QString::number(options.maxDiffPixels);
+
+  if (options.update)
+    args << "-update";
+
+  if (options.compare != "")
+    args << "-compare" << options.compare.c_str();
+
+  int nfail = runWorkers(files, args, jobs);
+
+  std::cout << files.size() - nfail << " passed, " << nfail << " failed" << std::endl;
+
+  return (nfail > 0 ? 1 : 0);
+}
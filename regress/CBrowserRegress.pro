@@ -0,0 +1,85 @@
+TEMPLATE = app
+
+QT += widgets webkitwidgets
+
+TARGET = CBrowserRegress
+
+DEPENDPATH += . ../src
+
+MOC_DIR = .moc
+
+QMAKE_CXXFLAGS += -std=c++14
+
+CONFIG += debug
+
+# Input (all browser sources except its main)
+SOURCES += \
+CBrowserRegress.cpp \
+$$files(../src/*.cpp) \
+
+SOURCES -= ../src/CBrowser.cpp
+
+HEADERS += \
+$$files(../src/*.h) \
+
+DESTDIR     = ../bin
+OBJECTS_DIR = ../obj/regress
+LIB_DIR     = ../lib
+
+INCLUDEPATH += \
+. \
+../src \
+../include \
+../../CJavaScript/qinclude \
+../../CJavaScript/include \
+../../CJson/include \
+../../CHtml/include \
+../../CSVG/include \
+../../CCSS/include \
+../../CWebGet/include \
+../../CQUtil/include \
+../../CImageLib/include \
+../../CFont/include \
+../../CCeil/include \
+../../CArgs/include \
+../../CFile/include \
+../../CFileUtil/include \
+../../COS/include \
+../../CStrUtil/include \
+../../CRegExp/include \
+../../CUtil/include \
+../../CMath/include \
+../../CGlob/include \
+../../CReadLine/include \
+../../CRGBName/include \
+
+unix:LIBS += \
+-L$$LIB_DIR \
+-L../../CJavaScript/lib \
+-L../../CJson/lib \
+-L../../CHtml/lib \
+-L../../CCSS/lib \
+-L../../CWebGet/lib \
+-L../../CSVG/lib \
+-L../../CHtml/lib \
+-L../../CXML/lib \
+-L../../CQUtil/lib \
+-L../../CImageLib/lib \
+-L../../CFont/lib \
+-L../../CCeil/lib \
+-L../../CArgs/lib \
+-L../../CConfig/lib \
+-L../../CReadLine/lib \
+-L../../CFile/lib \
+-L../../CFileUtil/lib \
+-L../../CStrUtil/lib \
+-L../../CRegExp/lib \
+-L../../CGlob/lib \
+-L../../CThread/lib \
+-L../../CUtil/lib \
+-L../../COS/lib \
+-L../../CRGBName/lib \
+-lCQJavaScript -lCJavaScript -lCJson -lCHtml -lCCSS -lCXML -lCWebGet -lCSVG \
+-lCQUtil -lCImageLib -lCFont -lCCeil -lCArgs -lCConfig -lCReadLine \
+-lCFile -lCFileUtil -lCStrUtil -lCGlob -lCRegExp -lCRGBName -lCUtil -lCOS \
+-lCThread -ljpeg -lpng -lcurses -ltre
@@ -1,14 +1,28 @@
 #include <CQApp.h>
 #include <CArgs.h>
 #include <CBrowserMain.h>
-#include <QTimer>
+#include <CBrowserBatch.h>
+#include <CBrowserTrace.h>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
 
 int
 main(int argc, char **argv)
 {
+  // batch mode renders without a display so use offscreen platform plugin
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-batch") == 0) {
+      setenv("QT_QPA_PLATFORM", "offscreen", 0);
+      break;
+    }
+  }
+
   CQApp app(argc, argv);
 
-  CArgs cargs("-debug:f -use_alt:f -batch:f -old_layout:f");
+  CArgs cargs("-debug:f -use_alt:f -batch:f -old_layout:f -incremental:f "
+              "-doc_cache:i -print_file:s -page_size:s "
+              "-output:s -format:s -width:i -height:i -full_page:f -trace:s");
 
   cargs.parse(&argc, argv);
 
@@ -22,6 +36,74 @@ main(int argc, char **argv)
   browser->setDebug (debug);
   browser->setUseAlt(use_alt);
   browser->setOldLayout(old);
+  browser->setBatch(batch);
+
+  // show start of large documents before they are fully built
+  browser->setIncremental(cargs.getBooleanArg("-incremental"));
+
+  // keep built documents for back/forward (negative value disables)
+  int docCache = cargs.getIntegerArg("-doc_cache");
+
+  if      (batch)        browser->setDocCacheSize(0);
+  else if (docCache < 0) browser->setDocCacheSize(0);
+  else if (docCache > 0) browser->setDocCacheSize(docCache);
+
+  // print output file and paper size (a4, letter, legal or <width>x<height> points)
+  std::string printFile = cargs.getStringArg("-print_file");
+  std::string pageSize  = cargs.getStringArg("-page_size");
+
+  if (printFile != "")
+    browser->setPrintFile(printFile);
+
+  if (pageSize != "" && ! browser->setPaperSize(pageSize)) {
+    std::cerr << "Invalid page size '" << pageSize << "'" << std::endl;
+    return 1;
+  }
+
+  // record phase timings and write as Chrome trace JSON on exit
+  std::string traceFile = cargs.getStringArg("-trace");
+
+  if (traceFile != "")
+    CBrowserTraceInst->setEnabled(true);
+
+  //---
+
+  // render each file to output directory and exit
+  if (batch) {
+    CBrowserBatch renderer;
+
+    std::string output = cargs.getStringArg ("-output");
+    std::string format = cargs.getStringArg ("-format");
+    int         width  = cargs.getIntegerArg("-width");
+    int         height = cargs.getIntegerArg("-height");
+
+    if (output != "") renderer.setOutputDir(output);
+    if (width  > 0  ) renderer.setWidth    (width);
+    if (height > 0  ) renderer.setHeight   (height);
+
+    if (format != "" && ! renderer.setFormat(format)) {
+      std::cerr << "Invalid format '" << format << "'" << std::endl;
+      return 1;
+    }
+
+    renderer.setFullPage(cargs.getBooleanArg("-full_page"));
+
+    int rc = 0;
+
+    for (int i = 1; i < argc; ++i) {
+      CUrl url(argv[i]);
+
+      if (! renderer.render(url))
+        rc = 1;
+    }
+
+    if (traceFile != "")
+      CBrowserTraceInst->writeJSON(traceFile);
+
+    return rc;
+  }
+
+  //---
 
   if (argc > 1) {
     for (int i = 1; i < argc; ++i) {
@@ -29,10 +111,11 @@ main(int argc, char **argv)
 
       CUrl url(fileName);
 
+      // first document is shown, others are read in background tabs
       if (i == 1)
         browser->setDocument(url);
       else
-        browser->addDocument(url);
+        browser->addDocument(url, /*background*/true);
     }
   }
   else {
@@ -41,13 +124,10 @@ main(int argc, char **argv)
     browser->setDocument(url);
   }
 
-  if (batch) {
-    QTimer *timer = new QTimer;
-
-    QObject::connect(timer, SIGNAL(timeout()), browser, SLOT(exitSlot()));
+  int rc = app.exec();
 
-    timer->start(100);
-  }
+  if (traceFile != "")
+    CBrowserTraceInst->writeJSON(traceFile);
 
-  return app.exec();
+  return rc;
 }
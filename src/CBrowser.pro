@@ -17,6 +17,7 @@ SOURCES += \
 CBrowserAddress.cpp \
 CBrowserArea.cpp \
 CBrowserBaseFont.cpp \
+CBrowserBatch.cpp \
 CBrowserBlockQuote.cpp \
 CBrowserBody.cpp \
 CBrowserBox.cpp \
@@ -35,6 +36,7 @@ CBrowserDomTree.cpp \
 CBrowserFile.cpp \
 CBrowserFont.cpp \
 CBrowserForm.cpp \
+CBrowserFormControl.cpp \
 CBrowserGraphics.cpp \
 CBrowserHead.cpp \
 CBrowserHeader.cpp \
@@ -71,6 +73,7 @@ CBrowserSVG.cpp \
 CBrowserTable.cpp \
 CBrowserText.cpp \
 CBrowserTitle.cpp \
+CBrowserTrace.cpp \
 CBrowserTT.cpp \
 CBrowserVideo.cpp \
 CBrowserWebView.cpp \
@@ -81,6 +84,10 @@ CBrowserXmp.cpp \
 \
 CQSVGRenderer.cpp \
 CQSVGImageData.cpp \
+CQSVGImagePool.cpp \
+CQSVGPath.cpp \
+CQSVGThreadPool.cpp \
+CQSVGTurbulence.cpp \
 \
 CRomanNumber.cpp \
 CPrint.cpp \
@@ -90,6 +97,7 @@ CBrowserAddress.h \
 CBrowserArea.h \
 CBrowserBackground.h \
 CBrowserBaseFont.h \
+CBrowserBatch.h \
 CBrowserBlockQuote.h \
 CBrowserBody.h \
 CBrowserBorder.h \
@@ -114,6 +122,7 @@ CBrowserFile.h \
 CBrowserFloat.h \
 CBrowserFont.h \
 CBrowserForm.h \
+CBrowserFormControl.h \
 CBrowserGraphics.h \
 CBrowserHeader.h \
 CBrowserHead.h \
@@ -154,6 +163,7 @@ CBrowserSamp.h \
 CBrowserScript.h \
 CBrowserScrolledWindow.h \
 CBrowserShadow.h \
+CBrowserSharedStyle.h \
 CBrowserSize.h \
 CBrowserStyleData.h \
 CBrowserStyle.h \
@@ -162,6 +172,7 @@ CBrowserTable.h \
 CBrowserText.h \
 CBrowserTextProp.h \
 CBrowserTitle.h \
+CBrowserTrace.h \
 CBrowserTT.h \
 CBrowserTypes.h \
 CBrowserUnitValue.h \
@@ -175,6 +186,10 @@ CBrowserXmp.h \
 \
 CQSVGRenderer.h \
 CQSVGImageData.h \
+CQSVGImagePool.h \
+CQSVGPath.h \
+CQSVGThreadPool.h \
+CQSVGTurbulence.h \
 \
 CTextBox.h \
 CRomanNumber.h \
@@ -7,5 +7,5 @@ CBrowserAddress(CBrowserWindow *window) :
 {
   setDisplay(Display::BLOCK);
 
-  font_.setStyle(CBrowserFontStyle(CBrowserFontStyle::Type::ITALIC));
+  fontRef().setStyle(CBrowserFontStyle(CBrowserFontStyle::Type::ITALIC));
 }
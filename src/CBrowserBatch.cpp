@@ -0,0 +1,117 @@
+#include <CBrowserBatch.h>
+#include <CBrowserMain.h>
+#include <CBrowserMainWindow.h>
+#include <CBrowserScrolledWindow.h>
+#include <CBrowserWindow.h>
+#include <CBrowserObject.h>
+#include <CStrUtil.h>
+#include <QImage>
+#include <iostream>
+
+CBrowserBatch::
+CBrowserBatch()
+{
+}
+
+bool
+CBrowserBatch::
+setFormat(const std::string &name)
+{
+  std::string lname = CStrUtil::toLower(name);
+
+  if      (lname == "png")
+    format_ = Format::PNG;
+  else if (lname == "ps")
+    format_ = Format::PS;
+  else
+    return false;
+
+  return true;
+}
+
+bool
+CBrowserBatch::
+render(const CUrl &url)
+{
+  CBrowserScrolledWindow *swindow = CBrowserMainInst->iface()->currentWindow();
+
+  if (! swindow)
+    return false;
+
+  CBrowserWindow *window = swindow->getWindow();
+
+  //---
+
+  // layout at viewport size
+  swindow->setViewportSize(width_, height_);
+
+  swindow->setDocument(url);
+
+  if (! window->getDocument())
+    return false;
+
+  //---
+
+  // grow viewport to fit content for full page output
+  int height = height_;
+
+  if (fullPage_ && window->rootObject()) {
+    int h = window->rootObject()->contentHeight() + 2*window->getTopMargin();
+
+    if (h > height) {
+      height = h;
+
+      swindow->setViewportSize(width_, height);
+
+      window->recalc();
+    }
+  }
+
+  //---
+
+  std::string filename = outputFile(url);
+
+  if (format_ == Format::PNG) {
+    QImage image(width_, height, QImage::Format_ARGB32);
+
+    swindow->renderImage(image);
+
+    if (! image.save(filename.c_str(), "PNG")) {
+      std::cerr << "Failed to write '" << filename << "'" << std::endl;
+      return false;
+    }
+  }
+  else {
+    swindow->renderPS(filename, 0, 0, width_, height);
+  }
+
+  if (CBrowserMainInst->getDebug())
+    std::cerr << url.getUrl() << " -> " << filename << std::endl;
+
+  return true;
+}
+
+std::string
+CBrowserBatch::
+outputFile(const CUrl &url) const
+{
+  std::string name = url.getLocalFile();
+
+  if (name == "")
+    name = "index";
+
+  // strip directory and extension
+  auto p1 = name.rfind('/');
+
+  if (p1 != std::string::npos)
+    name = name.substr(p1 + 1);
+
+  auto p2 = name.rfind('.');
+
+  if (p2 != std::string::npos && p2 > 0)
+    name = name.substr(0, p2);
+
+  std::string ext = (format_ == Format::PNG ? ".png" : ".ps");
+
+  return outputDir_ + "/" + name + ext;
+}
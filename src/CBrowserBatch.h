@@ -0,0 +1,51 @@
+#ifndef CBrowserBatch_H
+#define CBrowserBatch_H
+
+#include <CUrl.h>
+#include <string>
+
+class CBrowserScrolledWindow;
+
+// render documents to image (PNG) or PostScript files without displaying a window
+class CBrowserBatch {
+ public:
+  enum class Format {
+    PNG,
+    PS
+  };
+
+ public:
+  CBrowserBatch();
+
+  int width() const { return width_; }
+  void setWidth(int i) { width_ = i; }
+
+  int height() const { return height_; }
+  void setHeight(int i) { height_ = i; }
+
+  bool isFullPage() const { return fullPage_; }
+  void setFullPage(bool b) { fullPage_ = b; }
+
+  const Format &format() const { return format_; }
+  void setFormat(const Format &f) { format_ = f; }
+
+  bool setFormat(const std::string &name);
+
+  const std::string &outputDir() const { return outputDir_; }
+  void setOutputDir(const std::string &dir) { outputDir_ = dir; }
+
+  // render url to output file, returns false on failure
+  bool render(const CUrl &url);
+
+ private:
+  std::string outputFile(const CUrl &url) const;
+
+ private:
+  int         width_     { 800 };
+  int         height_    { 600 };
+  bool        fullPage_  { false };
+  Format      format_    { Format::PNG };
+  std::string outputDir_ { "." };
+};
+
+#endif
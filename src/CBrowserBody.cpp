@@ -29,7 +29,7 @@ setNameValue(const std::string &name, const std::string &value)
     data_.alink = value;
   }
   else if (lname == "background") {
-    background_.setImage(CBrowserBackgroundImage(value));
+    backgroundRef().setImage(CBrowserBackgroundImage(value));
   }
   else if (lname == "bgproperties") {
     if      (lvalue == "fixed") {
@@ -798,3 +798,18 @@ boxAt(const CIPoint2D &p, CBrowserBox* &box, double &area)
     }
   }
 }
+
+size_t
+CBrowserBox::
+styleMemUsage() const
+{
+  return margin_.memUsage() + border_.memUsage() + padding_.memUsage();
+}
+
+size_t
+CBrowserBox::
+unsharedStyleMemUsage() const
+{
+  return margin_.unsharedMemUsage() + border_.unsharedMemUsage() +
+         padding_.unsharedMemUsage();
+}
@@ -7,6 +7,7 @@
 #include <CBrowserPadding.h>
 #include <CBrowserPosition.h>
 #include <CBrowserSize.h>
+#include <CBrowserSharedStyle.h>
 #include <CHtmlTypes.h>
 #include <CIBBox2D.h>
 #include <CTextBox.h>
@@ -40,10 +41,10 @@ class CBrowserBox {
 
   //---
 
-  const CBrowserMargin &margin() const { return margin_; }
+  const CBrowserMargin &margin() const { return *margin_; }
   void setMargin(const CBrowserMargin &v) { margin_ = v; }
 
-  CBrowserMargin &marginRef() { return margin_; }
+  CBrowserMargin &marginRef() { return margin_.ref(); }
 
   double marginLeft  () const { return margin().left  ().pxValue(); }
   double marginRight () const { return margin().right ().pxValue(); }
@@ -52,10 +53,10 @@ class CBrowserBox {
 
   //---
 
-  const CBrowserBorder &border() const { return border_; }
+  const CBrowserBorder &border() const { return *border_; }
   void setBorder(const CBrowserBorder &v) { border_ = v; }
 
-  CBrowserBorder &borderRef() { return border_; }
+  CBrowserBorder &borderRef() { return border_.ref(); }
 
   double borderLeft  () const { return border().left  ().width.value().pxValue(); }
   double borderRight () const { return border().right ().width.value().pxValue(); }
@@ -64,10 +65,13 @@ class CBrowserBox {
 
   //---
 
-  const CBrowserPadding &padding() const { return padding_; }
+  const CBrowserPadding &padding() const { return *padding_; }
   void setPadding(const CBrowserPadding &v) { padding_ = v; }
 
-  CBrowserPadding &paddingRef() { return padding_; }
+  CBrowserPadding &paddingRef() { return padding_.ref(); }
+
+  // share margin and padding with other boxes with equal values
+  void internStyle() { margin_.intern(); padding_.intern(); }
 
   double paddingLeft  () const { return padding().left  ().pxValue(); }
   double paddingRight () const { return padding().right ().pxValue(); }
@@ -96,6 +100,10 @@ class CBrowserBox {
 
   void addChild(CBrowserBox *box) { children_.push_back(box); }
 
+  // box has been added to layout tree
+  bool isInLayout() const { return inLayout_; }
+  void setInLayout(bool b) { inLayout_ = b; }
+
   //---
 
   int width() const { return content_.getWidth() + nonContentWidth(); }
@@ -216,6 +224,14 @@ class CBrowserBox {
 
   void boxAt(const CIPoint2D &p, CBrowserBox* &box, double &area);
 
+  //---
+
+  // bytes of style data (shared values are divided between users)
+  virtual size_t styleMemUsage() const;
+
+  // bytes of style data if no values were shared
+  virtual size_t unsharedStyleMemUsage() const;
+
  private:
   typedef std::vector<CBrowserBox *> Boxes;
 
@@ -225,15 +241,16 @@ class CBrowserBox {
   int             y_ { 0 };
   int             ascent_ { 0 };
   int             descent_ { 0 };
-  CBrowserMargin  margin_;
-  CBrowserBorder  border_;
-  CBrowserPadding padding_;
-  CIBBox2D        content_;
-  CHAlignType     halign_ { CHALIGN_TYPE_LEFT };
-  CVAlignType     valign_ { CVALIGN_TYPE_TOP };
-  bool            fixedWidth_ { false };
-  bool            fixedHeight_ { false };
-  Boxes           children_;
+  CBrowserSharedStyle<CBrowserMargin>  margin_;
+  CBrowserSharedStyle<CBrowserBorder>  border_;
+  CBrowserSharedStyle<CBrowserPadding> padding_;
+  CIBBox2D                             content_;
+  CHAlignType                          halign_ { CHALIGN_TYPE_LEFT };
+  CVAlignType                          valign_ { CVALIGN_TYPE_TOP };
+  bool                                 fixedWidth_ { false };
+  bool                                 fixedHeight_ { false };
+  bool                                 inLayout_ { false };
+  Boxes                                children_;
 };
 
 class CBrowserBoxNode {
@@ -117,6 +117,9 @@ createWidget()
 {
   assert(! canvasWidget_);
 
+  // ensure javascript canvas object exists
+  (void) getJObj();
+
   canvasWidget_ = new CQJCanvasWidget(canvas_);
 
   canvasWidget_->setParent(window_->widget());
@@ -6,7 +6,8 @@
 #include <CBrowserWindowWidget.h>
 #include <CBrowserMain.h>
 
-#include <CTempFile.h>
+#include <CHtmlParser.h>
+#include <CStrUtil.h>
 #include <CCeilL.h>
 
 #include <QMessageBox>
@@ -103,27 +104,99 @@ CBrowserCeil()
     ClParserInst->createUserFn(userfn_data[i]);
 }
 
-CTempFile *
+void
+CBrowserCeil::
+openOutputDocument(CBrowserWindow *window)
+{
+  closeOutputDocument();
+
+  outputWindow_ = window;
+  output_       = new CBrowserOutput(window);
+
+  output_->beginTokens();
+}
+
+void
+CBrowserCeil::
+writeOutputDocument(CBrowserWindow *window, const std::string &text)
+{
+  if (! output_ || outputWindow_ != window)
+    openOutputDocument(window);
+
+  outputText_ += text;
+
+  flushOutputDocument(/*all*/false);
+}
+
+void
 CBrowserCeil::
-initOutputDocumentFile()
+closeOutputDocument()
 {
-  if (! outputDocumentFile_)
-    outputDocumentFile_ = new CTempFile;
+  if (! output_)
+    return;
 
-  return outputDocumentFile_;
+  flushOutputDocument(/*all*/true);
+
+  output_->endTokens();
+
+  delete output_;
+
+  output_       = nullptr;
+  outputWindow_ = nullptr;
+
+  outputTokens_.clear();
 }
 
+// parse written text and add to document (when not all only complete tags are parsed
+// and text is batched so many small writes are not parsed one at a time)
 void
 CBrowserCeil::
-deleteOutputDocumentFile()
+flushOutputDocument(bool all)
 {
-  if (outputDocumentFile_) {
-    outputDocumentFile_->getFile()->remove();
+  static const size_t minParseLen = 4096;
+
+  size_t len = outputText_.size();
+
+  if (! all) {
+    if (len < minParseLen)
+      return;
+
+    // end of last tag
+    auto pos = outputText_.rfind('>');
+
+    if (pos == std::string::npos)
+      return;
 
-    delete outputDocumentFile_;
+    len = pos + 1;
 
-    outputDocumentFile_ = nullptr;
+    // don't split inside comment, script or style
+    std::string lstr = CStrUtil::toLower(outputText_.substr(0, len));
+
+    auto lastPos = [&](const char *str) {
+      auto p = lstr.rfind(str);
+      return (p != std::string::npos ? long(p) : -1L);
+    };
+
+    if (lastPos("<!--"   ) > lastPos("-->"      ) ||
+        lastPos("<script") > lastPos("</script" ) ||
+        lastPos("<style" ) > lastPos("</style"  ))
+      return;
   }
+
+  if (len == 0)
+    return;
+
+  //---
+
+  TokensP tokens = std::make_shared<CHtmlParserTokens>();
+
+  outputWindow_->fileMgr()->readHTMLString(outputText_.substr(0, len), *tokens);
+
+  outputText_.erase(0, len);
+
+  outputTokens_.push_back(tokens);
+
+  output_->addTokens(*tokens, 0, tokens->size());
 }
 
 void
@@ -204,7 +277,7 @@ HtmlRunCeilScriptLines(CBrowserWindow *window, std::vector<std::string> &lines,
   ClParserInst->createVar("window"  , ClParserValueMgrInst->createValue((long) window  ));
   ClParserInst->createVar("document", ClParserValueMgrInst->createValue((long) document));
 
-  CBrowserCeilInst->setOutputDocumentFile(nullptr);
+  CBrowserCeilInst->closeOutputDocument();
 
   std::string buffer = "";
 
@@ -230,21 +303,7 @@ HtmlRunCeilScriptLines(CBrowserWindow *window, std::vector<std::string> &lines,
   if (buffer[0] != '\0')
     ClLanguageMgrInst->runCommand((char *) buffer.c_str());
 
-  CTempFile *output_document_file = CBrowserCeilInst->outputDocumentFile();
-
-  if (output_document_file) {
-    output_document_file->getFile()->close();
-
-    CHtmlParserTokens tokens;
-
-    window->fileMgr()->readFile(output_document_file->getFile()->getPath(), tokens);
-
-    CBrowserOutput output(window);
-
-    output.processTokens(tokens);
-
-    CBrowserCeilInst->deleteOutputDocumentFile();
-  }
+  CBrowserCeilInst->closeOutputDocument();
 }
 
 static ClParserValuePtr
@@ -334,25 +393,7 @@ HtmlScriptDocumentOpen()
                                      CLArgType::STRING , &type    , -1)) {
     CBrowserDocument *document = (CBrowserDocument *) idocument;
 
-    CTempFile *output_document_file = CBrowserCeilInst->outputDocumentFile();
-
-    if (output_document_file) {
-      output_document_file->getFile()->close();
-
-      CBrowserWindow *window = document->getWindow();
-
-      CHtmlParserTokens tokens;
-
-      window->fileMgr()->readFile(output_document_file->getFile()->getPath(), tokens);
-
-      CBrowserOutput output(window);
-
-      output.processTokens(tokens);
-
-      CBrowserCeilInst->deleteOutputDocumentFile();
-    }
-
-    CBrowserCeilInst->initOutputDocumentFile();
+    CBrowserCeilInst->openOutputDocument(document->getWindow());
   }
 
   ClParserValuePtr value = ClParserValueMgrInst->createValue(0L);
@@ -368,9 +409,9 @@ HtmlScriptDocumentWrite()
 
   if (ClParserInst->getUserFnArgList(CLArgType::INTEGER, &idocument,
                                      CLArgType::STRING , &text     , -1)) {
-    CTempFile *output_document_file = CBrowserCeilInst->initOutputDocumentFile();
+    CBrowserDocument *document = (CBrowserDocument *) idocument;
 
-    output_document_file->getFile()->write(text);
+    CBrowserCeilInst->writeOutputDocument(document->getWindow(), text);
   }
 
   ClParserValuePtr value = ClParserValueMgrInst->createValue(0L);
@@ -386,10 +427,9 @@ HtmlScriptDocumentWriteLn()
 
   if (ClParserInst->getUserFnArgList(CLArgType::INTEGER, &idocument,
                                      CLArgType::STRING , &text    , -1)) {
-    CTempFile *output_document_file = CBrowserCeilInst->initOutputDocumentFile();
+    CBrowserDocument *document = (CBrowserDocument *) idocument;
 
-    output_document_file->getFile()->write(text);
-    output_document_file->getFile()->write("\n");
+    CBrowserCeilInst->writeOutputDocument(document->getWindow(), std::string(text) + "\n");
   }
 
   ClParserValuePtr value = ClParserValueMgrInst->createValue(0L);
@@ -402,27 +442,8 @@ HtmlScriptDocumentClose()
 {
   long idocument;
 
-  if (ClParserInst->getUserFnArgList(CLArgType::INTEGER, &idocument, -1)) {
-    CTempFile *output_document_file = CBrowserCeilInst->outputDocumentFile();
-
-    if (output_document_file) {
-      output_document_file->getFile()->close();
-
-      CBrowserDocument *document = (CBrowserDocument *) idocument;
-
-      CBrowserWindow *window = document->getWindow();
-
-      CHtmlParserTokens tokens;
-
-      window->fileMgr()->readFile(output_document_file->getFile()->getPath(), tokens);
-
-      CBrowserOutput output(window);
-
-      output.processTokens(tokens);
-
-      CBrowserCeilInst->deleteOutputDocumentFile();
-    }
-  }
+  if (ClParserInst->getUserFnArgList(CLArgType::INTEGER, &idocument, -1))
+    CBrowserCeilInst->closeOutputDocument();
 
   ClParserValuePtr value = ClParserValueMgrInst->createValue(0L);
 
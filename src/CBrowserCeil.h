@@ -2,8 +2,11 @@
 #define CBrowserCeil_H
 
 #include <CBrowserTypes.h>
+#include <memory>
+#include <vector>
 
-class CTempFile;
+class CBrowserOutput;
+class CHtmlParserTokens;
 
 #define CBrowserCeilInst CBrowserCeil::instance()
 
@@ -11,11 +14,10 @@ class CBrowserCeil {
  public:
   static CBrowserCeil *instance();
 
-  CTempFile *outputDocumentFile() const { return outputDocumentFile_; }
-  void setOutputDocumentFile(CTempFile *file) { outputDocumentFile_ = file; }
-
-  CTempFile *initOutputDocumentFile();
-  void deleteOutputDocumentFile();
+  // document write output (parsed as written and added at current object of window)
+  void openOutputDocument(CBrowserWindow *window);
+  void writeOutputDocument(CBrowserWindow *window, const std::string &text);
+  void closeOutputDocument();
 
   void        runScriptFile(CBrowserWindow *window, const std::string &);
   void        runScript(CBrowserWindow *window, const std::string &);
@@ -24,8 +26,16 @@ class CBrowserCeil {
  private:
   CBrowserCeil();
 
+  void flushOutputDocument(bool all);
+
  private:
-  CTempFile *outputDocumentFile_ { nullptr };
+  typedef std::shared_ptr<CHtmlParserTokens> TokensP;
+  typedef std::vector<TokensP>               TokensList;
+
+  CBrowserWindow* outputWindow_ { nullptr };
+  CBrowserOutput* output_ { nullptr };
+  std::string     outputText_;
+  TokensList      outputTokens_; // kept until output closed (tag stack references tags)
 };
 
 #endif
@@ -5,5 +5,5 @@ CBrowserCode::
 CBrowserCode(CBrowserWindow *window) :
  CBrowserObject(window, CHtmlTagId::CODE)
 {
-  font_.setFamily(CBrowserFontFamily("monospace"));
+  fontRef().setFamily(CBrowserFontFamily("monospace"));
 }
@@ -4,6 +4,7 @@
 #include <CBrowserFile.h>
 #include <CBrowserOutput.h>
 #include <CBrowserText.h>
+#include <CHtmlLib.h>
 #include <CRGBName.h>
 
 CBrowserDocument::
@@ -100,15 +101,12 @@ read(const CUrl &url)
   url_ = url;
 
   if      (url_.isFile()) {
-    std::string filename = url_.getFile();
+    std::string msg;
 
-    if (! CFile::exists(filename)) {
-      window_->displayError("File '%s' does not exist", filename.c_str());
+    if (! readFile(url, msg)) {
+      window_->displayError("%s", msg.c_str());
       return false;
     }
-
-    if (! window_->fileMgr()->readFile(filename, tokens_))
-      return false;
   }
   else if (url.isHttp()) {
     std::string filename;
@@ -136,6 +134,70 @@ read(const CUrl &url)
   return true;
 }
 
+bool
+CBrowserDocument::
+readFile(const CUrl &url, std::string &msg)
+{
+  tokens_.clear();
+
+  url_ = url;
+
+  std::string filename = url_.getFile();
+
+  if (! CFile::exists(filename)) {
+    msg = "File '" + filename + "' does not exist";
+    return false;
+  }
+
+  if (! window_->fileMgr()->readFile(filename, tokens_)) {
+    msg = "Failed to read file '" + filename + "'";
+    return false;
+  }
+
+  return true;
+}
+
+size_t
+CBrowserDocument::
+memUsage() const
+{
+  size_t bytes = sizeof(CBrowserDocument) + title_.capacity();
+
+  bytes += (anchors_.capacity() + links_.capacity())*sizeof(CBrowserAnchorLink *) +
+           forms_.capacity()*sizeof(CBrowserForm *);
+
+  if (bgImage_.isValid())
+    bytes += size_t(bgImage_->getWidth())*bgImage_->getHeight()*4;
+
+  //---
+
+  // tokens own their tag names, option names and values and text
+  int n = tokens_.size();
+
+  for (int i = 0; i < n; ++i) {
+    const CHtmlToken *t = tokens_[i];
+
+    bytes += sizeof(*t) + sizeof(t);
+
+    if      (t->isTag()) {
+      CHtmlTag *tag = t->getTag();
+
+      bytes += sizeof(*tag) + tag->getName().capacity();
+
+      for (const auto &opt : tag->getOptions())
+        bytes += sizeof(*opt) + sizeof(opt) + opt->getName().capacity() +
+                 opt->getValue().capacity();
+    }
+    else if (t->isText()) {
+      CHtmlText *text = t->getText();
+
+      bytes += sizeof(*text) + text->getText().capacity();
+    }
+  }
+
+  return bytes;
+}
+
 void
 CBrowserDocument::
 setTitle(const std::string &title)
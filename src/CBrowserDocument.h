@@ -82,6 +82,13 @@ class CBrowserDocument {
 
   bool read(const CUrl &url);
 
+  // read file url without reporting errors to window (used by background read),
+  // failure reason returned in msg
+  bool readFile(const CUrl &url, std::string &msg);
+
+  // approximate bytes of memory used by tokens and document data
+  size_t memUsage() const;
+
  private:
   typedef std::vector<CBrowserAnchorLink *> Links;
 
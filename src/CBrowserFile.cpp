@@ -7,9 +7,22 @@
 #include <CUrl.h>
 #include <CTempFile.h>
 #include <CFileUtil.h>
-#include <CDir.h>
 #include <CEnv.h>
 
+#include <QDir>
+#include <QFileInfo>
+#include <fstream>
+#include <cctype>
+#include <mutex>
+
+namespace {
+
+// CHtml and CHtmlUtil are not known to be reentrant so documents read in background
+// threads are parsed one at a time
+std::mutex htmlMutex;
+
+}
+
 class CBrowserHtmlFileMgr : public CHtmlFileMgr {
  public:
   std::string getTypeName (CFileType file_type);
@@ -157,50 +170,99 @@ readFile(const std::string &filename, CHtmlParserTokens &tokens)
 
 bool
 CBrowserFileMgr::
-readDirectory(const std::string &directory, CHtmlParserTokens &tokens)
+isBackgroundReadable(const std::string &filename)
 {
-  CDir dir(directory);
+  if (! CFile::exists(filename))
+    return false;
 
-  CTempFile temp_file;
+  CFile file(filename);
 
-  CBrowserHtmlFileMgr mgr;
+  CFileType type = CFileUtil::getType(&file);
 
-  CFile *file = temp_file.getFile();
+  if (type & CFILE_TYPE_IMAGE)
+    return true;
 
-  file->open(CFile::Mode::READ);
+  switch (type) {
+    case CFILE_TYPE_INODE_DIR:
+    case CFILE_TYPE_TEXT_HTML:
+    case CFILE_TYPE_TEXT_XML:
+    case CFILE_TYPE_TEXT_PLAIN:
+    case CFILE_TYPE_TEXT_BINARY:
+      return true;
+    default:
+      break;
+  }
 
-  CHtmlUtil::listDirectory(dir, *file, mgr);
+  return false;
+}
 
-  file->close();
+bool
+CBrowserFileMgr::
+readDirectory(const std::string &directory, CHtmlParserTokens &tokens)
+{
+  std::string str;
 
-  //---
+  if (! listDirectory(directory, str))
+    return false;
 
-  bool flag = readHTMLFile(file->getPath(), tokens);
+  return readHTMLString(str, tokens);
+}
 
-  //---
+bool
+CBrowserFileMgr::
+readImageFile(const std::string &filename, CHtmlParserTokens &tokens)
+{
+  std::string str;
 
-  temp_file.getFile()->remove();
+  listImage(filename, str);
 
-  //---
+  return readHTMLString(str, tokens);
+}
 
-  return flag;
+bool
+CBrowserFileMgr::
+readTextFile(const std::string &filename, CHtmlParserTokens &tokens)
+{
+  std::string str;
+
+  if (! listTextFile(filename, str))
+    return false;
+
+  return readHTMLString(str, tokens);
 }
 
 bool
 CBrowserFileMgr::
-readImageFile(const std::string &filename, CHtmlParserTokens &tokens)
+readBinaryFile(const std::string &filename, CHtmlParserTokens &tokens)
+{
+  std::string str;
+
+  if (! listBinaryFile(filename, str))
+    return false;
+
+  return readHTMLString(str, tokens);
+}
+
+bool
+CBrowserFileMgr::
+readScriptFile(const std::string &filename, CHtmlParserTokens &tokens)
 {
+  // script output is generated by CHtmlUtil (file only)
   CTempFile temp_file;
 
   //---
 
   CFile *file = temp_file.getFile();
 
+  {
+  std::lock_guard<std::mutex> lock(htmlMutex);
+
   file->open(CFile::Mode::READ);
 
-  CHtmlUtil::listImage(filename, *file);
+  CHtmlUtil::listScriptFile(filename, *file);
 
   file->close();
+  }
 
   //---
 
@@ -213,98 +275,217 @@ readImageFile(const std::string &filename, CHtmlParserTokens &tokens)
   //---
 
   return flag;
-
 }
 
+//---
+
+// directory listing (only the first maxStatEntries entries are stat'ed for their
+// type and size, the rest are listed by name and typed when followed)
 bool
 CBrowserFileMgr::
-readTextFile(const std::string &filename, CHtmlParserTokens &tokens)
+listDirectory(const std::string &dirname, std::string &str)
 {
-  CTempFile temp_file;
+  static const int maxStatEntries = 1000;
 
-  //---
+  QDir dir(dirname.c_str());
 
-  CFile *file = temp_file.getFile();
+  if (! dir.exists())
+    return false;
 
-  file->open(CFile::Mode::READ);
+  // names only (no stat)
+  QStringList names =
+    dir.entryList(QDir::AllEntries | QDir::NoDot | QDir::Hidden | QDir::System, QDir::Name);
 
-  CHtmlUtil::listTextFile(filename, *file);
+  std::string title = htmlEncode(dirname);
 
-  file->close();
+  str.reserve(str.size() + 128*names.size());
 
-  //---
+  str += "<html>\n<head>\n<title>" + title + "</title>\n</head>\n<body>\n";
+  str += "<h1>" + title + "</h1>\n";
+  str += "<table border=0 cellpadding=2>\n";
 
-  bool flag = readHTMLFile(file->getPath(), tokens);
+  CBrowserHtmlFileMgr mgr;
 
-  //---
+  int i = 0;
 
-  temp_file.getFile()->remove();
+  for (const auto &name : names) {
+    std::string fname = name.toStdString();
+    std::string path  = dirname + "/" + fname;
+    std::string ename = htmlEncode(fname);
+    std::string epath = htmlEncode(path);
 
-  return flag;
+    str += "<tr>";
+
+    if (i < maxStatEntries || fname == "..") {
+      CFile file(path);
+
+      CFileType type = CFileUtil::getType(&file);
+
+      std::string size;
+
+      if (type != CFILE_TYPE_INODE_DIR)
+        size = std::to_string(QFileInfo(path.c_str()).size());
+
+      str += "<td><img src=\"" + mgr.getTypeImage(type) + "\"></td>";
+      str += "<td><a href=\"" + epath + "\">" + ename + "</a></td>";
+      str += "<td>" + mgr.getTypeName(type) + "</td>";
+      str += "<td align=right>" + size + "</td>";
+    }
+    else {
+      str += "<td></td>";
+      str += "<td><a href=\"" + epath + "\">" + ename + "</a></td>";
+      str += "<td></td><td></td>";
+    }
+
+    str += "</tr>\n";
+
+    ++i;
+  }
+
+  str += "</table>\n</body>\n</html>\n";
+
+  return true;
+}
+
+void
+CBrowserFileMgr::
+listImage(const std::string &filename, std::string &str)
+{
+  std::string title = htmlEncode(filename);
+
+  str += "<html>\n<head>\n<title>" + title + "</title>\n</head>\n<body>\n";
+  str += "<img src=\"" + title + "\">\n";
+  str += "</body>\n</html>\n";
 }
 
 bool
 CBrowserFileMgr::
-readBinaryFile(const std::string &filename, CHtmlParserTokens &tokens)
+listTextFile(const std::string &filename, std::string &str)
 {
-  CTempFile temp_file;
+  std::string text;
 
-  //---
+  if (! readFileData(filename, text))
+    return false;
 
-  CFile *file = temp_file.getFile();
+  std::string title = htmlEncode(filename);
 
-  file->open(CFile::Mode::READ);
+  str.reserve(str.size() + text.size() + 128);
 
-  CHtmlUtil::listBinaryFile(filename, *file);
+  str += "<html>\n<head>\n<title>" + title + "</title>\n</head>\n<body>\n<pre>\n";
+  str += htmlEncode(text);
+  str += "</pre>\n</body>\n</html>\n";
 
-  file->close();
+  return true;
+}
 
-  //---
+// hex dump (16 bytes per line with printable characters)
+bool
+CBrowserFileMgr::
+listBinaryFile(const std::string &filename, std::string &str)
+{
+  std::string data;
 
-  bool flag = readHTMLFile(file->getPath(), tokens);
+  if (! readFileData(filename, data))
+    return false;
 
-  //---
+  std::string title = htmlEncode(filename);
 
-  temp_file.getFile()->remove();
+  // each line is 8 (offset) + 16*3 (hex) + 16 (chars) + spacing
+  str.reserve(str.size() + 6*data.size() + 128);
 
-  //---
+  str += "<html>\n<head>\n<title>" + title + "</title>\n</head>\n<body>\n<pre>\n";
 
-  return flag;
+  static const char *hex = "0123456789abcdef";
+
+  size_t n = data.size();
+
+  for (size_t i = 0; i < n; i += 16) {
+    for (int s = 28; s >= 0; s -= 4)
+      str += hex[(i >> s) & 0xf];
+
+    str += "  ";
+
+    std::string chars;
+
+    for (size_t j = i; j < i + 16; ++j) {
+      if (j < n) {
+        unsigned char c = data[j];
+
+        str += hex[c >> 4];
+        str += hex[c & 0xf];
+        str += ' ';
+
+        chars += (isprint(c) ? char(c) : '.');
+      }
+      else
+        str += "   ";
+    }
+
+    str += ' ';
+    str += htmlEncode(chars);
+    str += '\n';
+  }
+
+  str += "</pre>\n</body>\n</html>\n";
+
+  return true;
 }
 
 bool
 CBrowserFileMgr::
-readScriptFile(const std::string &filename, CHtmlParserTokens &tokens)
+readFileData(const std::string &filename, std::string &data)
 {
-  CTempFile temp_file;
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
 
-  //---
+  if (! is)
+    return false;
 
-  CFile *file = temp_file.getFile();
+  is.seekg(0, std::ios::end);
 
-  file->open(CFile::Mode::READ);
+  std::streamoff len = is.tellg();
 
-  CHtmlUtil::listScriptFile(filename, *file);
+  is.seekg(0, std::ios::beg);
 
-  file->close();
+  if (len > 0) {
+    data.resize(size_t(len));
 
-  //---
+    is.read(&data[0], len);
 
-  bool flag = readHTMLFile(file->getPath(), tokens);
+    data.resize(size_t(is.gcount()));
+  }
 
-  //---
+  return true;
+}
 
-  temp_file.getFile()->remove();
+std::string
+CBrowserFileMgr::
+htmlEncode(const std::string &str)
+{
+  std::string estr;
 
-  //---
+  estr.reserve(str.size());
 
-  return flag;
+  for (const auto &c : str) {
+    switch (c) {
+      case '<' : estr += "&lt;"  ; break;
+      case '>' : estr += "&gt;"  ; break;
+      case '&' : estr += "&amp;" ; break;
+      case '"' : estr += "&quot;"; break;
+      default  : estr += c       ; break;
+    }
+  }
+
+  return estr;
 }
 
+//---
+
 bool
 CBrowserFileMgr::
 readHTMLString(const std::string &str, CHtmlParserTokens &tokens)
 {
+  std::lock_guard<std::mutex> lock(htmlMutex);
+
   CHtml html;
 
   if (! html.readString(str, tokens))
@@ -317,6 +498,8 @@ bool
 CBrowserFileMgr::
 readHTMLFile(const std::string &filename, CHtmlParserTokens &tokens)
 {
+  std::lock_guard<std::mutex> lock(htmlMutex);
+
   CHtml html;
 
   if (! html.read(filename, tokens))
@@ -34,6 +34,21 @@ class CBrowserFileMgr {
 
   bool readHTMLFile(const std::string &filename, CHtmlParserTokens &tokens);
 
+  // file can be read off the GUI thread (existing html, text, directory or image,
+  // not a script which is run to generate its output)
+  static bool isBackgroundReadable(const std::string &filename);
+
+ private:
+  // generate html for file views (in memory)
+  bool listDirectory (const std::string &dirname , std::string &str);
+  void listImage     (const std::string &filename, std::string &str);
+  bool listTextFile  (const std::string &filename, std::string &str);
+  bool listBinaryFile(const std::string &filename, std::string &str);
+
+  static bool readFileData(const std::string &filename, std::string &data);
+
+  static std::string htmlEncode(const std::string &str);
+
  private:
   CBrowserWindow *window_ { nullptr };
 };
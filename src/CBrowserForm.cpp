@@ -22,6 +22,7 @@
 #include <QListWidgetItem>
 #include <QTextEdit>
 #include <QHBoxLayout>
+#include <QAbstractButton>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QMenu>
@@ -103,15 +104,11 @@ CBrowserRegion
 CBrowserFormFileUpload::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -156,6 +153,8 @@ init()
 
   setObjectName(getName().c_str());
 
+  checked_ = data_.checked;
+
   CBrowserFormInput::init();
 }
 
@@ -183,15 +182,11 @@ CBrowserRegion
 CBrowserFormRadio::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -210,6 +205,8 @@ buttonProc()
     return;
   }
 
+  checked_ = true;
+
   int num = getForm()->getNumInputs();
 
   for (int i = 0; i < num; i++) {
@@ -220,14 +217,47 @@ buttonProc()
         input1->getName() != getName())
       continue;
 
-    QWidget *widget1 = const_cast<QWidget *>(input1->getWidget());
+    CBrowserFormRadio *radio1 = dynamic_cast<CBrowserFormRadio *>(input1);
 
-    QRadioButton *radio1 = qobject_cast<QRadioButton *>(widget1);
-
-    radio1->setChecked(false);
+    if (radio1)
+      radio1->setChecked(false);
   }
 }
 
+void
+CBrowserFormRadio::
+setChecked(bool b)
+{
+  checked_ = b;
+
+  QRadioButton *radio = qobject_cast<QRadioButton *>(widget_);
+
+  if (radio)
+    radio->setChecked(b);
+  else
+    window_->redraw();
+}
+
+void
+CBrowserFormRadio::
+reset()
+{
+  setChecked(data_.checked);
+}
+
+void
+CBrowserFormRadio::
+submit(std::string &text)
+{
+  // only the checked button of a group is submitted
+  if (! checked_)
+    return;
+
+  text += getName();
+  text += "=";
+  text += (data_.value != "" ? data_.value : "on");
+}
+
 //---
 
 CBrowserFormRange::
@@ -291,15 +321,11 @@ CBrowserRegion
 CBrowserFormRange::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -363,6 +389,7 @@ resetProc()
 {
   int num = getNumInputs();
 
+  // inactive inputs reset their stored value (e.g. checked state set by script)
   for (int i = 0; i < num; i++) {
     CBrowserFormInput *input = getInput(i);
 
@@ -381,10 +408,25 @@ submitProc()
 
   int num = getNumInputs();
 
+  bool first = true;
+
   for (int i = 0; i < num; i++) {
     CBrowserFormInput *input = getInput(i);
 
-    input->submit(text);
+    // submit reads value from widget if active, else from stored value
+    std::string value;
+
+    input->submit(value);
+
+    if (value == "")
+      continue;
+
+    if (! first)
+      text += "&";
+
+    text += value;
+
+    first = false;
   }
 
   CUrl url(text);
@@ -459,6 +501,14 @@ CBrowserFormInput(CBrowserWindow *window, CHtmlTagId id, CBrowserFormInputType t
 CBrowserFormInput::
 ~CBrowserFormInput()
 {
+  if (! widget_)
+    return;
+
+  // compound widgets (file upload) are inside a container
+  if (widget_->parentWidget() != window_->widget())
+    delete widget_->parentWidget();
+  else
+    delete widget_;
 }
 
 void
@@ -659,16 +709,169 @@ draw(const CTextBox &region)
 
 void
 CBrowserFormInput::
-drawWidget(CBrowserWindow *, const CTextBox &region)
+drawWidget(CBrowserWindow *window, const CTextBox &region)
 {
+  drawRegion_ = region;
+
+  // inactive control so draw image of control
+  if (! widget_) {
+    CBrowserFormControl::Type type = controlType();
+
+    if (type == CBrowserFormControl::Type::NONE)
+      return;
+
+    QImage image = CBrowserFormControl::image(type, controlFont(), controlText(),
+                                              isControlChecked(),
+                                              QSize(width_ - 4, height_ - 4));
+
+    window->drawImage(region.x() + 2, region.y() + 2, image);
+
+    return;
+  }
+
   widget_->move(region.x() + 2, region.y() + 2);
   widget_->resize(width_ - 4, height_ - 4);
 }
 
+CBrowserRegion
+CBrowserFormInput::
+region() const
+{
+  // size depends on font and control text so recalc if base font changes
+  // or region was invalidated (label/value change)
+  int fontSize = window_->getBaseFontSize();
+
+  if (fontSize != regionFontSize_) {
+    region_         = calcRegion();
+    regionFontSize_ = fontSize;
+  }
+
+  return region_;
+}
+
+CBrowserFormControl::Type
+CBrowserFormInput::
+controlType() const
+{
+  switch (type_) {
+    case CBrowserFormInputType::BUTTON:
+    case CBrowserFormInputType::RESET_BUTTON:
+    case CBrowserFormInputType::SUBMIT_BUTTON:
+      return CBrowserFormControl::Type::BUTTON;
+    case CBrowserFormInputType::CHECKBOX:
+      return CBrowserFormControl::Type::CHECK_BOX;
+    case CBrowserFormInputType::RADIO_BUTTON:
+      return CBrowserFormControl::Type::RADIO;
+    case CBrowserFormInputType::EMAIL:
+    case CBrowserFormInputType::MONTH:
+    case CBrowserFormInputType::NUMBER:
+    case CBrowserFormInputType::PASSWORD_TEXT:
+    case CBrowserFormInputType::TEL:
+    case CBrowserFormInputType::TEXT:
+      return CBrowserFormControl::Type::LINE_EDIT;
+    default:
+      return CBrowserFormControl::Type::NONE;
+  }
+}
+
+std::string
+CBrowserFormInput::
+controlText() const
+{
+  switch (type_) {
+    case CBrowserFormInputType::BUTTON:
+      return (data_.value != "" ? data_.value : "Button");
+    case CBrowserFormInputType::RESET_BUTTON:
+      return (data_.value != "" ? data_.value : "Reset");
+    case CBrowserFormInputType::SUBMIT_BUTTON:
+      return (data_.value != "" ? data_.value : "Submit Query");
+    case CBrowserFormInputType::NUMBER:
+    case CBrowserFormInputType::TEXT:
+      return data_.value;
+    default:
+      return "";
+  }
+}
+
+QSize
+CBrowserFormInput::
+controlSizeHint() const
+{
+  if (widget_)
+    return widget_->sizeHint();
+
+  CBrowserFormControl::Type type = controlType();
+
+  if (type != CBrowserFormControl::Type::NONE)
+    return CBrowserFormControl::sizeHint(type, controlFont(), controlText());
+
+  // no windowless control so size from real widget
+  createWidget();
+
+  if (! widget_)
+    return QSize();
+
+  return widget_->sizeHint();
+}
+
+QFont
+CBrowserFormInput::
+controlFont() const
+{
+  return CQUtil::toQFont(window_->getFont());
+}
+
+std::string
+CBrowserFormInput::
+lineEditText(const std::string &initText) const
+{
+  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
+
+  // inactive control still has the text its widget would be created with
+  return (edit ? edit->text().toStdString() : initText);
+}
+
+bool
+CBrowserFormInput::
+inside(int x, int y) const
+{
+  if (widget_ || controlType() == CBrowserFormControl::Type::NONE)
+    return false;
+
+  return (x >= drawRegion_.x() && x < drawRegion_.x() + drawRegion_.width () &&
+          y >= drawRegion_.y() && y < drawRegion_.y() + drawRegion_.height());
+}
+
+void
+CBrowserFormInput::
+activate()
+{
+  if (widget_)
+    return;
+
+  createWidget();
+
+  if (! widget_)
+    return;
+
+  drawWidget(window_, drawRegion_);
+
+  widget_->show();
+  widget_->setFocus();
+
+  // pass on click which activated control
+  QAbstractButton *button = qobject_cast<QAbstractButton *>(widget_);
+
+  if (button)
+    button->click();
+}
+
 void
 CBrowserFormInput::
 onClickProc()
 {
+  window_->registerHtmlObjects();
+
   js()->interpString(getOnClick());
 }
 
@@ -676,6 +879,8 @@ void
 CBrowserFormInput::
 onChangeProc()
 {
+  window_->registerHtmlObjects();
+
   js()->interpString(getOnChange());
 }
 
@@ -686,6 +891,22 @@ createJObj(CJavaScript *js)
   return new CQJInput(js, iface(), CBrowserObject::iface());
 }
 
+size_t
+CBrowserFormInput::
+memUsage() const
+{
+  // approximate size of a widget including its Qt private data
+  static const size_t widgetBytes = 2048;
+
+  size_t bytes = CBrowserObject::memUsage() + sizeof(CBrowserFormInput) -
+                 sizeof(CBrowserObject) + value_.capacity();
+
+  if (widget_)
+    bytes += (widget_->findChildren<QWidget *>().size() + 1)*widgetBytes;
+
+  return bytes;
+}
+
 //---
 
 CBrowserFormButton::
@@ -739,24 +960,26 @@ void
 CBrowserFormButton::
 setLabel(const std::string &text)
 {
-  createWidget();
+  // label is painted from value until activated
+  data_.value = text;
+
+  QPushButton *button = qobject_cast<QPushButton *>(widget_);
 
-  qobject_cast<QPushButton *>(widget_)->setText(text.c_str());
+  if (button)
+    button->setText(text.c_str());
+
+  invalidateRegion();
 }
 
 CBrowserRegion
 CBrowserFormButton::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -780,6 +1003,8 @@ init()
 
   setObjectName(getName().c_str());
 
+  checked_ = data_.checked;
+
   CBrowserFormInput::init();
 }
 
@@ -803,25 +1028,64 @@ createWidget() const
   }
 }
 
+bool
+CBrowserFormCheckBox::
+isChecked() const
+{
+  QCheckBox *button = qobject_cast<QCheckBox *>(widget_);
+
+  return (button ? button->isChecked() : checked_);
+}
+
+void
+CBrowserFormCheckBox::
+setChecked(bool b)
+{
+  checked_ = b;
+
+  QCheckBox *button = qobject_cast<QCheckBox *>(widget_);
+
+  if (button)
+    button->setChecked(b);
+  else
+    window_->redraw();
+}
+
 CBrowserRegion
 CBrowserFormCheckBox::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
   return CBrowserRegion(width_, height_/2, height_/2);
 }
 
+void
+CBrowserFormCheckBox::
+reset()
+{
+  setChecked(data_.checked);
+}
+
+void
+CBrowserFormCheckBox::
+submit(std::string &text)
+{
+  // only checked boxes are submitted
+  if (! isChecked())
+    return;
+
+  text += getName();
+  text += "=";
+  text += (data_.value != "" ? data_.value : "on");
+}
+
 //---
 
 CBrowserFormImage::
@@ -988,15 +1252,11 @@ CBrowserRegion
 CBrowserFormTel::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1009,7 +1269,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText("");
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText("");
 }
 
 void
@@ -1017,13 +1279,9 @@ CBrowserFormTel::
 submit(std::string &text)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += lineEditText("");
 }
 
 //---
@@ -1069,15 +1327,11 @@ CBrowserRegion
 CBrowserFormMonth::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1090,7 +1344,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText("");
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText("");
 }
 
 void
@@ -1098,13 +1354,9 @@ CBrowserFormMonth::
 submit(std::string &text)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += lineEditText("");
 }
 
 //---
@@ -1150,15 +1402,11 @@ CBrowserRegion
 CBrowserFormDate::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1171,7 +1419,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText("");
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText("");
 }
 
 void
@@ -1179,13 +1429,9 @@ CBrowserFormDate::
 submit(std::string &url)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   url += getName();
   url += "=";
-  url += value.toStdString();
+  url += lineEditText("");
 }
 
 //---
@@ -1231,15 +1477,11 @@ CBrowserRegion
 CBrowserFormSearch::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1252,7 +1494,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText("");
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText("");
 }
 
 void
@@ -1260,13 +1504,9 @@ CBrowserFormSearch::
 submit(std::string &text)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += lineEditText("");
 }
 
 //---
@@ -1319,15 +1559,11 @@ CBrowserRegion
 CBrowserFormNumber::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1340,7 +1576,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText("");
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText("");
 }
 
 void
@@ -1348,13 +1586,9 @@ CBrowserFormNumber::
 submit(std::string &text)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += lineEditText(data_.value);
 }
 
 //---
@@ -1381,9 +1615,7 @@ std::string
 CBrowserFormEmail::
 text() const
 {
-  QLineEdit *edit = dynamic_cast<QLineEdit *>(widget_);
-
-  return (edit ? edit->text().toStdString() : "");
+  return lineEditText("");
 }
 
 void
@@ -1409,15 +1641,11 @@ CBrowserRegion
 CBrowserFormEmail::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1430,7 +1658,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText("");
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText("");
 }
 
 void
@@ -1438,13 +1668,9 @@ CBrowserFormEmail::
 submit(std::string &text)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += lineEditText("");
 }
 
 //---
@@ -1492,15 +1718,11 @@ CBrowserRegion
 CBrowserFormPassword::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1513,7 +1735,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText("");
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText("");
 }
 
 void
@@ -1521,13 +1745,9 @@ CBrowserFormPassword::
 submit(std::string &text)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += lineEditText("");
 }
 
 //---
@@ -1592,13 +1812,22 @@ init()
   CBrowserFormInput::init();
 }
 
+CBrowserFormControl::Type
+CBrowserFormText::
+controlType() const
+{
+  // color edit is always a widget
+  if (classStr_ == "color")
+    return CBrowserFormControl::Type::NONE;
+
+  return CBrowserFormInput::controlType();
+}
+
 std::string
 CBrowserFormText::
 text() const
 {
-  QLineEdit *edit = dynamic_cast<QLineEdit *>(widget_);
-
-  return (edit ? edit->text().toStdString() : "");
+  return lineEditText(data_.value);
 }
 
 void
@@ -1647,15 +1876,11 @@ CBrowserRegion
 CBrowserFormText::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1667,13 +1892,9 @@ CBrowserFormText::
 submit(std::string &text)
 {
   // add submit value to url
-  QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
-
-  QString value = edit->text();
-
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += lineEditText(data_.value);
 }
 
 void
@@ -1682,7 +1903,9 @@ reset()
 {
   QLineEdit *edit = qobject_cast<QLineEdit *>(widget_);
 
-  edit->setText(data_.value.c_str());
+  // inactive control still has its initial value
+  if (edit)
+    edit->setText(data_.value.c_str());
 }
 
 //---
@@ -1750,7 +1973,8 @@ initLayout()
 {
   CBrowserForm *form = parentType<CBrowserForm>();
 
-  if (form)
+  // may be re-run by incremental layout
+  if (form && ! form->hasInput(this))
     form->addInput(this);
 }
 
@@ -1786,15 +2010,11 @@ CBrowserRegion
 CBrowserFormTextarea::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -1805,14 +2025,23 @@ void
 CBrowserFormTextarea::
 submit(std::string &text)
 {
-  // add submit value to url
+  // add submit value to url (inactive control still has initial text)
   QTextEdit *edit = qobject_cast<QTextEdit *>(widget_);
 
-  QString value = edit->toPlainText();
+  std::string value;
+
+  if (edit)
+    value = edit->toPlainText().toStdString();
+  else {
+    value = this->text();
+
+    if (value == "")
+      value = data_.value;
+  }
 
   text += getName();
   text += "=";
-  text += value.toStdString();
+  text += value;
 }
 
 void
@@ -1821,6 +2050,10 @@ reset()
 {
   QTextEdit *edit = qobject_cast<QTextEdit *>(widget_);
 
+  // inactive control still has its initial text
+  if (! edit)
+    return;
+
   std::string text = this->text();
 
   if (text == "")
@@ -1875,15 +2108,11 @@ CBrowserRegion
 CBrowserFormReset::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -2044,15 +2273,11 @@ CBrowserRegion
 CBrowserFormSelect::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -2108,15 +2333,11 @@ CBrowserRegion
 CBrowserFormSubmit::
 calcRegion() const
 {
-  createWidget();
+  QSize size = controlSizeHint();
 
-  if (! widget_)
+  if (! size.isValid())
     return CBrowserRegion();
 
-  //---
-
-  QSize size = widget_->sizeHint();
-
   width_  = size.width () + 4;
   height_ = size.height() + 4;
 
@@ -3,10 +3,12 @@
 
 #include <CBrowserObject.h>
 #include <CBrowserData.h>
+#include <CBrowserFormControl.h>
 #include <CQJFormIFace.h>
 #include <CQJFormInputIFace.h>
 #include <CImageLib.h>
 #include <QWidget>
+#include <algorithm>
 
 class CBrowserForm : public QObject, public CBrowserObject {
   Q_OBJECT
@@ -43,6 +45,9 @@ class CBrowserForm : public QObject, public CBrowserObject {
 
   const FormInputs &inputs() const { return inputs_; }
   void addInput(CBrowserFormInput *input) { inputs_.push_back(input); }
+  bool hasInput(CBrowserFormInput *input) const {
+    return std::find(inputs_.begin(), inputs_.end(), input) != inputs_.end();
+  }
   int getNumInputs() const { return inputs_.size(); }
   CBrowserFormInput *getInput(int i) const { return inputs_[i]; }
 
@@ -124,7 +129,7 @@ class CBrowserFormInput : public QObject, public CBrowserObject {
   bool getNameValue(const std::string &name, std::string &value) const;
 
   std::string getValue() const { return data_.value; }
-  void setValue(const std::string &value) { data_.value = value; }
+  void setValue(const std::string &value) { data_.value = value; invalidateRegion(); }
 
   std::string getOnBlur  () const { return data_.onblur  ; }
   std::string getOnClick () const { return data_.onclick ; }
@@ -136,8 +141,31 @@ class CBrowserFormInput : public QObject, public CBrowserObject {
   int getWidth () const { return width_ ; }
   int getHeight() const { return height_; }
 
+  // cached calcRegion
+  CBrowserRegion region() const;
+
+  // force recalc of cached region when control text changes
+  void invalidateRegion() { regionFontSize_ = -1; }
+
   virtual void createWidget() const = 0;
 
+  //---
+
+  // inputs with a control type are painted without a widget until activated
+  virtual CBrowserFormControl::Type controlType() const;
+
+  virtual std::string controlText() const;
+
+  virtual bool isControlChecked() const { return false; }
+
+  bool isActive() const { return widget_; }
+
+  bool inside(int x, int y) const;
+
+  void activate();
+
+  //---
+
   virtual void drawWidget(CBrowserWindow *window, const CTextBox &);
 
   virtual void reset() { };
@@ -158,19 +186,31 @@ class CBrowserFormInput : public QObject, public CBrowserObject {
 
   void print(std::ostream &os) const override { os << "input"; }
 
+  size_t memUsage() const override;
+
+ protected:
+  QSize controlSizeHint() const;
+
+  QFont controlFont() const;
+
+  std::string lineEditText(const std::string &initText) const;
+
  public slots:
   void onClickProc ();
   void onChangeProc();
 
  protected:
-  CBrowserFormInputType type_ { CBrowserFormInputType::NONE };
-  CBrowserFormInputData data_;
-  IFace                 iface_;
-  CBrowserForm*         form_ { nullptr };
-  std::string           value_;
-  mutable QWidget*      widget_ { nullptr };
-  mutable int           width_ { 0 };
-  mutable int           height_ { 0 };
+  CBrowserFormInputType  type_ { CBrowserFormInputType::NONE };
+  CBrowserFormInputData  data_;
+  IFace                  iface_;
+  CBrowserForm*          form_ { nullptr };
+  std::string            value_;
+  mutable QWidget*       widget_ { nullptr };
+  mutable int            width_ { 0 };
+  mutable int            height_ { 0 };
+  mutable CTextBox       drawRegion_;
+  mutable CBrowserRegion region_;
+  mutable int            regionFontSize_ { -1 };
 };
 
 //------
@@ -207,8 +247,17 @@ class CBrowserFormCheckBox : public CBrowserFormInput {
 
   void createWidget() const;
 
+  bool isControlChecked() const override { return checked_; }
+
+  bool isChecked() const;
+  void setChecked(bool b);
+
   CBrowserRegion calcRegion() const override;
 
+  void reset();
+
+  void submit(std::string &url);
+
  protected:
   int checked_ { 0 };
 };
@@ -456,8 +505,16 @@ class CBrowserFormRadio : public CBrowserFormInput {
 
   void createWidget() const;
 
+  bool isControlChecked() const override { return checked_; }
+
+  void setChecked(bool b);
+
   CBrowserRegion calcRegion() const override;
 
+  void reset();
+
+  void submit(std::string &url);
+
  public slots:
   void buttonProc();
 
@@ -574,6 +631,8 @@ class CBrowserFormText : public CBrowserFormInput {
 
   void createWidget() const;
 
+  CBrowserFormControl::Type controlType() const override;
+
   CBrowserRegion calcRegion() const override;
 
   void reset();
@@ -0,0 +1,174 @@
+#include <CBrowserFormControl.h>
+
+#include <QApplication>
+#include <QStyle>
+#include <QStyleOption>
+#include <QPainter>
+#include <map>
+
+namespace {
+
+std::string controlKey(CBrowserFormControl::Type type, const QFont &font,
+                       const std::string &text) {
+  return std::to_string(int(type)) + "|" + font.toString().toStdString() + "|" + text;
+}
+
+}
+
+//---
+
+QSize
+CBrowserFormControl::
+sizeHint(Type type, const QFont &font, const std::string &text)
+{
+  typedef std::map<std::string, QSize> SizeMap;
+
+  static SizeMap sizeMap;
+
+  std::string key = controlKey(type, font, text);
+
+  auto p = sizeMap.find(key);
+
+  if (p == sizeMap.end())
+    p = sizeMap.insert(p, SizeMap::value_type(key, calcSizeHint(type, font, text)));
+
+  return (*p).second;
+}
+
+QImage
+CBrowserFormControl::
+image(Type type, const QFont &font, const std::string &text, bool checked, const QSize &size)
+{
+  typedef std::map<std::string, QImage> ImageMap;
+
+  static ImageMap imageMap;
+
+  std::string key = controlKey(type, font, text) + "|" + (checked ? "1" : "0") + "|" +
+                    std::to_string(size.width()) + "x" + std::to_string(size.height());
+
+  auto p = imageMap.find(key);
+
+  if (p == imageMap.end()) {
+    // keep cache small (many distinct values are unlikely)
+    if (imageMap.size() > 256)
+      imageMap.clear();
+
+    p = imageMap.insert(imageMap.end(),
+          ImageMap::value_type(key, drawImage(type, font, text, checked, size)));
+  }
+
+  return (*p).second;
+}
+
+QSize
+CBrowserFormControl::
+calcSizeHint(Type type, const QFont &font, const std::string &text)
+{
+  QStyle *style = QApplication::style();
+
+  QFontMetrics fm(font);
+
+  QString qtext(text.c_str());
+
+  if      (type == Type::BUTTON) {
+    QStyleOptionButton opt;
+
+    opt.fontMetrics = fm;
+    opt.text        = qtext;
+
+    QSize s = fm.size(Qt::TextShowMnemonic, qtext.isEmpty() ? QString("XXXX") : qtext);
+
+    return style->sizeFromContents(QStyle::CT_PushButton, &opt, s).
+             expandedTo(QApplication::globalStrut());
+  }
+  else if (type == Type::CHECK_BOX || type == Type::RADIO) {
+    bool radio = (type == Type::RADIO);
+
+    QStyleOptionButton opt;
+
+    opt.fontMetrics = fm;
+
+    int w = style->pixelMetric(radio ? QStyle::PM_ExclusiveIndicatorWidth :
+                                       QStyle::PM_IndicatorWidth , &opt);
+    int h = style->pixelMetric(radio ? QStyle::PM_ExclusiveIndicatorHeight :
+                                       QStyle::PM_IndicatorHeight, &opt);
+
+    return style->sizeFromContents(radio ? QStyle::CT_RadioButton : QStyle::CT_CheckBox,
+                                   &opt, QSize(w, h)).expandedTo(QApplication::globalStrut());
+  }
+  else if (type == Type::LINE_EDIT) {
+    // match QLineEdit::sizeHint (17 chars wide)
+    QStyleOptionFrame opt;
+
+    opt.fontMetrics = fm;
+    opt.lineWidth   = style->pixelMetric(QStyle::PM_DefaultFrameWidth, &opt);
+
+    int h = qMax(fm.height(), 14) + 2;
+    int w = fm.width(QLatin1Char('x'))*17 + 4;
+
+    return style->sizeFromContents(QStyle::CT_LineEdit, &opt, QSize(w, h)).
+             expandedTo(QApplication::globalStrut());
+  }
+
+  return QSize();
+}
+
+QImage
+CBrowserFormControl::
+drawImage(Type type, const QFont &font, const std::string &text, bool checked,
+          const QSize &size)
+{
+  QImage image(size, QImage::Format_ARGB32_Premultiplied);
+
+  image.fill(Qt::transparent);
+
+  QStyle *style = QApplication::style();
+
+  QPainter painter(&image);
+
+  painter.setFont(font);
+
+  QRect rect(QPoint(0, 0), size);
+
+  if      (type == Type::BUTTON) {
+    QStyleOptionButton opt;
+
+    opt.rect        = rect;
+    opt.fontMetrics = QFontMetrics(font);
+    opt.palette     = QApplication::palette();
+    opt.state       = QStyle::State_Enabled | QStyle::State_Raised;
+    opt.text        = text.c_str();
+
+    style->drawControl(QStyle::CE_PushButton, &opt, &painter);
+  }
+  else if (type == Type::CHECK_BOX || type == Type::RADIO) {
+    QStyleOptionButton opt;
+
+    opt.rect        = rect;
+    opt.fontMetrics = QFontMetrics(font);
+    opt.palette     = QApplication::palette();
+    opt.state       = QStyle::State_Enabled | (checked ? QStyle::State_On : QStyle::State_Off);
+
+    style->drawControl(type == Type::RADIO ? QStyle::CE_RadioButton : QStyle::CE_CheckBox,
+                       &opt, &painter);
+  }
+  else if (type == Type::LINE_EDIT) {
+    QStyleOptionFrame opt;
+
+    opt.rect        = rect;
+    opt.fontMetrics = QFontMetrics(font);
+    opt.palette     = QApplication::palette();
+    opt.state       = QStyle::State_Enabled | QStyle::State_Sunken;
+    opt.lineWidth   = style->pixelMetric(QStyle::PM_DefaultFrameWidth, &opt);
+
+    style->drawPrimitive(QStyle::PE_PanelLineEdit, &opt, &painter);
+
+    QRect textRect = style->subElementRect(QStyle::SE_LineEditContents, &opt).adjusted(2, 0, -2, 0);
+
+    painter.setPen(opt.palette.color(QPalette::Text));
+
+    painter.drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, text.c_str());
+  }
+
+  return image;
+}
@@ -0,0 +1,35 @@
+#ifndef CBrowserFormControl_H
+#define CBrowserFormControl_H
+
+#include <QImage>
+#include <QFont>
+#include <QSize>
+#include <string>
+
+// paint form controls using QStyle primitives so inactive inputs do not need a widget
+class CBrowserFormControl {
+ public:
+  enum class Type {
+    NONE,
+    BUTTON,
+    CHECK_BOX,
+    RADIO,
+    LINE_EDIT
+  };
+
+ public:
+  // size hint for control (cached by type, font and text)
+  static QSize sizeHint(Type type, const QFont &font, const std::string &text);
+
+  // image of control at specified size (cached by type, font, text, state and size)
+  static QImage image(Type type, const QFont &font, const std::string &text,
+                      bool checked, const QSize &size);
+
+ private:
+  static QSize calcSizeHint(Type type, const QFont &font, const std::string &text);
+
+  static QImage drawImage(Type type, const QFont &font, const std::string &text,
+                          bool checked, const QSize &size);
+};
+
+#endif
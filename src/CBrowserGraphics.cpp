@@ -59,6 +59,8 @@ setXDevice()
 {
   current_device_ = CBrowserDeviceType::X;
 
+  renderer_->setImage(nullptr);
+
   if (print_device_) {
     print_device_->term();
 
@@ -70,18 +72,62 @@ setXDevice()
 
 void
 CBrowserGraphics::
-setPSDevice(double xmin, double ymin, double xmax, double ymax)
+setPSDevice(double xmin, double ymin, double xmax, double ymax, const std::string &filename)
 {
   current_device_ = CBrowserDeviceType::PS;
   print_device_   = new CPrint();
 
-  print_device_->setFilename("/tmp/ps.out");
+  print_device_->setFilename(filename);
 
   print_device_->setSize(xmin, ymin, xmax, ymax);
 
   print_device_->init();
 }
 
+void
+CBrowserGraphics::
+setPSPageDevice(const std::string &filename, int pageWidth, int pageHeight,
+                int paperWidth, int paperHeight)
+{
+  setXDevice();
+
+  current_device_ = CBrowserDeviceType::PS;
+  print_device_   = new CPrint();
+
+  print_device_->setFilename(filename);
+
+  print_device_->setPageSize (pageWidth , pageHeight );
+  print_device_->setPaperSize(paperWidth, paperHeight);
+
+  print_device_->init();
+}
+
+void
+CBrowserGraphics::
+startPSPage(int pageNum)
+{
+  if (print_device_)
+    print_device_->startPage(pageNum, pageNum);
+}
+
+// write completed page to file (so output is not held in memory)
+void
+CBrowserGraphics::
+endPSPage()
+{
+  if (print_device_)
+    print_device_->flush();
+}
+
+void
+CBrowserGraphics::
+setImageDevice(QImage *image)
+{
+  setXDevice();
+
+  renderer_->setImage(image);
+}
+
 void
 CBrowserGraphics::
 clear(const CRGBA &bg)
@@ -29,7 +29,16 @@ class CBrowserGraphics {
   QPixmap *pixmap() const { return renderer_->pixmap(); }
 
   void setXDevice();
-  void setPSDevice(double xmin, double ymin, double xmax, double ymax);
+  void setPSDevice(double xmin, double ymin, double xmax, double ymax,
+                   const std::string &filename="/tmp/ps.out");
+  void setImageDevice(QImage *image);
+
+  // paginated postscript output (page width x height document units on each paper page)
+  void setPSPageDevice(const std::string &filename, int pageWidth, int pageHeight,
+                       int paperWidth, int paperHeight);
+
+  void startPSPage(int pageNum);
+  void endPSPage();
 
   void clear(const CRGBA &bg);
 
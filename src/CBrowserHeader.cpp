@@ -25,12 +25,12 @@ CBrowserHeader(CBrowserWindow *window, CHtmlTagId id) :
 
   ind_ = idToInd(id);
 
-  if      (id == CHtmlTagId::H1) font_.setSize(window_->sizeToFontSize(6));
-  else if (id == CHtmlTagId::H2) font_.setSize(window_->sizeToFontSize(5));
-  else if (id == CHtmlTagId::H3) font_.setSize(window_->sizeToFontSize(4));
-  else if (id == CHtmlTagId::H4) font_.setSize(window_->sizeToFontSize(3));
-  else if (id == CHtmlTagId::H5) font_.setSize(window_->sizeToFontSize(2));
-  else if (id == CHtmlTagId::H6) font_.setSize(window_->sizeToFontSize(1));
+  if      (id == CHtmlTagId::H1) fontRef().setSize(window_->sizeToFontSize(6));
+  else if (id == CHtmlTagId::H2) fontRef().setSize(window_->sizeToFontSize(5));
+  else if (id == CHtmlTagId::H3) fontRef().setSize(window_->sizeToFontSize(4));
+  else if (id == CHtmlTagId::H4) fontRef().setSize(window_->sizeToFontSize(3));
+  else if (id == CHtmlTagId::H5) fontRef().setSize(window_->sizeToFontSize(2));
+  else if (id == CHtmlTagId::H6) fontRef().setSize(window_->sizeToFontSize(1));
 
   if      (id == CHtmlTagId::H1) marginRef().setTop(CBrowserUnitValue("0.67em"));
   else if (id == CHtmlTagId::H2) marginRef().setTop(CBrowserUnitValue("0.75em"));
@@ -46,7 +46,7 @@ CBrowserHeader(CBrowserWindow *window, CHtmlTagId id) :
   else if (id == CHtmlTagId::H5) marginRef().setBottom(CBrowserUnitValue("1.12em"));
   else if (id == CHtmlTagId::H6) marginRef().setBottom(CBrowserUnitValue("1.12em"));
 
-  font_.setBold();
+  fontRef().setBold();
 }
 
 CBrowserHeader::
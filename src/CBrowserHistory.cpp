@@ -29,6 +29,8 @@ addUrl(const CUrl &url)
 
   urls_.push_back(url);
 
+  url_num_ = urls_.size();
+
   window_->addHistoryItem(url);
 }
 
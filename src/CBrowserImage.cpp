@@ -106,17 +106,17 @@ setNameValue(const std::string &name, const std::string &value)
     else if (lvalue == "right")
       float_ = CBrowserFloat(CBrowserFloat::Type::RIGHT);
     else if (lvalue == "top")
-      textProp_.setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::TOP));
+      textPropRef().setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::TOP));
     else if (lvalue == "middle")
-      textProp_.setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::MIDDLE));
+      textPropRef().setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::MIDDLE));
     else if (lvalue == "bottom")
-      textProp_.setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::BOTTOM));
+      textPropRef().setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::BOTTOM));
     else if (lvalue == "texttop")
-      textProp_.setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::TEXT_TOP));
+      textPropRef().setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::TEXT_TOP));
     else if (lvalue == "absmiddle")
-      textProp_.setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::ABS_MIDDLE));
+      textPropRef().setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::ABS_MIDDLE));
     else if (lvalue == "absbottom")
-      textProp_.setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::ABS_BOTTOM));
+      textPropRef().setVerticalAlign(CBrowserTextVAlign(CBrowserTextVAlign::ABS_BOTTOM));
     else
       window_->displayError("Illegal 'img' Align '%s'\n", value.c_str());
   }
@@ -233,7 +233,7 @@ calcRegion() const
   int width  = image_->getWidth () + 2*hspace;
   int height = image_->getHeight() + 2*vspace;
 
-  CBrowserTextVAlign::Type valign = textProp_.verticalAlign().type();
+  CBrowserTextVAlign::Type valign = textProp().verticalAlign().type();
 
   if      (valign == CBrowserTextVAlign::Type::TOP ||
            valign == CBrowserTextVAlign::Type::TEXT_TOP)
@@ -257,7 +257,7 @@ draw(const CTextBox &region)
   int x1 = region.x() + hspace;
   int y1 = region.y() + vspace;
 
-  CBrowserTextVAlign::Type valign = textProp_.verticalAlign().type();
+  CBrowserTextVAlign::Type valign = textProp().verticalAlign().type();
 
   if      (valign == CBrowserTextVAlign::Type::TOP)
     y1 += region.ascent();
@@ -300,3 +300,16 @@ createJObj(CJavaScript *js)
 {
   return new CQJImageObj(js, iface(), CBrowserObject::iface());
 }
+
+size_t
+CBrowserImage::
+memUsage() const
+{
+  size_t bytes = CBrowserObject::memUsage() + sizeof(CBrowserImage) - sizeof(CBrowserObject);
+
+  // pixel data (32 bit)
+  if (image_.isValid())
+    bytes += size_t(image_->getWidth())*image_->getHeight()*4;
+
+  return bytes;
+}
@@ -44,6 +44,8 @@ class CBrowserImage : public CBrowserObject {
 
   CQJHtmlObj *createJObj(CJavaScript *js) override;
 
+  size_t memUsage() const override;
+
  private:
   IFace               iface_;
   CImagePtr           image_;
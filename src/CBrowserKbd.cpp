@@ -5,5 +5,5 @@ CBrowserKbd::
 CBrowserKbd(CBrowserWindow *window) :
  CBrowserObject(window, CHtmlTagId::KBD)
 {
-  font_.setFamily(CBrowserFontFamily("monospace"));
+  fontRef().setFamily(CBrowserFontFamily("monospace"));
 }
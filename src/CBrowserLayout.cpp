@@ -21,6 +21,8 @@ startBox(CBrowserBox *box)
 
   boxes_.push_back(box);
 
+  box->setInLayout(true);
+
   if (parent) {
     box->setParent(parent);
 
@@ -28,6 +30,15 @@ startBox(CBrowserBox *box)
   }
 }
 
+void
+CBrowserLayout::
+enterBox(CBrowserBox *box)
+{
+  assert(box->isInLayout());
+
+  boxes_.push_back(box);
+}
+
 void
 CBrowserLayout::
 endBox(CBrowserBox *box)
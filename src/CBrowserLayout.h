@@ -14,6 +14,9 @@ class CBrowserLayout {
   void startBox(CBrowserBox *box);
   void endBox  (CBrowserBox *box);
 
+  // make box already in layout tree current (to add new children)
+  void enterBox(CBrowserBox *box);
+
   CBrowserBox *currentBox() const;
 
   void layout(CBrowserBox *root, const CIBBox2D &bbox);
@@ -272,7 +272,7 @@ CBrowserAnchor(CBrowserWindow *window) :
 
   setForeground(CBrowserColor(window_->getDocument()->getLinkColor()));
 
-  textProp_.setDecoration(CBrowserTextDecoration("underline"));
+  textPropRef().setDecoration(CBrowserTextDecoration("underline"));
 
   // cursor: auto
 }
@@ -4,6 +4,7 @@
 #include <CBrowserScrolledWindow.h>
 
 #include <CQApp.h>
+#include <CStrUtil.h>
 
 CBrowserMain *
 CBrowserMain::
@@ -49,6 +50,43 @@ setOldLayout(bool b)
   oldLayout_ = b;
 }
 
+bool
+CBrowserMain::
+setPaperSize(const std::string &name)
+{
+  std::string lname = CStrUtil::toLower(name);
+
+  int width = 0, height = 0;
+
+  if      (lname == "a4"    ) { width = 595; height =  842; }
+  else if (lname == "a3"    ) { width = 842; height = 1191; }
+  else if (lname == "letter") { width = 612; height =  792; }
+  else if (lname == "legal" ) { width = 612; height = 1008; }
+  else {
+    auto pos = lname.find('x');
+
+    if (pos == std::string::npos)
+      return false;
+
+    std::string wstr = lname.substr(0, pos);
+    std::string hstr = lname.substr(pos + 1);
+
+    if (! CStrUtil::isInteger(wstr) || ! CStrUtil::isInteger(hstr))
+      return false;
+
+    width  = CStrUtil::toInteger(wstr);
+    height = CStrUtil::toInteger(hstr);
+  }
+
+  if (width <= 0 || height <= 0)
+    return false;
+
+  paperWidth_  = width;
+  paperHeight_ = height;
+
+  return true;
+}
+
 void
 CBrowserMain::
 setShowBoxes(bool b)
@@ -69,11 +107,11 @@ setDocument(const CUrl &url)
 
 void
 CBrowserMain::
-addDocument(const CUrl &url)
+addDocument(const CUrl &url, bool background)
 {
   CBrowserMainWindow *iface = this->iface();
 
-  iface->addDocument(url);
+  iface->addDocument(url, background);
 
   iface_->show();
 }
@@ -29,6 +29,26 @@ class CBrowserMain : public QObject {
   bool getDebug() const { return debug_; }
   void setDebug(bool b);
 
+  bool getBatch() const { return batch_; }
+  void setBatch(bool b) { batch_ = b; }
+
+  bool getIncremental() const { return incremental_; }
+  void setIncremental(bool b) { incremental_ = b; }
+
+  // number of built documents kept for back/forward (0 to disable)
+  int getDocCacheSize() const { return docCacheSize_; }
+  void setDocCacheSize(int i) { docCacheSize_ = i; }
+
+  // postscript print output file and paper size (points)
+  const std::string &getPrintFile() const { return printFile_; }
+  void setPrintFile(const std::string &s) { printFile_ = s; }
+
+  int getPaperWidth () const { return paperWidth_ ; }
+  int getPaperHeight() const { return paperHeight_; }
+
+  // set paper size from name (a4, letter, legal) or <width>x<height> in points
+  bool setPaperSize(const std::string &name);
+
   bool getQuiet() const { return quiet_; }
   void setQuiet(bool b) { quiet_ = b; }
 
@@ -45,7 +65,7 @@ class CBrowserMain : public QObject {
   void setMouseOver(bool b) { mouseOver_ = b; }
 
   void setDocument(const CUrl &url);
-  void addDocument(const CUrl &url);
+  void addDocument(const CUrl &url, bool background=false);
 
  private:
   CBrowserMain();
@@ -56,6 +76,12 @@ class CBrowserMain : public QObject {
  private:
   CBrowserMainWindow* iface_ { nullptr };
   bool                debug_ { false };
+  bool                batch_ { false };
+  bool                incremental_ { false };
+  int                 docCacheSize_ { 4 };
+  std::string         printFile_ { "/tmp/ps.out" };
+  int                 paperWidth_ { 595 };
+  int                 paperHeight_ { 842 };
   bool                quiet_ { false };
   bool                useAlt_ { false };
   bool                oldLayout_ { false };
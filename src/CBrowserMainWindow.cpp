@@ -27,6 +27,7 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QStatusBar>
+#include <iostream>
 
 #include <svg/dom_svg.h>
 #include <svg/css_svg.h>
@@ -77,6 +78,7 @@ createCentralWidget()
   tab_->setObjectName("tab");
   tab_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
+  connect(tab_, SIGNAL(currentChanged(int)), this, SLOT(currentTabSlot(int)));
   connect(tab_, SIGNAL(currentChanged(int)), this, SLOT(updateTitles()));
 
   layout->addWidget(tab_);
@@ -90,15 +92,16 @@ createCentralWidget()
 
 CBrowserScrolledWindow *
 CBrowserMainWindow::
-addWindow()
+addWindow(bool current)
 {
   CBrowserScrolledWindow *window = new CBrowserScrolledWindow(this);
 
-  tab_->addTab(window, "");
+  windows_.push_back(window);
 
-  tab_->setCurrentIndex(tab_->count() - 1);
+  tab_->addTab(window, "");
 
-  windows_.push_back(window);
+  if (current)
+    tab_->setCurrentIndex(tab_->count() - 1);
 
   return window;
 }
@@ -280,6 +283,17 @@ updateTitles()
   }
 }
 
+// build deferred document of tab when first shown
+void
+CBrowserMainWindow::
+currentTabSlot(int ind)
+{
+  if (ind < 0 || ind >= int(windows_.size()))
+    return;
+
+  windows_[ind]->showDeferredDocument();
+}
+
 void
 CBrowserMainWindow::
 setStatus(const std::string &status)
@@ -294,6 +308,12 @@ void
 CBrowserMainWindow::
 errorDialog(const std::string &msg)
 {
+  // no dialogs when rendering offscreen
+  if (CBrowserMainInst->getBatch()) {
+    std::cerr << "Error: " << msg << std::endl;
+    return;
+  }
+
   QMessageBox::warning(this, "Error", msg.c_str());
 }
 
@@ -357,11 +377,14 @@ readProc()
 
 void
 CBrowserMainWindow::
-addDocument(const CUrl &url)
+addDocument(const CUrl &url, bool background)
 {
-  CBrowserScrolledWindow *window = addWindow();
+  CBrowserScrolledWindow *window = addWindow(! background);
 
-  window->setDocument(url);
+  if (background)
+    window->setDocumentDeferred(url);
+  else
+    window->setDocument(url);
 
   updateTitles();
 }
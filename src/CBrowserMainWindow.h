@@ -26,7 +26,7 @@ class CBrowserMainWindow : public CQMainWindow {
 
   void init();
 
-  CBrowserScrolledWindow *addWindow();
+  CBrowserScrolledWindow *addWindow(bool current=true);
 
   CBrowserScrolledWindow *currentWindow() const;
 
@@ -35,7 +35,8 @@ class CBrowserMainWindow : public CQMainWindow {
 
   void addHistoryItem(const CUrl &url);
 
-  void addDocument(const CUrl &url);
+  // add document in new tab (background tab is read in background and built when shown)
+  void addDocument(const CUrl &url, bool background=false);
   void setDocument(const CUrl &url);
 
   void saveImage(const std::string &filename);
@@ -61,6 +62,8 @@ class CBrowserMainWindow : public CQMainWindow {
 
   void updateTitles();
 
+  void currentTabSlot(int ind);
+
   void newProc();
   void readProc();
   void printProc();
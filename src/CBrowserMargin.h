@@ -23,6 +23,25 @@ class CBrowserMargin {
   const CBrowserUnitValue &top() const { return top_; }
   void setTop(const CBrowserUnitValue &v) { top_ = v; }
 
+  // equality and hash for style group interning
+  bool operator==(const CBrowserMargin &v) const {
+    return (left_ == v.left_ &&
+            bottom_ == v.bottom_ &&
+            right_ == v.right_ &&
+            top_ == v.top_);
+  }
+
+  size_t hash() const {
+    size_t h = 0;
+
+    h = h*31 + left_.hash();
+    h = h*31 + bottom_.hash();
+    h = h*31 + right_.hash();
+    h = h*31 + top_.hash();
+
+    return h;
+  }
+
  private:
   CBrowserUnitValue left_;
   CBrowserUnitValue bottom_;
@@ -3,6 +3,7 @@
 #include <CBrowserList.h>
 #include <CBrowserListItem.h>
 #include <CBrowserProperty.h>
+#include <CQJavaScript.h>
 #include <CQJHtmlObj.h>
 #include <CHtmlTagDef.h>
 #include <CLinearGradient.h>
@@ -54,6 +55,12 @@ CQJHtmlObj *
 CBrowserObject::
 getJObj() const
 {
+  if (! htmlObj_) {
+    CBrowserObject *th = const_cast<CBrowserObject *>(this);
+
+    window_->addHtmlObject(th);
+  }
+
   return htmlObj_;
 }
 
@@ -62,20 +69,37 @@ CBrowserObject::
 setJObj(CQJHtmlObj *obj)
 {
   htmlObj_ = obj;
+
+  htmlValue_ = CJValueP(htmlObj_); // first create of shared pointer
+}
+
+void
+CBrowserObject::
+releaseJObj()
+{
+  if (! htmlObj_)
+    return;
+
+  CQJavaScriptInst->removeHtmlObject(htmlObj_);
+
+  htmlObj_   = nullptr;
+  htmlValue_ = CJValueP();
 }
 
 CJValueP
 CBrowserObject::
 getJObjValue() const
 {
-  return htmlObj_->shared_from_this();
+  (void) getJObj();
+
+  return htmlValue_;
 }
 
 CJavaScript *
 CBrowserObject::
 js() const
 {
-  return getJObj()->js();
+  return CQJavaScriptInst->js();
 }
 
 std::string
@@ -165,7 +189,7 @@ setNameValue(const std::string &name, const std::string &value)
   if      (lname == "accesskey") {
   }
   else if (lname == "bgcolor") {
-    background_.setColor(CBrowserColor(value));
+    backgroundRef().setColor(CBrowserColor(value));
   }
   else if (lname == "class") {
     setClass(value);
@@ -294,32 +318,32 @@ setStyleValue(const std::string &name, const std::string &value)
     setBackground(bg);
   }
   else if (lname == "background-attachment") {
-    background_.setAttachment(CBrowserBackgroundAttachment(value));
+    backgroundRef().setAttachment(CBrowserBackgroundAttachment(value));
   }
   else if (lname == "background-blend-mode") {
     window_->displayError("Unsupported style name '%s' value '%s'\n",
                           name.c_str(), value.c_str());
   }
   else if (lname == "background-clip") {
-    background_.setClip(CBrowserBackgroundClip(value));
+    backgroundRef().setClip(CBrowserBackgroundClip(value));
   }
   else if (lname == "background-color") {
-    background_.setColor(CBrowserColor(value));
+    backgroundRef().setColor(CBrowserColor(value));
   }
   else if (lname == "background-image") {
-    background_.setImage(CBrowserBackgroundImage(value));
+    backgroundRef().setImage(CBrowserBackgroundImage(value));
   }
   else if (lname == "background-origin") {
-    background_.setOrigin(CBrowserBackgroundOrigin(value));
+    backgroundRef().setOrigin(CBrowserBackgroundOrigin(value));
   }
   else if (lname == "background-position") {
-    background_.setPosition(CBrowserBackgroundPosition(value));
+    backgroundRef().setPosition(CBrowserBackgroundPosition(value));
   }
   else if (lname == "background-repeat") {
-    background_.setRepeat(CBrowserBackgroundRepeat(value));
+    backgroundRef().setRepeat(CBrowserBackgroundRepeat(value));
   }
   else if (lname == "background-size") {
-    background_.setSize(CBrowserBackgroundSize(value));
+    backgroundRef().setSize(CBrowserBackgroundSize(value));
   }
   else if (lname == "border") {
     std::vector<std::string> words;
@@ -746,24 +770,24 @@ setStyleValue(const std::string &name, const std::string &value)
                           name.c_str(), value.c_str());
   }
   else if (lname == "font-family") {
-    font_.setFamily(CBrowserFontFamily(value));
+    fontRef().setFamily(CBrowserFontFamily(value));
   }
   else if (lname == "font-size") {
-    font_.setSize(CBrowserFontSize(value));
+    fontRef().setSize(CBrowserFontSize(value));
   }
   else if (lname == "font-size-adjust") {
-    font_.setSizeAdjust(CBrowserFontSizeAdjust(value));
+    fontRef().setSizeAdjust(CBrowserFontSizeAdjust(value));
   }
   else if (lname == "font-stretch") {
-    font_.setStretch(CBrowserFontStretch(value));
+    fontRef().setStretch(CBrowserFontStretch(value));
   }
   else if (lname == "font-style") {
-    font_.setStyle(CBrowserFontStyle(value));
+    fontRef().setStyle(CBrowserFontStyle(value));
   }
   else if (lname == "font-variant") {
   }
   else if (lname == "font-weight") {
-    font_.setWeight(CBrowserFontWeight(value));
+    fontRef().setWeight(CBrowserFontWeight(value));
   }
   else if (lname == "@font-face") {
     window_->displayError("Unsupported style name '%s' value '%s'\n",
@@ -960,25 +984,25 @@ setStyleValue(const std::string &name, const std::string &value)
       CBrowserOutlineStyle style(words[1]);
       CBrowserOutlineWidth width(words[2]);
 
-      outline_.setColor(color);
-      outline_.setStyle(style);
-      outline_.setWidth(width);
+      outlineRef().setColor(color);
+      outlineRef().setStyle(style);
+      outlineRef().setWidth(width);
     }
     else if (words.size() == 1) {
       CBrowserColor color(value);
 
       if (color.isValid())
-        outline_.setColor(color);
+        outlineRef().setColor(color);
       else {
         CBrowserOutlineStyle style(value);
 
         if (style.isValid())
-          outline_.setStyle(style);
+          outlineRef().setStyle(style);
         else {
           CBrowserOutlineWidth width(value);
 
           if (width.isValid())
-            outline_.setWidth(width);
+            outlineRef().setWidth(width);
         }
       }
     }
@@ -990,7 +1014,7 @@ setStyleValue(const std::string &name, const std::string &value)
   else if (lname == "outline-color") {
     CBrowserColor color(value);
 
-    outline_.setColor(color);
+    outlineRef().setColor(color);
   }
   else if (lname == "outline-offset") {
     window_->displayError("Unsupported style name '%s' value '%s'\n",
@@ -999,12 +1023,12 @@ setStyleValue(const std::string &name, const std::string &value)
   else if (lname == "outline-style") {
     CBrowserOutlineStyle style(value);
 
-    outline_.setStyle(style);
+    outlineRef().setStyle(style);
   }
   else if (lname == "outline-width") {
     CBrowserOutlineWidth width(value);
 
-    outline_.setWidth(width);
+    outlineRef().setWidth(width);
   }
   else if (lname == "overflow") {
     overflow_ = CBrowserOverflow(value);
@@ -1123,14 +1147,14 @@ setStyleValue(const std::string &name, const std::string &value)
                           name.c_str(), value.c_str());
   }
   else if (lname == "text-align") {
-    textProp_.setAlign(CBrowserTextAlign(value));
+    textPropRef().setAlign(CBrowserTextAlign(value));
   }
   else if (lname == "text-align-last") {
     window_->displayError("Unsupported style name '%s' value '%s'\n",
                           name.c_str(), value.c_str());
   }
   else if (lname == "text-decoration") {
-    textProp_.setDecoration(CBrowserTextDecoration(value));
+    textPropRef().setDecoration(CBrowserTextDecoration(value));
   }
   else if (lname == "text-decoration-color") {
     window_->displayError("Unsupported style name '%s' value '%s'\n",
@@ -1157,7 +1181,7 @@ setStyleValue(const std::string &name, const std::string &value)
                           name.c_str(), value.c_str());
   }
   else if (lname == "text-shadow") {
-    textProp_.setShadow(CBrowserTextShadow(value));
+    textPropRef().setShadow(CBrowserTextShadow(value));
   }
   else if (lname == "text-transform") {
     window_->displayError("Unsupported style name '%s' value '%s'\n",
@@ -1211,7 +1235,7 @@ setStyleValue(const std::string &name, const std::string &value)
 
   //--- V ---
   else if (lname == "vertical-align") {
-    textProp_.setVerticalAlign(CBrowserTextVAlign(value));
+    textPropRef().setVerticalAlign(CBrowserTextVAlign(value));
   }
   else if (lname == "visibility") {
     //visible_ = true;
@@ -1422,7 +1446,7 @@ fillBackground(const CTextBox &region)
   int w = region.width();
   int h = region.height();
 
-  if      (background_.color().isValid()) {
+  if      (background().color().isValid()) {
     CBrush brush;
 
     if (background().color().type() == CBrowserColor::Type::COLOR) {
@@ -1808,16 +1832,25 @@ CFontPtr
 CBrowserObject::
 hierFont() const
 {
-  CBrowserObject *th = const_cast<CBrowserObject *>(this);
+  bool underline   = (textProp().decoration().type() ==
+                       CBrowserTextDecoration::Type::UNDERLINE);
+  bool strike      = (textProp().decoration().type() ==
+                       CBrowserTextDecoration::Type::LINE_THROUGH);
+  bool superscript = (textProp().verticalAlign().type() == CBrowserTextVAlign::Type::SUPER);
+  bool subscript   = (textProp().verticalAlign().type() == CBrowserTextVAlign::Type::SUB);
 
-  th->font_.setUnderline(textProp_.decoration().type() ==
-                          CBrowserTextDecoration::Type::UNDERLINE);
+  // only update (and so unshare) font if text properties change it
+  if (font().isUnderline() != underline || font().isStrike() != strike ||
+      font().isSuperscript() != superscript || font().isSubscript() != subscript) {
+    CBrowserObject *th = const_cast<CBrowserObject *>(this);
 
-  th->font_.setStrike(textProp_.decoration().type() ==
-                       CBrowserTextDecoration::Type::LINE_THROUGH);
+    CBrowserFont &font1 = th->fontRef();
 
-  th->font_.setSuperscript(textProp_.verticalAlign().type() == CBrowserTextVAlign::Type::SUPER);
-  th->font_.setSubscript(textProp_.verticalAlign().type() == CBrowserTextVAlign::Type::SUB);
+    font1.setUnderline  (underline);
+    font1.setStrike     (strike);
+    font1.setSuperscript(superscript);
+    font1.setSubscript  (subscript);
+  }
 
   return font().font(this);
 }
@@ -1834,3 +1867,40 @@ hierFgColor() const
 
   return window_->getFgColor();
 }
+
+size_t
+CBrowserObject::
+styleMemUsage() const
+{
+  return CBrowserBox::styleMemUsage() + background_.memUsage() + outline_.memUsage() +
+         shadow_.memUsage() + font_.memUsage() + textProp_.memUsage();
+}
+
+size_t
+CBrowserObject::
+unsharedStyleMemUsage() const
+{
+  return CBrowserBox::unsharedStyleMemUsage() + background_.unsharedMemUsage() +
+         outline_.unsharedMemUsage() + shadow_.unsharedMemUsage() +
+         font_.unsharedMemUsage() + textProp_.unsharedMemUsage();
+}
+
+size_t
+CBrowserObject::
+memUsage() const
+{
+  size_t bytes = sizeof(CBrowserObject) + styleMemUsage();
+
+  bytes += id_.capacity() + name_.capacity() + class_.capacity() + text_.capacity() +
+           title_.capacity();
+
+  for (const auto &c : classes_)
+    bytes += sizeof(c) + c.capacity();
+
+  for (const auto &p : properties_)
+    bytes += sizeof(p) + p.capacity();
+
+  bytes += children_.capacity()*sizeof(CBrowserObject *);
+
+  return bytes;
+}
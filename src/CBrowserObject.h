@@ -126,12 +126,15 @@ class CBrowserObject : public CBrowserBox {
 
   //---
 
-  // javascript interface
+  // javascript interface (wrapper is created on first access)
   virtual CQJHtmlObj *createJObj(CJavaScript *js);
 
   CQJHtmlObj *getJObj() const;
   void setJObj(CQJHtmlObj *obj);
 
+  // unregister wrapper before object is deleted
+  void releaseJObj();
+
   CJValueP getJObjValue() const;
 
   CJavaScript *js() const;
@@ -141,7 +144,7 @@ class CBrowserObject : public CBrowserBox {
   CBrowserObject *parent() const { return parent_; }
   void setParent(CBrowserObject *p) { parent_ = p; }
 
-  CQJHtmlObj *htmlObj() const { return htmlObj_; }
+  CQJHtmlObj *htmlObj() const { return getJObj(); }
 
   std::string typeName() const override;
   std::string hierTypeName() const;
@@ -151,6 +154,10 @@ class CBrowserObject : public CBrowserBox {
   const Children &children() const { return children_; }
   int numChildren() const { return children_.size(); }
   CBrowserObject *child(int i) const { return children_[i]; }
+
+  // number of children at last (incremental) layout
+  int numLayoutChildren() const { return numLayoutChildren_; }
+  void setNumLayoutChildren(int n) { numLayoutChildren_ = n; }
   int childIndex(const CBrowserObject *child) const;
 
   Display display() const;
@@ -159,9 +166,11 @@ class CBrowserObject : public CBrowserBox {
   WhiteSpace whiteSpace() const { return whiteSpace_; }
   void setWhiteSpace(const WhiteSpace &v) { whiteSpace_ = v; }
 
-  const CBrowserBackground &background() const { return background_; }
+  const CBrowserBackground &background() const { return *background_; }
   void setBackground(const CBrowserBackground &bg) { background_ = bg; }
 
+  CBrowserBackground &backgroundRef() { return background_.ref(); }
+
   const CBrowserColor &foreground() const { return foreground_; }
   void setForeground(const CBrowserColor &c) { foreground_ = c; }
 
@@ -177,9 +186,17 @@ class CBrowserObject : public CBrowserBox {
   const std::string &title() const { return title_; }
   void setTitle(const std::string &v) { title_ = v; }
 
-  const CBrowserFont &font() const { return font_; }
+  const CBrowserFont &font() const { return *font_; }
+
+  CBrowserFont &fontRef() { return font_.ref(); }
+
+  const CBrowserTextProp &textProp() const { return *textProp_; }
 
-  const CBrowserTextProp &textProp() const { return textProp_; }
+  CBrowserTextProp &textPropRef() { return textProp_.ref(); }
+
+  const CBrowserOutline &outline() const { return *outline_; }
+
+  CBrowserOutline &outlineRef() { return outline_.ref(); }
 
   virtual WhiteSpace hierWhiteSpace() const;
 
@@ -293,7 +310,19 @@ class CBrowserObject : public CBrowserBox {
 
   virtual void print(std::ostream &os) const { os << typeName(); }
 
+  size_t styleMemUsage() const override;
+  size_t unsharedStyleMemUsage() const override;
+
+  // approximate bytes of memory owned by object (excluding children)
+  virtual size_t memUsage() const;
+
  protected:
+  typedef CBrowserSharedStyle<CBrowserBackground> BackgroundP;
+  typedef CBrowserSharedStyle<CBrowserOutline>    OutlineP;
+  typedef CBrowserSharedStyle<CBrowserShadow>     ShadowP;
+  typedef CBrowserSharedStyle<CBrowserFont>       FontP;
+  typedef CBrowserSharedStyle<CBrowserTextProp>   TextPropP;
+
   CBrowserWindow*     window_ { nullptr };
   IFace               iface_;
   CHtmlTagId          type_;
@@ -305,12 +334,14 @@ class CBrowserObject : public CBrowserBox {
   Classes             classes_;
   std::string         text_;
   bool                selected_ { false };
-  CQJHtmlObj*         htmlObj_;
+  CQJHtmlObj*         htmlObj_ { nullptr };
+  CJValueP            htmlValue_;
   CBrowserObject*     parent_ { nullptr };
   Children            children_;
+  int                 numLayoutChildren_ { 0 };
   Display             display_ { Display::INVALID };
   WhiteSpace          whiteSpace_ { WhiteSpace::NORMAL };
-  CBrowserBackground  background_;
+  BackgroundP         background_;
   CBrowserColor       foreground_;
   CBrowserClear       clear_;
   CBrowserFloat       float_;
@@ -319,16 +350,16 @@ class CBrowserObject : public CBrowserBox {
   CBrowserUnitValue   maxHeight_;
   CBrowserUnitValue   minWidth_;
   CBrowserUnitValue   minHeight_;
-  CBrowserOutline     outline_;
+  OutlineP            outline_;
   CBrowserCursor      cursor_;
   CBrowserOverflow    overflow_;
-  CBrowserShadow      shadow_;
+  ShadowP             shadow_;
   CBrowserWordSpacing wordSpacing_;
   CBrowserBoxSizing   boxSizing_;
   int                 zIndex_ { -1 };
   std::string         title_;
-  CBrowserFont        font_;
-  CBrowserTextProp    textProp_;
+  FontP               font_;
+  TextPropP           textProp_;
   CBrowserSize        size_;
   Properties          properties_;
 };
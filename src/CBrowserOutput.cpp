@@ -49,6 +49,16 @@
 
 namespace {
 
+// check if string is empty or only spaces (same as stripSpaces(str) == "" without copy)
+bool isBlank(const std::string &str) {
+  for (const auto &c : str) {
+    if (! isspace((unsigned char) c))
+      return false;
+  }
+
+  return true;
+}
+
 bool isParagraphObj(CBrowserObject *obj) {
   if (! obj) return false;
 
@@ -244,23 +254,46 @@ void
 CBrowserOutput::
 processTokens(const CHtmlParserTokens &tokens)
 {
-  typedef std::vector<CHtmlTag *> TagStack;
+  beginTokens();
+
+  addTokens(tokens, 0, tokens.size());
 
-  TagStack tagStack;
+  endTokens();
+}
+
+void
+CBrowserOutput::
+beginTokens()
+{
+  tagStack_.clear();
 
   init();
+}
 
-  for (int i = 0; i < tokens.size(); ++i) {
+void
+CBrowserOutput::
+endTokens()
+{
+  term();
+
+  tagStack_.clear();
+}
+
+void
+CBrowserOutput::
+addTokens(const CHtmlParserTokens &tokens, int i1, int i2)
+{
+  for (int i = i1; i < i2; ++i) {
     const CHtmlToken *t = tokens[i];
 
     if      (t->isTag()) {
       CHtmlTag *tag = t->getTag();
 
       if      (tag->isStartTag())
-        tagStack.push_back(tag);
+        tagStack_.push_back(tag);
       else if (tag->isEndTag()) {
-        if (! tagStack.empty())
-          tagStack.pop_back();
+        if (! tagStack_.empty())
+          tagStack_.pop_back();
       }
 
       processTag(tag);
@@ -268,7 +301,7 @@ processTokens(const CHtmlParserTokens &tokens)
     else if (t->isText()) {
       CHtmlText *text = t->getText();
 
-      CHtmlTag *currentTag = (! tagStack.empty() ? tagStack.back() : nullptr);
+      CHtmlTag *currentTag = (! tagStack_.empty() ? tagStack_.back() : nullptr);
 
       if (currentTag &&
           (currentTag->getTagDef().getId() == CHtmlTagId::CANVAS ||
@@ -278,8 +311,6 @@ processTokens(const CHtmlParserTokens &tokens)
       processText(text);
     }
   }
-
-  term();
 }
 
 void
@@ -296,6 +327,30 @@ void
 CBrowserOutput::
 layoutObj(CBrowserObject *obj)
 {
+  // objects added by an earlier (incremental) layout only need their new children added,
+  // containers which gained children re-run their layout init/term
+  if (obj->isInLayout()) {
+    bool changed = (obj->numChildren() != obj->numLayoutChildren());
+
+    window_->getLayout()->enterBox(obj);
+
+    if (changed)
+      obj->initLayout();
+
+    for (const auto &c : obj->children())
+      layoutObj(c);
+
+    if (changed) {
+      obj->termLayout();
+
+      obj->setNumLayoutChildren(obj->numChildren());
+    }
+
+    window_->getLayout()->endBox(obj);
+
+    return;
+  }
+
   window_->getLayout()->startBox(obj);
 
   obj->initLayout();
@@ -305,6 +360,8 @@ layoutObj(CBrowserObject *obj)
 
   obj->termLayout();
 
+  obj->setNumLayoutChildren(obj->numChildren());
+
   window_->getLayout()->endBox(obj);
 }
 
@@ -377,14 +434,13 @@ void
 CBrowserOutput::
 processText(CHtmlText *text)
 {
-  std::string str = text->getText();
+  // text is referenced from token (only copied when stored)
+  const std::string &str = text->getText();
 
   CBrowserObject *currentObj = window_->currentObj();
 
   if (! currentObj) {
-    std::string sstr = CStrUtil::stripSpaces(str);
-
-    if (sstr == "")
+    if (isBlank(str))
       return;
 
     currentObj = createParagraph(window_);
@@ -394,16 +450,8 @@ processText(CHtmlText *text)
 
   bool removeSpace = (currentObj->hierWhiteSpace() == CBrowserObject::WhiteSpace::NORMAL);
 
-  std::string sstr, rstr;
-
-  if (! removeSpace) {
-    sstr = str;
-    rstr = str;
-  }
-  else {
-    sstr = CStrUtil::stripSpaces(str);
-    rstr = CStrUtil::stripSpaces(str, /*front*/true, /*back*/false);
-  }
+  // empty after space removal
+  bool empty = (removeSpace ? isBlank(str) : str.empty());
 
   //---
 
@@ -411,7 +459,7 @@ processText(CHtmlText *text)
       currentObj->type() == CHtmlTagId::FORM ||
       currentObj->type() == CHtmlTagId::DIV  ||
       currentObj->type() == CHtmlTagId::SPAN) {
-    if (sstr == "")
+    if (empty)
       return;
 
     // auto start paragraph
@@ -421,15 +469,15 @@ processText(CHtmlText *text)
   //---
 
   if      (currentObj->type() == CHtmlTagId::HTML) {
-    if (sstr != "")
+    if (! empty)
       window_->displayError("Ignore text '%s' for html tag\n", str);
   }
   else if (currentObj->type() == CHtmlTagId::HEAD) {
-    if (sstr != "")
+    if (! empty)
       window_->displayError("Ignore text '%s' for head tag\n", str);
   }
   else if (currentObj->type() == CHtmlTagId::TITLE) {
-    window_->getDocument()->setTitle(sstr);
+    window_->getDocument()->setTitle(removeSpace ? CStrUtil::stripSpaces(str) : str);
   }
   else if (currentObj->type() == CHtmlTagId::SCRIPT) {
     CBrowserScript *script = dynamic_cast<CBrowserScript *>(currentObj);
@@ -444,8 +492,8 @@ processText(CHtmlText *text)
   else if (currentObj->type() == CHtmlTagId::OPTION) {
     CBrowserFormOption *option = dynamic_cast<CBrowserFormOption *>(currentObj);
 
-    if (sstr != "")
-      option->setText(option->text() + sstr);
+    if (! empty)
+      option->setText(option->text() + (removeSpace ? CStrUtil::stripSpaces(str) : str));
   }
   else if (currentObj->type() == CHtmlTagId::TEXTAREA) {
     CBrowserFormTextarea *textArea = dynamic_cast<CBrowserFormTextarea *>(currentObj);
@@ -458,16 +506,18 @@ processText(CHtmlText *text)
     button->setLabel(str);
   }
   else {
-    if (sstr != "") {
+    if (! empty) {
       CBrowserText *textObj;
 
       if (removeSpace) {
+        std::string rstr = CStrUtil::stripSpaces(str, /*front*/true, /*back*/false);
+
         bool lspace = (str.size() > 0 && isspace(str[0]));
 
         if (currentObj->hasInlineChildren() && lspace)
-          textObj = new CBrowserText(window_, " " + rstr);
-        else
-          textObj = new CBrowserText(window_, rstr);
+          rstr.insert(0, 1, ' ');
+
+        textObj = new CBrowserText(window_, std::move(rstr));
       }
       else
         textObj = new CBrowserText(window_, str);
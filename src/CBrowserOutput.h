@@ -2,6 +2,7 @@
 #define CBrowserOutput_H
 
 #include <CBrowserTypes.h>
+#include <vector>
 
 class CBrowserOutputTagBase;
 class CBrowserWindow;
@@ -17,6 +18,12 @@ class CBrowserOutput {
 
   void processTokens(const CHtmlParserTokens &tokens);
 
+  // incremental output of tokens [i1, i2) between beginTokens and endTokens
+  void beginTokens();
+  void addTokens(const CHtmlParserTokens &tokens, int i1, int i2);
+  void endTokens();
+
+  // add objects not already in layout tree
   void layoutObjects();
 
  private:
@@ -32,7 +39,10 @@ class CBrowserOutput {
   void processEndTag  (CHtmlTag *tag, CBrowserOutputTagBase *output_data);
 
  private:
+  typedef std::vector<CHtmlTag *> TagStack;
+
   CBrowserWindow *window_ { nullptr };
+  TagStack        tagStack_;
 };
 
 #endif
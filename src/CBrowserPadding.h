@@ -22,6 +22,25 @@ class CBrowserPadding {
   double width () const { return left().pxValue() + right ().pxValue(); }
   double height() const { return top ().pxValue() + bottom().pxValue(); }
 
+  // equality and hash for style group interning
+  bool operator==(const CBrowserPadding &v) const {
+    return (left_ == v.left_ &&
+            bottom_ == v.bottom_ &&
+            top_ == v.top_ &&
+            right_ == v.right_);
+  }
+
+  size_t hash() const {
+    size_t h = 0;
+
+    h = h*31 + left_.hash();
+    h = h*31 + bottom_.hash();
+    h = h*31 + top_.hash();
+    h = h*31 + right_.hash();
+
+    return h;
+  }
+
  private:
   CBrowserUnitValue left_;
   CBrowserUnitValue bottom_;
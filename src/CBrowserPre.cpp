@@ -8,7 +8,7 @@ CBrowserPre(CBrowserWindow *window) :
 {
   setDisplay(Display::BLOCK);
 
-  font_.setFamily(CBrowserFontFamily("monospace"));
+  fontRef().setFamily(CBrowserFontFamily("monospace"));
 
   marginRef().setTop   (CBrowserUnitValue("1em"));
   marginRef().setBottom(CBrowserUnitValue("1em"));
@@ -27,7 +27,7 @@ void
 CBrowserPre::
 setNameValue(const std::string &name, const std::string &value)
 {
-  font_.setFamily(CBrowserFontFamily("monospace"));
+  fontRef().setFamily(CBrowserFontFamily("monospace"));
 
   CBrowserObject::setNameValue(name, value);
 }
@@ -2,6 +2,7 @@
 #include <CBrowserWindowWidget.h>
 #include <CQUtil.h>
 #include <QPainter>
+#include <QImage>
 
 CBrowserRenderer::
 CBrowserRenderer(CBrowserWindowWidget *w) :
@@ -20,6 +21,14 @@ void
 CBrowserRenderer::
 startDoubleBuffer(int width, int height)
 {
+  if (! painter_)
+    painter_ = new QPainter;
+
+  if (image_) {
+    painter_->begin(image_);
+    return;
+  }
+
   if (width != pixmap_width_ || height != pixmap_height_) {
     pixmap_width_  = width;
     pixmap_height_ = height;
@@ -29,9 +38,6 @@ startDoubleBuffer(int width, int height)
     pixmap_->fill(Qt::black);
   }
 
-  if (! painter_)
-    painter_ = new QPainter;
-
   painter_->begin(pixmap_);
 }
 
@@ -41,6 +47,9 @@ endDoubleBuffer()
 {
   painter_->end();
 
+  if (image_)
+    return;
+
   QPainter painter(w_);
 
   painter.drawPixmap(QPoint(0, 0), *pixmap_);
@@ -50,8 +59,9 @@ void
 CBrowserRenderer::
 clear(const CRGBA &bg)
 {
-  painter_->fillRect(QRect(0, 0, pixmap_width_, pixmap_height_),
-                     QBrush(CQUtil::rgbaToColor(bg)));
+  QRect rect = (image_ ? image_->rect() : QRect(0, 0, pixmap_width_, pixmap_height_));
+
+  painter_->fillRect(rect, QBrush(CQUtil::rgbaToColor(bg)));
 }
 
 void
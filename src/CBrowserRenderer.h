@@ -22,6 +22,10 @@ class CBrowserRenderer {
 
   QPixmap *pixmap() const { return pixmap_; }
 
+  // draw to image instead of widget pixmap (null to reset)
+  QImage *image() const { return image_; }
+  void setImage(QImage *image) { image_ = image; }
+
   virtual void clear(const CRGBA &bg);
 
   virtual void drawRectangle(const CIBBox2D &bbox, const CPen &pen);
@@ -44,6 +48,7 @@ class CBrowserRenderer {
  private:
   CBrowserWindowWidget* w_ { nullptr };
   QPixmap*              pixmap_ { nullptr };
+  QImage*               image_ { nullptr };
   int                   pixmap_width_ { 0 };
   int                   pixmap_height_ { 0 };
   QPainter*             painter_ { nullptr };
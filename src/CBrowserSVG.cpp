@@ -1,7 +1,10 @@
 #include <CBrowserSVG.h>
 #include <CQSVGRenderer.h>
+#include <CQSVGThreadPool.h>
 #include <CBrowserWindow.h>
+#include <CBrowserTrace.h>
 #include <CHtmlTag.h>
+#include <QFontDatabase>
 
 CBrowserSVG::
 CBrowserSVG(CBrowserWindow *window) :
@@ -20,8 +23,16 @@ bool
 CBrowserSVG::
 processTag(CHtmlTag *tag)
 {
+  rendered_ = false;
+
   if (tag->isStartTag()) {
-    CSVGObject *obj = svg_.createObjectByName(tag->getName());
+    const std::string &name = tag->getName();
+
+    if (name == "text" || name == "tspan" || name == "textPath" || name == "font" ||
+        name == "font-face" || name == "image" || name == "feImage" || name == "use")
+      sharedState_ = true;
+
+    CSVGObject *obj = svg_.createObjectByName(name);
 
     if (obj) {
       for (const auto &opt : tag->getOptions()) {
@@ -54,6 +65,8 @@ void
 CBrowserSVG::
 setNameValue(const std::string &name, const std::string &value)
 {
+  rendered_ = false;
+
   if (! block_->processOption(name, value))
     window_->displayError("Unhandled tag option %s=%s for %s\n",
                           name.c_str(), value.c_str(), block_->getTagName().c_str());
@@ -61,6 +74,15 @@ setNameValue(const std::string &name, const std::string &value)
   CBrowserObject::setNameValue(name, value);
 }
 
+size_t
+CBrowserSVG::
+memUsage() const
+{
+  // renderer image (svg object tree is not included)
+  return CBrowserObject::memUsage() + sizeof(CBrowserSVG) - sizeof(CBrowserObject) +
+         renderer_->qimage().byteCount();
+}
+
 CBrowserRegion
 CBrowserSVG::
 calcRegion() const
@@ -75,9 +97,79 @@ void
 CBrowserSVG::
 draw(const CTextBox &region)
 {
+  QRect visible = visibleRect(region);
+
+  if (visible.isEmpty())
+    return;
+
+  // re-render unless visible part was rendered (by previous draw or pre-render)
+  if (! rendered_ || ! renderedRect_.contains(visible)) {
+    CBrowserTraceInst->incCounter("svg_draw_renders");
+
+    render(visible);
+  }
+
+  window_->drawImage(region.x(), region.y(), renderer_->qimage());
+}
+
+QRect
+CBrowserSVG::
+visibleRect(const CTextBox &region) const
+{
+  return QRect(0, 0, window_->getCanvasWidth(), window_->getCanvasHeight()).
+           translated(-region.x(), -region.y()).
+           intersected(QRect(0, 0, region.width(), region.height()));
+}
+
+void
+CBrowserSVG::
+render(const QRect &visible)
+{
+  // filters only need to be computed for the visible part inflated by the footprint
+  // of the primitives applied (unknown until first render so whole image is rendered)
+  if (footprint_ >= 0)
+    renderer_->setRegionOfInterest(visible.adjusted(-footprint_, -footprint_,
+                                                     footprint_,  footprint_));
+  else
+    renderer_->setRegionOfInterest(QRect());
+
+  bool full = (footprint_ < 0);
+
   svg_.draw();
 
-  const QImage &qimage = renderer_->qimage();
+  footprint_ = renderer_->regionFootprint();
+
+  rendered_     = true;
+  renderedRect_ = (full ? QRect(0, 0, svg_.getWidth(), svg_.getHeight()) : visible);
+}
+
+void
+CBrowserSVG::
+renderObjects(const std::vector<CBrowserSVG *> &svgs, const std::vector<QRect> &visible)
+{
+  std::vector<int> parallel, serial;
+
+  bool threadedFonts = QFontDatabase::supportsThreadedFontRendering();
+
+  for (int i = 0; i < int(svgs.size()); ++i) {
+    if (threadedFonts && ! svgs[i]->usesSharedState())
+      parallel.push_back(i);
+    else
+      serial.push_back(i);
+  }
+
+  if (! parallel.empty())
+    CBrowserTraceInst->incCounter("svg_thread_renders", parallel.size());
+
+  if (! serial.empty())
+    CBrowserTraceInst->incCounter("svg_serial_renders", serial.size());
+
+  // images are composited in document order when drawn
+  CQSVGThreadPoolInst->parallelFor(int(parallel.size()), [&](int i1, int i2) {
+    for (int i = i1; i < i2; ++i)
+      svgs[parallel[i]]->render(visible[parallel[i]]);
+  }, 1);
 
-  window_->drawImage(region.x(), region.y(), qimage);
+  for (const auto &i : serial)
+    svgs[i]->render(visible[i]);
 }
@@ -3,6 +3,7 @@
 
 #include <CBrowserObject.h>
 #include <CSVG.h>
+#include <QRect>
 
 class CQSVGRenderer;
 
@@ -14,15 +15,39 @@ class CBrowserSVG : public CBrowserObject {
 
   void setNameValue(const std::string &name, const std::string &value) override;
 
+  size_t memUsage() const override;
+
   CBrowserRegion calcRegion() const;
 
   void draw(const CTextBox &region);
 
+  // part of image visible in canvas when drawn at region
+  QRect visibleRect(const CTextBox &region) const;
+
+  // render visible part of image into own renderer (reused by draw while it is covered)
+  void render(const QRect &visible);
+
+  // svg uses state shared outside the CSVG object (text shaping or image loading)
+  bool usesSharedState() const { return sharedState_; }
+
+  // render visible parts of svg objects, independent objects on worker threads
+  //
+  // Each object has its own CSVG tree, renderer and image buffers and the path, glyph,
+  // image pool and turbulence caches are mutex guarded. Text shaping (QFont) is only
+  // thread safe if the platform supports threaded font rendering and images are loaded
+  // through CSVG library state so objects with text or images are rendered serially.
+  static void renderObjects(const std::vector<CBrowserSVG *> &svgs,
+                            const std::vector<QRect> &visible);
+
  private:
   CSVG           svg_;
   CSVGObject*    block_ { nullptr };
   CSVGObject*    currentObj_ { nullptr };
   CQSVGRenderer* renderer_ { nullptr };
+  int            footprint_ { -1 };
+  bool           rendered_ { false };
+  QRect          renderedRect_;
+  bool           sharedState_ { false };
 };
 
 #endif
@@ -5,5 +5,5 @@ CBrowserSamp::
 CBrowserSamp(CBrowserWindow *window) :
  CBrowserObject(window, CHtmlTagId::SAMP)
 {
-  font_.setFamily(CBrowserFontFamily("monospace"));
+  fontRef().setFamily(CBrowserFontFamily("monospace"));
 }
@@ -3,6 +3,7 @@
 #include <CBrowserWindowWidget.h>
 #include <CBrowserWindow.h>
 #include <CBrowserMain.h>
+#include <CBrowserTrace.h>
 #include <CBrowserLayout.h>
 #include <CBrowserBox.h>
 #include <CBrowserObject.h>
@@ -11,6 +12,7 @@
 #include <QGridLayout>
 #include <QScrollBar>
 #include <QLabel>
+#include <algorithm>
 
 CBrowserScrolledWindow::
 CBrowserScrolledWindow(CBrowserMainWindow *iface) :
@@ -148,6 +150,20 @@ setDocument(const CUrl &url)
   window_->setDocument(url);
 }
 
+void
+CBrowserScrolledWindow::
+setDocumentDeferred(const CUrl &url)
+{
+  window_->setDocumentDeferred(url);
+}
+
+void
+CBrowserScrolledWindow::
+showDeferredDocument()
+{
+  window_->showDeferredDocument();
+}
+
 void
 CBrowserScrolledWindow::
 print()
@@ -217,13 +233,85 @@ goForward()
   window_->goForward();
 }
 
+int
+CBrowserScrolledWindow::
+printPages(const std::string &filename, int width, int height)
+{
+  // page is paper aspect slice of document at full document width
+  int paperWidth  = CBrowserMainInst->getPaperWidth ();
+  int paperHeight = CBrowserMainInst->getPaperHeight();
+
+  width = std::max(width, 1);
+
+  int pageHeight = std::max(int(double(width)*paperHeight/paperWidth), 1);
+
+  int numPages = std::max((height + pageHeight - 1)/pageHeight, 1);
+
+  //---
+
+  // render each page as canvas (boxes outside page are skipped)
+  int xOffset = canvas_x_offset_;
+  int yOffset = canvas_y_offset_;
+  int cwidth  = canvas_width_;
+  int cheight = canvas_height_;
+
+  w_->setPSPageDevice(filename, width, pageHeight, paperWidth, paperHeight);
+
+  canvas_x_offset_ = 0;
+  canvas_width_    = width;
+  canvas_height_   = pageHeight;
+
+  for (int i = 0; i < numPages; ++i) {
+    canvas_y_offset_ = i*pageHeight;
+
+    w_->startPSPage(i + 1);
+
+    window_->drawDocument();
+
+    w_->endPSPage();
+  }
+
+  w_->setXDevice();
+
+  canvas_x_offset_ = xOffset;
+  canvas_y_offset_ = yOffset;
+  canvas_width_    = cwidth;
+  canvas_height_   = cheight;
+
+  return numPages;
+}
+
+void
+CBrowserScrolledWindow::
+setViewportSize(int width, int height)
+{
+  w_->resize(width, height);
+
+  canvas_x_offset_ = 0;
+  canvas_y_offset_ = 0;
+
+  canvas_width_  = width;
+  canvas_height_ = height;
+}
+
 void
 CBrowserScrolledWindow::
-print(double xmin, double ymin, double xmax, double ymax)
+renderImage(QImage &image)
 {
-  w_->setPSDevice(xmin, ymin, xmax, ymax);
+  w_->setImageDevice(&image);
 
-  expose();
+  draw();
+
+  w_->setXDevice();
+}
+
+void
+CBrowserScrolledWindow::
+renderPS(const std::string &filename, double xmin, double ymin, double xmax, double ymax)
+{
+  w_->setPSDevice(xmin, ymin, xmax, ymax, filename);
+
+  draw();
 
   w_->setXDevice();
 }
@@ -252,6 +340,9 @@ draw()
 {
   iface_->setBusy();
 
+  {
+  CBrowserTraceScope("paint");
+
   w_->startDoubleBuffer();
 
   //---
@@ -270,14 +361,20 @@ draw()
   //---
 
   w_->endDoubleBuffer();
+  }
+
+  if (CBrowserTraceInst->isEnabled())
+    iface_->setStatus(CBrowserTraceInst->summary());
 
   iface_->setReady();
 }
 
 void
 CBrowserScrolledWindow::
-mousePress(int, int)
+mousePress(int x, int y)
 {
+  // create widget for windowless form input
+  window_->activateInput(x, y);
 }
 
 void
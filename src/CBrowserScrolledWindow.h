@@ -7,6 +7,7 @@
 
 class CBrowserMainWindow;
 class QScrollBar;
+class QImage;
 
 class CBrowserScrolledWindow : public QFrame {
   Q_OBJECT
@@ -37,6 +38,9 @@ class CBrowserScrolledWindow : public QFrame {
 
   void setDocument(const CUrl &url);
 
+  void setDocumentDeferred(const CUrl &url);
+  void showDeferredDocument();
+
   void print();
 
   void saveImage(const std::string &filename);
@@ -48,7 +52,19 @@ class CBrowserScrolledWindow : public QFrame {
   void goBack();
   void goForward();
 
-  void print(double xmin, double ymin, double xmax, double ymax);
+  // print document (width x height) to postscript file as paper sized pages
+  int printPages(const std::string &filename, int width, int height);
+
+  //---
+
+  // offscreen (batch) rendering
+  void setViewportSize(int width, int height);
+
+  void renderImage(QImage &image);
+
+  void renderPS(const std::string &filename, double xmin, double ymin, double xmax, double ymax);
+
+  //---
 
   void resize();
   void draw();
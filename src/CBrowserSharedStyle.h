@@ -0,0 +1,118 @@
+#ifndef CBrowserSharedStyle_H
+#define CBrowserSharedStyle_H
+
+#include <memory>
+#include <unordered_map>
+
+// copy-on-write style group
+//
+// All default constructed groups of the same type share a single default value and
+// copies share their parent's value. A private copy is only made when the value is
+// modified (ref()) while shared.
+//
+// Groups whose type has operator== and hash() (margin and padding) can also be
+// interned so objects given equal values separately (e.g. by tag defaults or style
+// rules) share one value. Other groups are only shared through defaults and copies.
+template<typename T>
+class CBrowserSharedStyle {
+ public:
+  CBrowserSharedStyle() :
+   data_(defData()) {
+  }
+
+  explicit CBrowserSharedStyle(const T &t) :
+   data_(std::make_shared<T>(t)) {
+  }
+
+  CBrowserSharedStyle &operator=(const T &t) {
+    if (isShared())
+      data_ = std::make_shared<T>(t);
+    else
+      *data_ = t;
+
+    return *this;
+  }
+
+  const T &get() const { return *data_; }
+
+  const T &operator*() const { return *data_; }
+
+  const T *operator->() const { return data_.get(); }
+
+  T &ref() {
+    if (isShared())
+      data_ = std::make_shared<T>(*data_);
+
+    return *data_;
+  }
+
+  bool isShared() const { return data_.use_count() > 1; }
+
+  bool isDefault() const { return data_ == defData(); }
+
+  // share value with equal default or interned value (GUI thread only)
+  void intern() {
+    if (isDefault())
+      return;
+
+    if (*data_ == *defData()) {
+      data_ = defData();
+      return;
+    }
+
+    InternMap &map = internMap();
+
+    size_t h = data_->hash();
+
+    auto range = map.equal_range(h);
+
+    for (auto p = range.first; p != range.second; ) {
+      std::shared_ptr<T> data = (*p).second.lock();
+
+      // values only referenced by the pool have been freed
+      if (! data) {
+        p = map.erase(p);
+        continue;
+      }
+
+      if (data == data_)
+        return;
+
+      if (*data == *data_) {
+        data_ = data;
+        return;
+      }
+
+      ++p;
+    }
+
+    map.insert(typename InternMap::value_type(h, data_));
+  }
+
+  // bytes of value data used by this group (shared values are divided between users)
+  size_t memUsage() const { return sizeof(T)/data_.use_count(); }
+
+  // bytes of value data if value was not shared
+  size_t unsharedMemUsage() const { return sizeof(T); }
+
+ private:
+  // pool does not own values (weak) so unused values are freed
+  typedef std::unordered_multimap<size_t, std::weak_ptr<T>> InternMap;
+
+  static InternMap &internMap() {
+    static InternMap map;
+
+    return map;
+  }
+
+  static const std::shared_ptr<T> &defData() {
+    static std::shared_ptr<T> data = std::make_shared<T>();
+
+    return data;
+  }
+
+ private:
+  std::shared_ptr<T> data_;
+};
+
+#endif
@@ -8,7 +8,7 @@ CBrowserBStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setBold();
+  fontRef().setBold();
 }
 
 CBrowserBStyle::
@@ -24,7 +24,7 @@ CBrowserBigStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setBig();
+  fontRef().setBig();
 }
 
 CBrowserBigStyle::
@@ -40,7 +40,7 @@ CBrowserBlinkStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setBold();
+  fontRef().setBold();
 }
 
 CBrowserBlinkStyle::
@@ -56,7 +56,7 @@ CBrowserCiteStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setItalic();
+  fontRef().setItalic();
 }
 
 CBrowserCiteStyle::
@@ -72,7 +72,7 @@ CBrowserDfnStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setItalic();
+  fontRef().setItalic();
 }
 
 CBrowserDfnStyle::
@@ -88,7 +88,7 @@ CBrowserEmStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setItalic();
+  fontRef().setItalic();
 }
 
 CBrowserEmStyle::
@@ -131,7 +131,7 @@ setNameValue(const std::string &name, const std::string &value)
   else if (lname == "face") {
     data_.face = value;
 
-    font_.setFamily(CBrowserFontFamily(data_.face));
+    fontRef().setFamily(CBrowserFontFamily(data_.face));
   }
   else if (lname == "size") {
     std::string value1 = value;
@@ -158,13 +158,13 @@ setNameValue(const std::string &name, const std::string &value)
 
     if (data_.delta != 0) {
       if (data_.delta > 0)
-        font_.setSize(CBrowserFontSize(CBrowserFontSize::Type::LARGER, data_.delta));
+        fontRef().setSize(CBrowserFontSize(CBrowserFontSize::Type::LARGER, data_.delta));
       else
-        font_.setSize(CBrowserFontSize(CBrowserFontSize::Type::SMALLER, data_.delta));
+        fontRef().setSize(CBrowserFontSize(CBrowserFontSize::Type::SMALLER, data_.delta));
     }
     else {
       if (data_.size >= 0) {
-        font_.setSize(CBrowserFontSize(window_->sizeToFontSize(data_.size)));
+        fontRef().setSize(CBrowserFontSize(window_->sizeToFontSize(data_.size)));
       }
     }
 
@@ -183,7 +183,7 @@ CBrowserIStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setItalic();
+  fontRef().setItalic();
 }
 
 CBrowserIStyle::
@@ -199,7 +199,7 @@ CBrowserSmallStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setSmall();
+  fontRef().setSmall();
 }
 
 CBrowserSmallStyle::
@@ -215,7 +215,7 @@ CBrowserStrikeStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  textProp_.setDecoration(CBrowserTextDecoration("line-through"));
+  textPropRef().setDecoration(CBrowserTextDecoration("line-through"));
 }
 
 CBrowserStrikeStyle::
@@ -231,7 +231,7 @@ CBrowserStrongStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setBold();
+  fontRef().setBold();
 }
 
 CBrowserStrongStyle::
@@ -247,9 +247,9 @@ CBrowserSubStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  textProp_.setVerticalAlign(CBrowserTextVAlign("sub"));
+  textPropRef().setVerticalAlign(CBrowserTextVAlign("sub"));
 
-  font_.setSmall();
+  fontRef().setSmall();
 }
 
 CBrowserSubStyle::
@@ -265,9 +265,9 @@ CBrowserSupStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  textProp_.setVerticalAlign(CBrowserTextVAlign("super"));
+  textPropRef().setVerticalAlign(CBrowserTextVAlign("super"));
 
-  font_.setSmall();
+  fontRef().setSmall();
 }
 
 CBrowserSupStyle::
@@ -283,7 +283,7 @@ CBrowserUStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  textProp_.setDecoration(CBrowserTextDecoration("underline"));
+  textPropRef().setDecoration(CBrowserTextDecoration("underline"));
 }
 
 CBrowserUStyle::
@@ -299,7 +299,7 @@ CBrowserVarStyle(CBrowserWindow *window) :
 {
   setDisplay(CBrowserObject::Display::INLINE);
 
-  font_.setItalic();
+  fontRef().setItalic();
 }
 
 CBrowserVarStyle::
@@ -7,5 +7,5 @@ CBrowserTT(CBrowserWindow *window) :
 {
   setDisplay(Display::INLINE);
 
-  font_.setFamily(CBrowserFontFamily("monospace"));
+  fontRef().setFamily(CBrowserFontFamily("monospace"));
 }
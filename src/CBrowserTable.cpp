@@ -1,6 +1,7 @@
 #include <CBrowserTable.h>
 #include <CBrowserWindow.h>
 #include <CRGBName.h>
+#include <algorithm>
 
 CBrowserTable::
 CBrowserTable(CBrowserWindow *window, const CBrowserTableData &data) :
@@ -16,6 +17,8 @@ CBrowserTable(CBrowserWindow *window, const CBrowserTableData &data) :
 CBrowserTable::
 ~CBrowserTable()
 {
+  for (auto &padCell : layoutPadCells_)
+    delete padCell;
 }
 
 void
@@ -148,6 +151,9 @@ void
 CBrowserTable::
 addPadCells()
 {
+  // grid may have grown since last layout
+  removeLayoutPadCells();
+
   for (int i = 0; i < getNumRows(); ++i) {
     int num_cols = row_cells_[i].size();
 
@@ -159,10 +165,27 @@ addPadCells()
       padCell->setPos(i, j);
 
       addRowCell(i, padCell);
+
+      layoutPadCells_.push_back(padCell);
     }
   }
 }
 
+void
+CBrowserTable::
+removeLayoutPadCells()
+{
+  for (auto &padCell : layoutPadCells_) {
+    Cells &cells = row_cells_[padCell->row()];
+
+    cells.erase(std::remove(cells.begin(), cells.end(), padCell), cells.end());
+
+    delete padCell;
+  }
+
+  layoutPadCells_.clear();
+}
+
 void
 CBrowserTable::
 layout()
@@ -730,8 +753,12 @@ initProcess()
 
   //---
 
-  if (table)
+  if (table) {
+    // rows added after an incremental layout must not follow its pad cells
+    table->removeLayoutPadCells();
+
     table->addRow(this);
+  }
 }
 
 void
@@ -749,7 +776,7 @@ CBrowserTableCell(CBrowserWindow *window, CHtmlTagId id, const CBrowserTableCell
   setDisplay(Display::TABLE_CELL);
 
   if (id == CHtmlTagId::TH)
-    font_.setBold();
+    fontRef().setBold();
 
 //setNameValue("vertical-align", "inherit");
 }
@@ -871,6 +898,9 @@ initProcess()
   //---
 
   if (table) {
+    // cells added after an incremental layout must not follow its pad cells
+    table->removeLayoutPadCells();
+
     table->setNumRows(std::max(table->getNumRows(), table->getRowNum() + data_.rowspan - 1));
 
     table->resizeRowSize(table->getNumRows());
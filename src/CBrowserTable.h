@@ -95,6 +95,9 @@ class CBrowserTable : public CBrowserObject {
 
   void addRowCell(int row, CBrowserTableCell *cell);
 
+  // remove grid hole cells added by an earlier (incremental) layout
+  void removeLayoutPadCells();
+
   void layout() override;
 
   void updateRowHeights() const;
@@ -124,6 +127,7 @@ class CBrowserTable : public CBrowserObject {
   int                   num_rows_ { 0 };
   int                   num_cols_ { 0 };
   RowCells              row_cells_;
+  Cells                 layoutPadCells_;
   std::vector<int>      row_heights_;
   std::vector<int>      col_widths_;
   CBrowserTableCaption* caption_ { nullptr };
@@ -4,8 +4,8 @@
 #include <CFont.h>
 
 CBrowserText::
-CBrowserText(CBrowserWindow *window, const std::string &text) :
- CBrowserObject(window, CHtmlTagId::TEXT), text_(text)
+CBrowserText(CBrowserWindow *window, std::string text) :
+ CBrowserObject(window, CHtmlTagId::TEXT), text_(std::move(text))
 {
   setDisplay(Display::INLINE);
 
@@ -249,3 +249,11 @@ hierWhiteSpace() const
 
   return CBrowserObject::WhiteSpace::NORMAL;
 }
+
+size_t
+CBrowserText::
+memUsage() const
+{
+  return CBrowserObject::memUsage() + sizeof(CBrowserText) - sizeof(CBrowserObject) +
+         text_.capacity() + texts_.capacity()*sizeof(CBrowserText *);
+}
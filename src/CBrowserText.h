@@ -14,7 +14,7 @@ enum CBrowserTextPos {
 
 class CBrowserText : public CBrowserObject {
  public:
-  CBrowserText(CBrowserWindow *window, const std::string &text);
+  CBrowserText(CBrowserWindow *window, std::string text);
 
   CBrowserText(CBrowserWindow *window, const CBrowserText &draw_text, const std::string &text);
 
@@ -49,6 +49,8 @@ class CBrowserText : public CBrowserObject {
 
   CBrowserObject::WhiteSpace hierWhiteSpace() const override;
 
+  size_t memUsage() const override;
+
  private:
   typedef std::vector<CBrowserText *> Texts;
 
@@ -0,0 +1,282 @@
+#include <CBrowserTrace.h>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+thread_local CBrowserTraceTimer *CBrowserTraceTimer::current_ = nullptr;
+
+//---
+
+CBrowserTrace *
+CBrowserTrace::
+getInstance()
+{
+  static CBrowserTrace *instance;
+
+  if (! instance)
+    instance = new CBrowserTrace;
+
+  return instance;
+}
+
+CBrowserTrace::
+CBrowserTrace()
+{
+  startTime_ = Clock::now();
+}
+
+void
+CBrowserTrace::
+setEnabled(bool b)
+{
+  enabled_ = b;
+}
+
+void
+CBrowserTrace::
+reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  phaseNames_.clear();
+  phases_    .clear();
+  counters_  .clear();
+}
+
+void
+CBrowserTrace::
+addEvent(const char *name, const TimePoint &start, const TimePoint &end, long allocs,
+         long childTime, long childAllocs)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  Event event;
+
+  event.name  = name;
+  event.phase = 'X';
+  event.ts    = elapsed(start);
+  event.dur    = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  event.allocs = allocs;
+  event.tid    = threadId();
+
+  events_.push_back(event);
+
+  //---
+
+  auto p = phases_.find(name);
+
+  if (p == phases_.end()) {
+    phaseNames_.push_back(name);
+
+    p = phases_.insert(p, PhaseMap::value_type(name, PhaseData()));
+  }
+
+  // totals are self time so nested phases are not counted twice
+  (*p).second.time   += event.dur - childTime;
+  (*p).second.allocs += allocs - childAllocs;
+
+  ++(*p).second.count;
+}
+
+void
+CBrowserTrace::
+addAccum(CBrowserTraceAccum &accum)
+{
+  if (! enabled_ || ! accum.count()) {
+    accum.reset();
+    return;
+  }
+
+  // accumulated time is nested in the enclosing timer
+  CBrowserTraceTimer *timer = CBrowserTraceTimer::current();
+
+  if (timer)
+    timer->addChild(accum.time());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto p = phases_.find(accum.name());
+
+  if (p == phases_.end()) {
+    phaseNames_.push_back(accum.name());
+
+    p = phases_.insert(p, PhaseMap::value_type(accum.name(), PhaseData()));
+  }
+
+  (*p).second.time += accum.time();
+
+  ++(*p).second.count;
+
+  accum.reset();
+}
+
+void
+CBrowserTrace::
+setCounter(const char *name, long value)
+{
+  if (! enabled_)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  addCounter(name, value);
+}
+
+void
+CBrowserTrace::
+incCounter(const char *name, long d)
+{
+  if (! enabled_)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  addCounter(name, counters_[name] + d);
+}
+
+void
+CBrowserTrace::
+addCounter(const char *name, long value)
+{
+  Event event;
+
+  event.name  = name;
+  event.phase = 'C';
+  event.ts    = elapsed(Clock::now());
+  event.value = value;
+  event.tid   = threadId();
+
+  events_.push_back(event);
+
+  counters_[name] = value;
+}
+
+std::string
+CBrowserTrace::
+summary() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::string str;
+
+  char buffer[256];
+
+  for (const auto &name : phaseNames_) {
+    const PhaseData &data = (*phases_.find(name)).second;
+
+    if (data.count > 1)
+      snprintf(buffer, sizeof(buffer), "%s %.1fms (%d)", name.c_str(),
+               data.time/1000.0, data.count);
+    else
+      snprintf(buffer, sizeof(buffer), "%s %.1fms", name.c_str(), data.time/1000.0);
+
+    if (str != "") str += ", ";
+
+    str += buffer;
+  }
+
+  for (const auto &pc : counters_) {
+    if (str != "") str += ", ";
+
+    str += pc.first + " " + std::to_string(pc.second);
+  }
+
+  return str;
+}
+
+CBrowserTrace::PhaseStatsList
+CBrowserTrace::
+phaseStats() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  PhaseStatsList stats;
+
+  for (const auto &name : phaseNames_) {
+    const PhaseData &data = (*phases_.find(name)).second;
+
+    PhaseStats stat;
+
+    stat.name   = name;
+    stat.time   = data.time;
+    stat.count  = data.count;
+    stat.allocs = data.allocs;
+
+    stats.push_back(stat);
+  }
+
+  return stats;
+}
+
+CBrowserTrace::Counters
+CBrowserTrace::
+counters() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  return counters_;
+}
+
+bool
+CBrowserTrace::
+writeJSON(const std::string &filename) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::ofstream os(filename.c_str());
+
+  if (! os)
+    return false;
+
+  int pid = getpid();
+
+  os << "{\"traceEvents\":[\n";
+
+  bool first = true;
+
+  for (const auto &event : events_) {
+    if (! first) os << ",\n";
+
+    os << "{\"name\":\"" << event.name << "\",\"cat\":\"browser\",\"ph\":\"" <<
+          event.phase << "\",\"ts\":" << event.ts << ",\"pid\":" << pid <<
+          ",\"tid\":" << event.tid;
+
+    if (event.phase == 'X') {
+      os << ",\"dur\":" << event.dur;
+
+      if (event.allocs)
+        os << ",\"args\":{\"allocs\":" << event.allocs << "}";
+    }
+    else
+      os << ",\"args\":{\"value\":" << event.value << "}";
+
+    os << "}";
+
+    first = false;
+  }
+
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  return true;
+}
+
+long
+CBrowserTrace::
+elapsed(const TimePoint &t) const
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(t - startTime_).count();
+}
+
+int
+CBrowserTrace::
+threadId()
+{
+  auto id = std::this_thread::get_id();
+
+  auto p = threadIds_.find(id);
+
+  if (p == threadIds_.end())
+    p = threadIds_.insert(p, ThreadIds::value_type(id, int(threadIds_.size()) + 1));
+
+  return (*p).second;
+}
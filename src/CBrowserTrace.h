@@ -0,0 +1,229 @@
+#ifndef CBrowserTrace_H
+#define CBrowserTrace_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+#include <map>
+
+#define CBrowserTraceInst CBrowserTrace::getInstance()
+
+#define CBrowserTraceConcat1(a, b) a##b
+#define CBrowserTraceConcat(a, b) CBrowserTraceConcat1(a, b)
+
+// time enclosing scope as named phase (if tracing enabled)
+#define CBrowserTraceScope(name) \
+  CBrowserTraceTimer CBrowserTraceConcat(browserTraceTimer_, __LINE__)(name)
+
+class CBrowserTraceAccum;
+
+// phase level performance trace
+//
+// Records complete ("X") and counter ("C") events which can be exported in Chrome
+// trace_event JSON format (chrome://tracing, Perfetto) and summarised per phase.
+// Phase totals are self times (time of nested phases on the same thread is
+// subtracted) so they add up to the total. When disabled timers only test a flag.
+class CBrowserTrace {
+ public:
+  typedef std::chrono::steady_clock Clock;
+  typedef Clock::time_point         TimePoint;
+
+  // returns number of allocations made so far (supplied by allocation counting program)
+  typedef long (*AllocCountProc)();
+
+  struct PhaseStats {
+    std::string name;
+    long        time   { 0 }; // total self time (microseconds)
+    int         count  { 0 };
+    long        allocs { 0 };
+  };
+
+  typedef std::vector<PhaseStats>     PhaseStatsList;
+  typedef std::map<std::string, long> Counters;
+
+ public:
+  static CBrowserTrace *getInstance();
+
+  bool isEnabled() const { return enabled_; }
+  void setEnabled(bool b);
+
+  void setAllocCountProc(AllocCountProc proc) { allocCountProc_ = proc; }
+
+  long allocCount() const { return (allocCountProc_ ? allocCountProc_() : 0); }
+
+  // clear events and phase totals
+  void reset();
+
+  // add completed phase event (child time/allocs are those of nested phases)
+  void addEvent(const char *name, const TimePoint &start, const TimePoint &end, long allocs=0,
+                long childTime=0, long childAllocs=0);
+
+  // add accumulated time of frequent short phase as one phase entry (and reset it)
+  void addAccum(CBrowserTraceAccum &accum);
+
+  // set counter value
+  void setCounter(const char *name, long value);
+
+  // increment counter value
+  void incCounter(const char *name, long d=1);
+
+  // one line summary of phase times and counters (since reset)
+  std::string summary() const;
+
+  // phase totals (in first use order) and counters (since reset)
+  PhaseStatsList phaseStats() const;
+  Counters       counters() const;
+
+  // write events as Chrome trace_event JSON
+  bool writeJSON(const std::string &filename) const;
+
+ private:
+  CBrowserTrace();
+
+  void addCounter(const char *name, long value);
+
+  long elapsed(const TimePoint &t) const;
+
+  int threadId();
+
+ private:
+  struct Event {
+    const char *name  { nullptr };
+    char        phase { 'X' };
+    long        ts    { 0 };
+    long        dur   { 0 };
+    long        value  { 0 };
+    long        allocs { 0 };
+    int         tid    { 0 };
+  };
+
+  struct PhaseData {
+    long time   { 0 };
+    int  count  { 0 };
+    long allocs { 0 };
+  };
+
+  typedef std::vector<Event>                 Events;
+  typedef std::vector<std::string>           PhaseNames;
+  typedef std::map<std::string, PhaseData>   PhaseMap;
+  typedef std::map<std::thread::id, int>     ThreadIds;
+
+  std::atomic<bool>  enabled_ { false };
+  AllocCountProc     allocCountProc_ { nullptr };
+  TimePoint          startTime_;
+  Events             events_;
+  PhaseNames         phaseNames_;
+  PhaseMap           phases_;
+  Counters           counters_;
+  ThreadIds          threadIds_;
+  mutable std::mutex mutex_;
+};
+
+//---
+
+// scoped phase timer (nested timers on same thread report their time to parent)
+class CBrowserTraceTimer {
+ public:
+  explicit CBrowserTraceTimer(const char *name) {
+    if (CBrowserTraceInst->isEnabled()) {
+      name_   = name;
+      allocs_ = CBrowserTraceInst->allocCount();
+      start_  = CBrowserTrace::Clock::now();
+      parent_ = current_;
+
+      current_ = this;
+    }
+  }
+
+ ~CBrowserTraceTimer() {
+    if (! name_)
+      return;
+
+    CBrowserTrace::TimePoint end = CBrowserTrace::Clock::now();
+
+    long allocs = CBrowserTraceInst->allocCount() - allocs_;
+
+    CBrowserTraceInst->addEvent(name_, start_, end, allocs, childTime_, childAllocs_);
+
+    current_ = parent_;
+
+    if (parent_)
+      parent_->addChild(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start_).count(), allocs);
+  }
+
+  CBrowserTraceTimer(const CBrowserTraceTimer &) = delete;
+  CBrowserTraceTimer &operator=(const CBrowserTraceTimer &) = delete;
+
+  // innermost active timer of current thread
+  static CBrowserTraceTimer *current() { return current_; }
+
+  // add time of nested work (excluded from self time)
+  void addChild(long time, long allocs=0) { childTime_ += time; childAllocs_ += allocs; }
+
+ private:
+  static thread_local CBrowserTraceTimer *current_;
+
+  const char*                 name_        { nullptr };
+  long                        allocs_      { 0 };
+  CBrowserTrace::TimePoint    start_;
+  CBrowserTraceTimer*         parent_      { nullptr };
+  long                        childTime_   { 0 };
+  long                        childAllocs_ { 0 };
+};
+
+//---
+
+// time of a frequent short phase (e.g. per object style matching) accumulated
+// without locking and added to trace once (CBrowserTrace::addAccum)
+class CBrowserTraceAccum {
+ public:
+  explicit CBrowserTraceAccum(const char *name) :
+   name_(name) {
+  }
+
+  const char *name() const { return name_; }
+
+  long time () const { return time_ ; }
+  int  count() const { return count_; }
+
+  void add(long time) { time_ += time; ++count_; }
+
+  void reset() { time_ = 0; count_ = 0; }
+
+ private:
+  const char* name_  { nullptr };
+  long        time_  { 0 };
+  int         count_ { 0 };
+};
+
+// scoped timer adding to accumulator
+class CBrowserTraceAccumScope {
+ public:
+  explicit CBrowserTraceAccumScope(CBrowserTraceAccum &accum) :
+   accum_(accum) {
+    if (CBrowserTraceInst->isEnabled()) {
+      enabled_ = true;
+      start_   = CBrowserTrace::Clock::now();
+    }
+  }
+
+ ~CBrowserTraceAccumScope() {
+    if (enabled_)
+      accum_.add(std::chrono::duration_cast<std::chrono::microseconds>(
+                   CBrowserTrace::Clock::now() - start_).count());
+  }
+
+  CBrowserTraceAccumScope(const CBrowserTraceAccumScope &) = delete;
+  CBrowserTraceAccumScope &operator=(const CBrowserTraceAccumScope &) = delete;
+
+ private:
+  CBrowserTraceAccum&      accum_;
+  bool                     enabled_ { false };
+  CBrowserTrace::TimePoint start_;
+};
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <CScreenUnits.h>
 #include <CStrUtil.h>
+#include <functional>
+#include <memory>
 
 class CBrowserUnitValue {
  public:
@@ -10,14 +12,14 @@ class CBrowserUnitValue {
     AUTO,
     INITIAL,
     INHERIT,
+    NONE,
     VALUE
   };
 
  public:
   CBrowserUnitValue() { }
 
-  explicit CBrowserUnitValue(const std::string &str) :
-   str_(str) {
+  explicit CBrowserUnitValue(const std::string &str) {
     int len = str.size();
 
     if      (str == "auto") {
@@ -30,7 +32,8 @@ class CBrowserUnitValue {
       type_ = Type::INHERIT;
     }
     else if (str == "none") {
-      type_  = Type::VALUE;
+      // behaves as zero length
+      type_  = Type::NONE;
       value_ = CScreenUnits(0, CScreenUnits::Units::PX);
     }
     else if (str[len - 1] == '%') {
@@ -38,38 +41,51 @@ class CBrowserUnitValue {
 
       if (CStrUtil::isReal(value1))
         value_ = CScreenUnits(CStrUtil::toReal(value1), CScreenUnits::Units::PERCENT);
-      else
+      else {
         std::cerr << "Invalid percent unit value: '" << value1 << "'" << std::endl;
+        str_.reset(new std::string(str));
+      }
     }
     else if (len > 2 && str[len - 2] == 'p' && str[len - 1] == 'x') {
       std::string value1 = str.substr(0, len - 2);
 
       if (CStrUtil::isReal(value1))
         value_ = CScreenUnits(CStrUtil::toReal(value1), CScreenUnits::Units::PX);
-      else
+      else {
         std::cerr << "Invalid px unit value: '" << value1 << "'" << std::endl;
+        str_.reset(new std::string(str));
+      }
     }
     else if (len > 2 && str[len - 2] == 'c' && str[len - 1] == 'm') {
       std::string value1 = str.substr(0, len - 2);
 
       if (CStrUtil::isReal(value1))
         value_ = CScreenUnits(CStrUtil::toReal(value1), CScreenUnits::Units::CM);
-      else
+      else {
         std::cerr << "Invalid cm unit value: '" << value1 << "'" << std::endl;
+        str_.reset(new std::string(str));
+      }
     }
     else if (len > 2 && str[len - 2] == 'e' && str[len - 1] == 'm') {
       std::string value1 = str.substr(0, len - 2);
 
       if (CStrUtil::isReal(value1))
         value_ = CScreenUnits(CStrUtil::toReal(value1), CScreenUnits::Units::EM);
-      else
+      else {
         std::cerr << "Invalid em unit value: '" << value1 << "'" << std::endl;
+        str_.reset(new std::string(str));
+      }
     }
     else {
-      if (CStrUtil::isReal(str))
-        value_ = CScreenUnits(CStrUtil::toReal(str), CScreenUnits::Units::PX);
-      else
+      // unitless number is px
+      if (CStrUtil::isReal(str)) {
+        value_    = CScreenUnits(CStrUtil::toReal(str), CScreenUnits::Units::PX);
+        unitless_ = true;
+      }
+      else {
         std::cerr << "Invalid px unit value: '" << str << "'" << std::endl;
+        str_.reset(new std::string(str));
+      }
     }
   }
 
@@ -85,7 +101,51 @@ class CBrowserUnitValue {
     value_(value), type_(Type::VALUE) {
   }
 
-  const std::string &string() const { return str_; }
+  CBrowserUnitValue(const CBrowserUnitValue &v) :
+   value_(v.value_), type_(v.type_), unitless_(v.unitless_) {
+    if (v.isSource())
+      str_.reset(new std::string(*v.str_));
+  }
+
+  CBrowserUnitValue(CBrowserUnitValue &&v) = default;
+
+  CBrowserUnitValue &operator=(const CBrowserUnitValue &v) {
+    if (&v != this) {
+      value_    = v.value_;
+      type_     = v.type_;
+      unitless_ = v.unitless_;
+
+      str_.reset(v.isSource() ? new std::string(*v.str_) : nullptr);
+    }
+
+    return *this;
+  }
+
+  CBrowserUnitValue &operator=(CBrowserUnitValue &&v) = default;
+
+  // source string is only kept for unparsed values, the string of a parsed value is
+  // built from the value and units when first requested (GUI thread only)
+  const std::string &string() const {
+    static const std::string autoStr   ("auto");
+    static const std::string initialStr("initial");
+    static const std::string inheritStr("inherit");
+    static const std::string noneStr   ("none");
+    static const std::string emptyStr;
+
+    if      (type_ == Type::AUTO   ) return autoStr;
+    else if (type_ == Type::INITIAL) return initialStr;
+    else if (type_ == Type::INHERIT) return inheritStr;
+    else if (type_ == Type::NONE   ) return noneStr;
+
+    if (! str_) {
+      if (! isValid())
+        return emptyStr;
+
+      str_.reset(new std::string(valueString()));
+    }
+
+    return *str_;
+  }
 
   CScreenUnits::Units units() const { return value_.units(); }
 
@@ -106,10 +166,53 @@ class CBrowserUnitValue {
 
   bool isValid() const { return value_.isValid(); }
 
+  //---
+
+  // equality and hash for interning of style groups
+  bool operator==(const CBrowserUnitValue &v) const {
+    if (type_ != v.type_ || unitless_ != v.unitless_ || isValid() != v.isValid())
+      return false;
+
+    if (! isValid())
+      return (string() == v.string());
+
+    return (units() == v.units() && value_.value() == v.value_.value());
+  }
+
+  bool operator!=(const CBrowserUnitValue &v) const { return ! (*this == v); }
+
+  size_t hash() const {
+    size_t h = std::hash<int>()(int(type_));
+
+    if (isValid()) {
+      h = h*31 + std::hash<int>()(int(units()));
+      h = h*31 + std::hash<double>()(value_.value());
+    }
+
+    return h;
+  }
+
+ private:
+  // string is unparsed source string
+  bool isSource() const { return (str_ && ! isValid()); }
+
+  std::string valueString() const {
+    std::string str = CStrUtil::toString(value_.value());
+
+    switch (units()) {
+      case CScreenUnits::Units::PERCENT: return str + "%";
+      case CScreenUnits::Units::CM     : return str + "cm";
+      case CScreenUnits::Units::EM     : return str + "em";
+      case CScreenUnits::Units::PX     : return (unitless_ ? str : str + "px");
+      default                          : return str;
+    }
+  }
+
  private:
-  std::string  str_;
-  CScreenUnits value_;
-  Type         type_ { Type::VALUE };
+  CScreenUnits                         value_;
+  Type                                 type_ { Type::VALUE };
+  bool                                 unitless_ { false };
+  mutable std::unique_ptr<std::string> str_;
 };
 
 //---
@@ -8,6 +8,7 @@
 #include <CBrowserBreak.h>
 #include <CBrowserCanvas.h>
 #include <CBrowserImage.h>
+#include <CBrowserSVG.h>
 #include <CBrowserNamedImage.h>
 #include <CBrowserLayout.h>
 #include <CBrowserLink.h>
@@ -18,6 +19,7 @@
 #include <CBrowserForm.h>
 #include <CBrowserOutputTag.h>
 #include <CBrowserMainWindow.h>
+#include <CBrowserTrace.h>
 #include <CQJavaScript.h>
 #include <CQJHtmlObj.h>
 #include <CHtmlCSSTagData.h>
@@ -26,6 +28,21 @@
 #include <CRGBName.h>
 #include <CFontMgr.h>
 #include <CEnv.h>
+#include <sys/stat.h>
+
+namespace {
+
+// file modification time (-1 if not found)
+long long fileMTime(const std::string &filename) {
+  struct stat fs;
+
+  if (stat(filename.c_str(), &fs) != 0)
+    return -1;
+
+  return (long long) fs.st_mtime;
+}
+
+}
 
 //------
 
@@ -53,6 +70,9 @@ CBrowserWindow::
 {
   window_list_.remove(this);
 
+  if (deferredRead_.valid())
+    deferredRead_.wait();
+
   document_->freeLinks();
 
   delete document_;
@@ -70,6 +90,9 @@ init()
   w_       = nullptr;
 
   reset();
+
+  // history is kept across documents
+  history_ = new CBrowserHistory(this);
 }
 
 void
@@ -82,8 +105,6 @@ reset()
   delete linkMgr_;
   delete fileMgr_;
 
-  delete history_;
-
   //---
 
   window_target_ = "";
@@ -111,12 +132,12 @@ reset()
   scripts_    .clear();
   scriptFiles_.clear();
 
+  htmlObjectsRegistered_ = false;
+
   cssList_.clear();
 
   baseFontSize_ = 3;
 
-  history_ = new CBrowserHistory(this);
-
   //---
 
   setBaseFontStyle();
@@ -134,13 +155,85 @@ void
 CBrowserWindow::
 processTokens(const CHtmlParserTokens &tokens)
 {
+  CBrowserTraceScope("dom");
+
   output_.processTokens(tokens);
+
+  CBrowserTraceInst->addAccum(styleTraceAccum_);
+
+  CBrowserTraceInst->setCounter("objects", objects_.size());
+}
+
+void
+CBrowserWindow::
+processTokensIncremental(const CHtmlParserTokens &tokens)
+{
+  // chunk sizes double so total layout work is at most twice that of a single layout
+  int chunk = 1000;
+
+  output_.beginTokens();
+
+  int n = tokens.size();
+
+  for (int i = 0; i < n; ) {
+    int i2 = std::min(i + chunk, n);
+
+    {
+    CBrowserTraceScope("dom");
+
+    output_.addTokens(tokens, i, i2);
+
+    CBrowserTraceInst->addAccum(styleTraceAccum_);
+    }
+
+    i      = i2;
+    chunk *= 2;
+
+    if (i >= n)
+      break;
+
+    // lay out and paint objects so far. The canvas is repainted directly rather than by
+    // running the event loop, which could re-enter document loading (timers, scripts or
+    // deferred tabs) while the tokens are being processed.
+    layoutObjects();
+
+    recalc();
+
+    if (w_)
+      w_->repaint();
+
+    if (! firstPainted_)
+      recordFirstPaint();
+  }
+
+  output_.endTokens();
+
+  CBrowserTraceInst->setCounter("objects", objects_.size());
+}
+
+void
+CBrowserWindow::
+recordFirstPaint()
+{
+  long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - loadTime_).count();
+
+  CBrowserTraceInst->setCounter("first_paint_ms", ms);
+
+  setStatus("First paint: " + std::to_string(ms) + "ms");
+
+  if (CBrowserMainInst->getDebug())
+    std::cerr << "First paint: " << ms << "ms" << std::endl;
+
+  firstPainted_ = true;
 }
 
 void
 CBrowserWindow::
 layoutObjects()
 {
+  CBrowserTraceScope("layout");
+
   output_.layoutObjects();
 }
 
@@ -208,6 +301,8 @@ CImagePtr
 CBrowserWindow::
 lookupImage(const CBrowserImageData &imageData, int iwidth, int iheight)
 {
+  CBrowserTraceScope("image");
+
   CImageFileSrc file(imageData.src);
 
   CImagePtr image = CImageMgrInst->createImage(file);
@@ -278,15 +373,17 @@ startObject(CBrowserObject *obj, bool add)
 
     objects_.push_back(obj);
 
-    //---
-
-    addHtmlObject(obj);
+    if (htmlObjectsRegistered_)
+      (void) obj->getJObj();
   }
 
   //---
 
-  if (add)
+  if (add) {
     applyStyle(obj);
+
+    obj->internStyle();
+  }
 }
 
 void
@@ -309,25 +406,29 @@ addHtmlObject(CBrowserObject *obj)
 
   CQJHtmlObj *htmlObj = obj->createJObj(js);
 
-  CJValueP value(htmlObj); // first create of shared pointer
-
-  objMap_[obj] = value;
+  obj->setJObj(htmlObj);
 
   CQJavaScriptInst->addHtmlObject(htmlObj);
+}
 
-  obj->setJObj(htmlObj);
+void
+CBrowserWindow::
+registerHtmlObjects()
+{
+  if (htmlObjectsRegistered_)
+    return;
+
+  for (const auto &obj : objects_)
+    (void) obj->getJObj();
+
+  htmlObjectsRegistered_ = true;
 }
 
 CJValueP
 CBrowserWindow::
 lookupHtmlObject(CBrowserObject *obj) const
 {
-  auto p = objMap_.find(obj);
-
-  if (p == objMap_.end())
-    return nullptr;
-
-  return (*p).second;
+  return obj->getJObjValue();
 }
 
 CBrowserObject *
@@ -400,6 +501,13 @@ void
 CBrowserWindow::
 runScripts()
 {
+  CBrowserTraceScope("script");
+
+  // javascript objects are only created when accessed so, if we have scripts, make
+  // sure all objects are registered for lookup (by id, tag, class, children or events)
+  if (! scriptFiles_.empty() || ! scripts_.empty())
+    registerHtmlObjects();
+
   for (const auto &s : scriptFiles_)
     CQJavaScriptInst->runScriptFile(s);
 
@@ -409,6 +517,44 @@ runScripts()
   CQJavaScriptInst->onLoad();
 }
 
+void
+CBrowserWindow::
+renderSVGObjects()
+{
+  if (! swindow_)
+    return;
+
+  CBrowserTraceScope("paint");
+
+  // only objects in viewport are pre-rendered (others are rendered, restricted to their
+  // visible part, when scrolled into view)
+  std::vector<CBrowserSVG *> svgs;
+  std::vector<QRect>         visible;
+
+  int dx = -getCanvasXOffset();
+  int dy = -getCanvasYOffset();
+
+  for (auto &obj : objects_) {
+    if (obj->type() != CHtmlTagId::SVG || ! obj->isVisible())
+      continue;
+
+    CBrowserSVG *svg = static_cast<CBrowserSVG *>(obj);
+
+    CTextBox region(svg->x() + svg->contentX() + dx, svg->y() + svg->contentY() + dy,
+                    svg->contentWidth(), svg->contentHeight());
+
+    QRect rect = svg->visibleRect(region);
+
+    if (rect.isEmpty())
+      continue;
+
+    svgs   .push_back(svg);
+    visible.push_back(rect);
+  }
+
+  CBrowserSVG::renderObjects(svgs, visible);
+}
+
 //------
 
 void
@@ -428,6 +574,92 @@ void
 CBrowserWindow::
 setDocument(const CUrl &url)
 {
+  CBrowserTraceInst->reset();
+
+  loadTime_ = std::chrono::steady_clock::now();
+
+  newDocument(url);
+
+  {
+  CBrowserTraceScope("parse");
+
+  document_->read(url);
+  }
+
+  initDocument();
+}
+
+void
+CBrowserWindow::
+setDocumentDeferred(const CUrl &url)
+{
+  newDocument(url);
+
+  deferred_    = true;
+  deferredUrl_ = url;
+
+  // html, text, directory and image files are read in background (http downloads,
+  // scripts and missing files are read when shown)
+  if (url.isFile() && url.getTarget() == "" &&
+      CBrowserFileMgr::isBackgroundReadable(url.getFile())) {
+    CBrowserDocument *document = document_;
+
+    // errors are not reported from worker thread (dialogs and output are GUI thread only)
+    deferredRead_ = std::async(std::launch::async, [document, url]() {
+      CBrowserTraceScope("parse");
+
+      DeferredRead read;
+
+      read.rc = document->readFile(url, read.msg);
+
+      return read;
+    });
+  }
+}
+
+void
+CBrowserWindow::
+showDeferredDocument()
+{
+  if (! deferred_)
+    return;
+
+  deferred_ = false;
+
+  CBrowserTraceInst->reset();
+
+  loadTime_ = std::chrono::steady_clock::now();
+
+  if (deferredRead_.valid()) {
+    DeferredRead read = deferredRead_.get();
+
+    if (! read.rc)
+      displayError("%s", read.msg.c_str());
+  }
+  else {
+    CBrowserTraceScope("parse");
+
+    document_->read(deferredUrl_);
+  }
+
+  initDocument();
+}
+
+// replace current document with new empty document for url
+void
+CBrowserWindow::
+newDocument(const CUrl &url)
+{
+  // document being read in background is replaced
+  if (deferredRead_.valid())
+    deferredRead_.get();
+
+  // only built documents are cached
+  if (! deferred_)
+    cacheDocument();
+
+  deferred_ = false;
+
   reset();
 
   //---
@@ -435,9 +667,13 @@ setDocument(const CUrl &url)
   filename_ = url.getLocalFile();
 
   document_ = new CBrowserDocument(this);
+}
 
-  document_->read(url);
-
+// build, lay out and run scripts for read document
+void
+CBrowserWindow::
+initDocument()
+{
   document_->setDocument(CQJavaScriptInst->jsDocument());
 
   //---
@@ -450,6 +686,269 @@ setDocument(const CUrl &url)
 
   if (! history_->goTo(document_->getUrl()))
     history_->addUrl(document_->getUrl());
+
+  if (CBrowserTraceInst->isEnabled())
+    setStatus(CBrowserTraceInst->summary());
+}
+
+CBrowserWindow::CachedDocument::
+~CachedDocument()
+{
+  // javascript wrappers reference objects so unregister before delete
+  for (const auto &obj : objects)
+    obj->releaseJObj();
+
+  delete document;
+  delete layout;
+  delete linkMgr;
+  delete fileMgr;
+
+  // delete object trees (children are deleted by their parent)
+  Objects roots;
+
+  for (const auto &obj : objects) {
+    if (! obj->parent())
+      roots.push_back(obj);
+  }
+
+  for (const auto &root : roots)
+    delete root;
+}
+
+// move current document into back/forward cache (window is reset after)
+void
+CBrowserWindow::
+cacheDocument()
+{
+  if (! document_ || CBrowserMainInst->getDocCacheSize() <= 0)
+    return;
+
+  CachedDocumentP cachedDocument = std::make_shared<CachedDocument>();
+
+  const CUrl &url = document_->getUrl();
+
+  cachedDocument->url   = url;
+  cachedDocument->mtime = (url.isFile() ? fileMTime(url.getFile()) : -1);
+
+  cachedDocument->bytes = documentMemUsage();
+
+  cachedDocument->name         = name_;
+  cachedDocument->filename     = filename_;
+  cachedDocument->document     = document_;
+  cachedDocument->leftMargin   = leftMargin_;
+  cachedDocument->topMargin    = topMargin_;
+  cachedDocument->bbox         = bbox_;
+  cachedDocument->layout       = layout_;
+  cachedDocument->linkMgr      = linkMgr_;
+  cachedDocument->fileMgr      = fileMgr_;
+  cachedDocument->rootObject   = rootObject_;
+  cachedDocument->baseFontSize = baseFontSize_;
+
+  std::swap(cachedDocument->idObjects  , idObjects_  );
+  std::swap(cachedDocument->objStack   , objStack_   );
+  std::swap(cachedDocument->objects    , objects_    );
+  std::swap(cachedDocument->scripts    , scripts_    );
+  std::swap(cachedDocument->scriptFiles, scriptFiles_);
+  std::swap(cachedDocument->cssList    , cssList_    );
+
+  cachedDocument->htmlObjectsRegistered = htmlObjectsRegistered_;
+
+  // hide widgets of cached objects (shown by render when restored)
+  for (const auto &obj : cachedDocument->objects)
+    obj->hide();
+
+  if (swindow_) {
+    cachedDocument->scrollX = swindow_->getCanvasXOffset();
+    cachedDocument->scrollY = swindow_->getCanvasYOffset();
+  }
+
+  // now owned by cache
+  document_   = nullptr;
+  layout_     = nullptr;
+  linkMgr_    = nullptr;
+  fileMgr_    = nullptr;
+  rootObject_ = nullptr;
+
+  //---
+
+  // replace older copy of same url
+  for (auto p = cachedDocuments_.begin(); p != cachedDocuments_.end(); ++p) {
+    if ((*p)->url == url) {
+      cachedDocuments_.erase(p);
+
+      break;
+    }
+  }
+
+  cachedDocuments_.push_front(cachedDocument);
+
+  trimDocumentCache();
+}
+
+// swap in cached document for url (if still valid)
+bool
+CBrowserWindow::
+restoreDocument(const CUrl &url)
+{
+  auto p = cachedDocuments_.begin();
+
+  for ( ; p != cachedDocuments_.end(); ++p) {
+    if ((*p)->url == url)
+      break;
+  }
+
+  if (p == cachedDocuments_.end()) {
+    ++docCacheMisses_;
+    return false;
+  }
+
+  CachedDocumentP cachedDocument = *p;
+
+  cachedDocuments_.erase(p);
+
+  // file changed since it was cached
+  if (url.isFile() && fileMTime(url.getFile()) != cachedDocument->mtime) {
+    ++docCacheMisses_;
+    return false;
+  }
+
+  //---
+
+  CBrowserTraceInst->reset();
+
+  cacheDocument();
+
+  reset();
+
+  // reset creates new managers for empty document
+  delete layout_;
+  delete linkMgr_;
+  delete fileMgr_;
+
+  name_         = cachedDocument->name;
+  filename_     = cachedDocument->filename;
+  document_     = cachedDocument->document;
+  leftMargin_   = cachedDocument->leftMargin;
+  topMargin_    = cachedDocument->topMargin;
+  bbox_         = cachedDocument->bbox;
+  layout_       = cachedDocument->layout;
+  linkMgr_      = cachedDocument->linkMgr;
+  fileMgr_      = cachedDocument->fileMgr;
+  rootObject_   = cachedDocument->rootObject;
+  baseFontSize_ = cachedDocument->baseFontSize;
+
+  std::swap(idObjects_  , cachedDocument->idObjects  );
+  std::swap(objStack_   , cachedDocument->objStack   );
+  std::swap(objects_    , cachedDocument->objects    );
+  std::swap(scripts_    , cachedDocument->scripts    );
+  std::swap(scriptFiles_, cachedDocument->scriptFiles);
+  std::swap(cssList_    , cachedDocument->cssList    );
+
+  htmlObjectsRegistered_ = cachedDocument->htmlObjectsRegistered;
+
+  // now owned by window
+  cachedDocument->document   = nullptr;
+  cachedDocument->layout     = nullptr;
+  cachedDocument->linkMgr    = nullptr;
+  cachedDocument->fileMgr    = nullptr;
+  cachedDocument->rootObject = nullptr;
+
+  setBaseFontStyle();
+
+  //---
+
+  CQJavaScriptInst->jsDocument()->setIFace(document_->iface());
+
+  document_->setDocument(CQJavaScriptInst->jsDocument());
+
+  if (swindow_)
+    setTitle(document_->getTitle());
+
+  // layout is kept but window may have been resized since
+  recalc();
+
+  if (swindow_)
+    swindow_->scrollTo(cachedDocument->scrollX, cachedDocument->scrollY);
+
+  redraw();
+
+  //---
+
+  ++docCacheHits_;
+
+  size_t bytes = 0;
+
+  for (const auto &cachedDocument1 : cachedDocuments_)
+    bytes += cachedDocument1->bytes;
+
+  CBrowserTraceInst->setCounter("doc_cache_hits"     , docCacheHits_);
+  CBrowserTraceInst->setCounter("doc_cache_misses"   , docCacheMisses_);
+  CBrowserTraceInst->setCounter("doc_cache_documents", cachedDocuments_.size());
+  CBrowserTraceInst->setCounter("doc_cache_bytes"    , bytes);
+
+  setStatus("Restored from cache (" + std::to_string(cachedDocuments_.size()) +
+            " cached, " + std::to_string(bytes/1024) + "KB)");
+
+  return true;
+}
+
+// approximate memory of current document (tokens, objects, text, images and widgets)
+size_t
+CBrowserWindow::
+documentMemUsage() const
+{
+  size_t bytes = (document_ ? document_->memUsage() : 0);
+
+  for (const auto &obj : objects_)
+    bytes += obj->memUsage();
+
+  for (const auto &script : scripts_)
+    bytes += sizeof(script) + script.capacity();
+
+  bytes += cssList_.capacity()*sizeof(CSSData);
+
+  return bytes;
+}
+
+// evict least recently used documents over count or memory limit
+void
+CBrowserWindow::
+trimDocumentCache()
+{
+  // approximate memory limit for all cached documents
+  static const size_t maxBytes = 64*1024*1024;
+
+  size_t maxDocuments = std::max(CBrowserMainInst->getDocCacheSize(), 0);
+
+  size_t bytes = 0;
+
+  for (const auto &cachedDocument : cachedDocuments_)
+    bytes += cachedDocument->bytes;
+
+  while (! cachedDocuments_.empty() &&
+         (cachedDocuments_.size() > maxDocuments || bytes > maxBytes)) {
+    CachedDocumentP cachedDocument = cachedDocuments_.back();
+
+    cachedDocuments_.pop_back();
+
+    bytes -= cachedDocument->bytes;
+
+    ++docCacheEvictions_;
+
+    if (CBrowserMainInst->getDebug())
+      std::cerr << "Evict cached document '" << cachedDocument->url.getUrl() << "'" <<
+                   std::endl;
+  }
+
+  CBrowserTraceInst->setCounter("doc_cache_evictions", docCacheEvictions_);
+  CBrowserTraceInst->setCounter("doc_cache_documents", cachedDocuments_.size());
+  CBrowserTraceInst->setCounter("doc_cache_bytes"    , bytes);
+
+  if (CBrowserMainInst->getDebug())
+    std::cerr << "Document cache: " << cachedDocuments_.size() << " documents, " <<
+                 bytes/1024 << "KB, " << docCacheHits_ << " hits, " <<
+                 docCacheMisses_ << " misses, " << docCacheEvictions_ << " evictions" <<
+                 std::endl;
 }
 
 void
@@ -463,9 +962,33 @@ outputDocument()
 
   mouse_link_ = nullptr;
 
+  firstPainted_ = false;
+
   //---
 
-  processTokens(document_->tokens());
+  if (CBrowserMainInst->getIncremental() && ! CBrowserMainInst->getBatch())
+    processTokensIncremental(document_->tokens());
+  else
+    processTokens(document_->tokens());
+
+  // object and style bytes per object with shared style values and as if each object
+  // had its own copy of every style group
+  if (! objects_.empty() && (CBrowserTraceInst->isEnabled() || CBrowserMainInst->getDebug())) {
+    size_t bytes = 0, unsharedBytes = 0;
+
+    for (const auto &obj : objects_) {
+      bytes         += sizeof(CBrowserObject) + obj->styleMemUsage();
+      unsharedBytes += sizeof(CBrowserObject) + obj->unsharedStyleMemUsage();
+    }
+
+    CBrowserTraceInst->setCounter("object_bytes"         , bytes/objects_.size());
+    CBrowserTraceInst->setCounter("object_unshared_bytes", unsharedBytes/objects_.size());
+
+    if (CBrowserMainInst->getDebug())
+      std::cerr << "Objects: " << objects_.size() << ", bytes per object: " <<
+                   bytes/objects_.size() << " (unshared " <<
+                   unsharedBytes/objects_.size() << ")" << std::endl;
+  }
 
   //---
 
@@ -478,6 +1001,10 @@ outputDocument()
   //---
 
   resize();
+
+  // document fitted in first chunk (or was not output incrementally)
+  if (! firstPainted_)
+    recordFirstPaint();
 }
 
 void
@@ -497,7 +1024,11 @@ recalc()
 
   //------
 
+  {
+  CBrowserTraceScope("layout");
+
   layout_->layout(rootObject(), bbox_);
+  }
 
   //------
 
@@ -537,6 +1068,11 @@ resize()
 
   //---
 
+  // svg regions are only known after layout
+  renderSVGObjects();
+
+  //---
+
   redraw();
 }
 
@@ -633,6 +1169,8 @@ setBackgroundImage(const std::string &filename, bool fixed)
     return;
   }
 
+  CBrowserTraceScope("image");
+
   CImageFileSrc file(filename);
 
   CImagePtr image = CImageMgrInst->createImage(file);
@@ -666,6 +1204,8 @@ loadCSSFile(const CUrl &url)
     filename = url.getFile();
   }
 
+  CBrowserTraceScope("parse");
+
   CCSS css;
 
   if (! css.processFile(filename))
@@ -680,6 +1220,8 @@ bool
 CBrowserWindow::
 loadCSSText(const std::string &text)
 {
+  CBrowserTraceScope("parse");
+
   CCSS css;
 
   if (! css.processLine(text))
@@ -696,6 +1238,9 @@ bool
 CBrowserWindow::
 applyStyle(CBrowserObject *obj)
 {
+  // per object time is accumulated and added to trace once per token batch
+  CBrowserTraceAccumScope styleScope(styleTraceAccum_);
+
   CCSSTagDataP tagData(new CBrowserObjectCSSTagData(obj));
 
   bool rc = true;
@@ -850,12 +1395,14 @@ print()
   if (root)
     region = root->calcRegion();
 
-  double xmin = 0;
-  double ymin = 0;
-  double xmax = region.width () + 2*getLeftMargin();
-  double ymax = region.height() + 2*getTopMargin();
+  int width  = region.width () + 2*getLeftMargin();
+  int height = region.height() + 2*getTopMargin();
+
+  const std::string &filename = CBrowserMainInst->getPrintFile();
 
-  swindow_->print(xmin, ymin, xmax, ymax);
+  int numPages = swindow_->printPages(filename, width, height);
+
+  setStatus("Printed " + std::to_string(numPages) + " pages to '" + filename + "'");
 }
 
 void
@@ -872,7 +1419,8 @@ goBack()
   const CUrl &url = history_->goBack();
   if (! url.isValid()) return;
 
-  setDocument(url);
+  if (! restoreDocument(url))
+    setDocument(url);
 }
 
 void
@@ -882,7 +1430,8 @@ goForward()
   const CUrl &url = history_->goForward();
   if (! url.isValid()) return;
 
-  setDocument(url);
+  if (! restoreDocument(url))
+    setDocument(url);
 }
 
 bool
@@ -919,6 +1468,22 @@ activateLink(int x, int y)
   return true;
 }
 
+bool
+CBrowserWindow::
+activateInput(int x, int y)
+{
+  for (auto &obj : objects_) {
+    CBrowserFormInput *input = dynamic_cast<CBrowserFormInput *>(obj);
+
+    if (input && input->inside(x, y)) {
+      input->activate();
+      return true;
+    }
+  }
+
+  return false;
+}
+
 void
 CBrowserWindow::
 addHistoryItem(const CUrl &item)
@@ -1176,6 +1741,8 @@ bool
 CBrowserWindow::
 downloadFile(const CUrl &url, std::string &filename)
 {
+  CBrowserTraceScope("fetch");
+
   CWebGet webget(url);
 
   webget.setOverwrite(true);
@@ -6,6 +6,7 @@
 #include <CBrowserData.h>
 #include <CBrowserFont.h>
 #include <CBrowserObjectCSSTagData.h>
+#include <CBrowserTrace.h>
 #include <CQJWindow.h>
 #include <CQJWindowIFace.h>
 #include <CQJDocument.h>
@@ -13,6 +14,10 @@
 #include <CUrl.h>
 #include <CFont.h>
 #include <QImage>
+#include <chrono>
+#include <future>
+#include <list>
+#include <memory>
 
 class CBrowserScrolledWindow;
 
@@ -124,6 +129,10 @@ class CBrowserWindow {
   //---
 
   void addHtmlObject(CBrowserObject *obj);
+
+  // register javascript objects for all document objects (and objects added later)
+  // before javascript is run so lookups which walk the javascript registry find them
+  void registerHtmlObjects();
   CJValueP lookupHtmlObject(CBrowserObject *htmlObj) const;
 
   //---
@@ -146,6 +155,8 @@ class CBrowserWindow {
 
   void runScripts();
 
+  void renderSVGObjects();
+
   //---
 
   void close();
@@ -154,10 +165,24 @@ class CBrowserWindow {
 
   void setDocument(const CUrl &url);
 
+  // read document in background and defer output, layout and scripts until shown
+  void setDocumentDeferred(const CUrl &url);
+
+  bool isDeferred() const { return deferred_; }
+
+  // output deferred document (waits for background read to finish)
+  void showDeferredDocument();
+
   void outputDocument();
 
   void processTokens(const CHtmlParserTokens &tokens);
 
+  // output, lay out and paint tokens in chunks so start of document is shown early
+  void processTokensIncremental(const CHtmlParserTokens &tokens);
+
+  // record load to first paint time (first_paint_ms counter)
+  void recordFirstPaint();
+
   void layoutObjects();
 
   void resize();
@@ -211,6 +236,8 @@ class CBrowserWindow {
 
   bool activateLink(int x, int y);
 
+  bool activateInput(int x, int y);
+
   void addHistoryItem(const CUrl &item);
 
   CRGBA getBgColor();
@@ -273,6 +300,15 @@ class CBrowserWindow {
 
   void reset();
 
+  void newDocument(const CUrl &url);
+  void initDocument();
+
+  void cacheDocument();
+  bool restoreDocument(const CUrl &url);
+  void trimDocumentCache();
+
+  size_t documentMemUsage() const;
+
   void setPixmapSize(int width, int height);
 
   void redrawArea();
@@ -286,7 +322,44 @@ class CBrowserWindow {
   typedef std::vector<CBrowserObject*>            Objects;
   typedef std::vector<std::string>                Scripts;
   typedef std::vector<std::string>                ScriptFiles;
-  typedef std::map<CBrowserObject *, CJValueP>    ObjMap;
+
+  // built document (objects, layout, links and scroll position) kept for back/forward
+  struct CachedDocument {
+    CUrl              url;
+    long long         mtime { -1 };
+    size_t            bytes { 0 };
+    std::string       name;
+    std::string       filename;
+    CBrowserDocument* document { nullptr };
+    int               leftMargin { 0 };
+    int               topMargin { 0 };
+    CIBBox2D          bbox;
+    CBrowserLayout*   layout { nullptr };
+    CBrowserLinkMgr*  linkMgr { nullptr };
+    CBrowserFileMgr*  fileMgr { nullptr };
+    CBrowserObject*   rootObject { nullptr };
+    IdObjects         idObjects;
+    ObjStack          objStack;
+    Objects           objects;
+    Scripts           scripts;
+    ScriptFiles       scriptFiles;
+    CSSList           cssList;
+    bool              htmlObjectsRegistered { false };
+    int               baseFontSize { 0 };
+    int               scrollX { 0 };
+    int               scrollY { 0 };
+
+   ~CachedDocument();
+  };
+
+  // result of document read in background (error is reported when shown)
+  struct DeferredRead {
+    bool        rc { false };
+    std::string msg;
+  };
+
+  typedef std::shared_ptr<CachedDocument> CachedDocumentP;
+  typedef std::list<CachedDocumentP>      CachedDocuments;
 
   static WindowList          window_list_;
   static std::string         window_target_;
@@ -296,6 +369,12 @@ class CBrowserWindow {
   std::string             name_;
   std::string             filename_;
   CBrowserDocument*       document_ { nullptr };
+  std::chrono::steady_clock::time_point loadTime_;
+  bool                    firstPainted_ { false };
+  CBrowserTraceAccum      styleTraceAccum_ { "style" };
+  bool                    deferred_ { false };
+  CUrl                    deferredUrl_;
+  std::future<DeferredRead> deferredRead_;
   CQJWindowP              window_;
 
   CBrowserScrolledWindow* swindow_ { nullptr };
@@ -314,7 +393,7 @@ class CBrowserWindow {
   IdObjects               idObjects_;
   ObjStack                objStack_;
   Objects                 objects_;
-  ObjMap                  objMap_;
+  bool                    htmlObjectsRegistered_ { false };
   Scripts                 scripts_;
   ScriptFiles             scriptFiles_;
 
@@ -326,6 +405,11 @@ class CBrowserWindow {
   int                     baseFontSize_ { 0 };
 
   CBrowserHistory*        history_ { nullptr };
+
+  CachedDocuments         cachedDocuments_;       // most recently used first
+  int                     docCacheHits_ { 0 };
+  int                     docCacheMisses_ { 0 };
+  int                     docCacheEvictions_ { 0 };
 };
 
 #endif
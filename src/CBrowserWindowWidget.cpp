@@ -108,6 +108,9 @@ void
 CBrowserWindowWidget::
 callEventListener(const std::string &name, const std::string &prop, CJValueP event)
 {
+  // listeners may look up any object
+  window_->getWindow()->registerHtmlObjects();
+
   CQJObject::EventArgs  args;
   CQJObject::NameValues nameValues;
 
@@ -156,9 +159,38 @@ setXDevice()
 
 void
 CBrowserWindowWidget::
-setPSDevice(double xmin, double ymin, double xmax, double ymax)
+setPSDevice(double xmin, double ymin, double xmax, double ymax, const std::string &filename)
+{
+  graphics_->setPSDevice(xmin, ymin, xmax, ymax, filename);
+}
+
+void
+CBrowserWindowWidget::
+setPSPageDevice(const std::string &filename, int pageWidth, int pageHeight,
+                int paperWidth, int paperHeight)
+{
+  graphics_->setPSPageDevice(filename, pageWidth, pageHeight, paperWidth, paperHeight);
+}
+
+void
+CBrowserWindowWidget::
+startPSPage(int pageNum)
+{
+  graphics_->startPSPage(pageNum);
+}
+
+void
+CBrowserWindowWidget::
+endPSPage()
+{
+  graphics_->endPSPage();
+}
+
+void
+CBrowserWindowWidget::
+setImageDevice(QImage *image)
 {
-  graphics_->setPSDevice(xmin, ymin, xmax, ymax);
+  graphics_->setImageDevice(image);
 }
 
 void
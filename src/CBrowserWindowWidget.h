@@ -34,7 +34,15 @@ class CBrowserWindowWidget : public QWidget {
   void saveImage(const std::string &filename);
 
   void setXDevice();
-  void setPSDevice(double xmin, double ymin, double xmax, double ymax);
+  void setPSDevice(double xmin, double ymin, double xmax, double ymax,
+                   const std::string &filename="/tmp/ps.out");
+  void setImageDevice(QImage *image);
+
+  void setPSPageDevice(const std::string &filename, int pageWidth, int pageHeight,
+                       int paperWidth, int paperHeight);
+
+  void startPSPage(int pageNum);
+  void endPSPage();
 
   void clear(const CRGBA &bg);
 
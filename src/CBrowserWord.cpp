@@ -78,7 +78,7 @@ width() const
   else if (type_ == Type::IMAGE)
     return image_->getWidth();
   else if (type_ == Type::INPUT)
-    return inputObj()->calcRegion().width();
+    return inputObj()->region().width();
   else
     return 0;
 }
@@ -94,7 +94,7 @@ ascent() const
   else if (type_ == Type::IMAGE)
     return image_->getHeight();
   else if (type_ == Type::INPUT)
-    return inputObj()->calcRegion().height();
+    return inputObj()->region().height();
   else
     return 0;
 }
@@ -7,7 +7,7 @@ CBrowserXmp(CBrowserWindow *window) :
 {
   setDisplay(Display::BLOCK);
 
-  font_.setFamily(CBrowserFontFamily("monospace"));
+  fontRef().setFamily(CBrowserFontFamily("monospace"));
 
   marginRef().setTop   (CBrowserUnitValue("1em"));
   marginRef().setBottom(CBrowserUnitValue("1em"));
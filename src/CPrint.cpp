@@ -4,6 +4,9 @@
 #include <CImageLib.h>
 #include <COSTime.h>
 
+#include <QByteArray>
+#include <algorithm>
+
 #define MAX_DATE_STRING_LEN 256
 
 #define COURIER_N    "Courier"
@@ -102,8 +105,14 @@ CPrint() :
   page_width_  = 600;
   page_height_ = 800;
 
+  paper_width_  = 0;
+  paper_height_ = 0;
+
   has_range_ = false;
 
+  per_page_ = 1;
+  orient_   = PORTRAIT;
+
   xmin_ = 1.0;
   ymin_ = 1.0;
   xmax_ = 2.0;
@@ -126,17 +135,22 @@ CPrint() :
   output_color_  = true;
   output_depth_  = 4;
   output_invert_ = false;
+
+  language_level_ = 3;
 }
 
 CPrint::
 ~CPrint()
 {
+  flush();
 }
 
 bool
 CPrint::
 setFilename(const std::string &filename)
 {
+  flush();
+
   file_ = 0;
 
   filename_ = filename;
@@ -154,6 +168,8 @@ void
 CPrint::
 setFile(FILE *fp)
 {
+  flush();
+
   file_ = new CFile(fp);
 }
 
@@ -171,6 +187,20 @@ setTitle(const std::string &title)
   title_ = title;
 }
 
+void
+CPrint::
+setPageSize(int width, int height)
+{
+  page_width_  = width;
+  page_height_ = height;
+
+  // images are flipped in page (if no plot range)
+  if (! has_range_) {
+    width_  = width;
+    height_ = height;
+  }
+}
+
 void
 CPrint::
 setSize(double xmin, double ymin, double xmax, double ymax)
@@ -193,6 +223,8 @@ init()
   if (! file_)
     file_ = new CFile(filename_);
 
+  image_names_.clear();
+
   writeHeader();
 }
 
@@ -202,6 +234,8 @@ term()
 {
   writeFooter();
 
+  flush();
+
   file_ = 0;
 }
 
@@ -215,46 +249,53 @@ writeHeader()
 
   std::string s;
 
-  file_->write("%!PS-Adobe-1.0\n");
-  file_->write("%%Creator: " + creator_ + "\n");
-  file_->write("%%Title: " + title_ + "\n");
-  file_->write("%%CreationDate: "+ date_str);
-  file_->write("\n");
+  write("%!PS-Adobe-1.0\n");
+  write("%%Creator: " + creator_ + "\n");
+  write("%%Title: " + title_ + "\n");
+  write("%%CreationDate: "+ date_str);
+  write("\n");
+
+  if (language_level_ >= 2)
+    write("%%LanguageLevel: " + CStrUtil::toString(language_level_) + "\n");
 
-  file_->write("%%DocumentFonts: ");
-  file_->write(s + COURIER_N   + " " + COURIER_B   + " " + COURIER_I   + " " + COURIER_BI   + " ");
-  file_->write(s + HELVETICA_N + " " + HELVETICA_B + " " + HELVETICA_I + " " + HELVETICA_BI + " ");
-  file_->write(s + TIMES_N     + " " + TIMES_B     + " " + TIMES_I     + " " + TIMES_BI     + " ");
-  file_->write(s + SYMBOL_N + "\n");
+  write("%%DocumentFonts: ");
+  write(s + COURIER_N   + " " + COURIER_B   + " " + COURIER_I   + " " + COURIER_BI   + " ");
+  write(s + HELVETICA_N + " " + HELVETICA_B + " " + HELVETICA_I + " " + HELVETICA_BI + " ");
+  write(s + TIMES_N     + " " + TIMES_B     + " " + TIMES_I     + " " + TIMES_BI     + " ");
+  write(s + SYMBOL_N + "\n");
 
-  file_->write("%%EndComments\n");
+  write("%%EndComments\n");
 
   /*------*/
 
-  file_->write(s + "/FontCN  /" + COURIER_N    + " findfont def\n");
-  file_->write(s + "/FontCB  /" + COURIER_B    + " findfont def\n");
-  file_->write(s + "/FontCI  /" + COURIER_I    + " findfont def\n");
-  file_->write(s + "/FontCBI /" + COURIER_BI   + " findfont def\n");
-  file_->write(s + "/FontHN  /" + HELVETICA_N  + " findfont def\n");
-  file_->write(s + "/FontHB  /" + HELVETICA_B  + " findfont def\n");
-  file_->write(s + "/FontHI  /" + HELVETICA_I  + " findfont def\n");
-  file_->write(s + "/FontHBI /" + HELVETICA_BI + " findfont def\n");
-  file_->write(s + "/FontTN  /" + TIMES_N      + " findfont def\n");
-  file_->write(s + "/FontTB  /" + TIMES_B      + " findfont def\n");
-  file_->write(s + "/FontTI  /" + TIMES_I      + " findfont def\n");
-  file_->write(s + "/FontTBI /" + TIMES_BI     + " findfont def\n");
-  file_->write(s + "/FontSN  /" + SYMBOL_N     + " findfont def\n");
+  write(s + "/FontCN  /" + COURIER_N    + " findfont def\n");
+  write(s + "/FontCB  /" + COURIER_B    + " findfont def\n");
+  write(s + "/FontCI  /" + COURIER_I    + " findfont def\n");
+  write(s + "/FontCBI /" + COURIER_BI   + " findfont def\n");
+  write(s + "/FontHN  /" + HELVETICA_N  + " findfont def\n");
+  write(s + "/FontHB  /" + HELVETICA_B  + " findfont def\n");
+  write(s + "/FontHI  /" + HELVETICA_I  + " findfont def\n");
+  write(s + "/FontHBI /" + HELVETICA_BI + " findfont def\n");
+  write(s + "/FontTN  /" + TIMES_N      + " findfont def\n");
+  write(s + "/FontTB  /" + TIMES_B      + " findfont def\n");
+  write(s + "/FontTI  /" + TIMES_I      + " findfont def\n");
+  write(s + "/FontTBI /" + TIMES_BI     + " findfont def\n");
+  write(s + "/FontSN  /" + SYMBOL_N     + " findfont def\n");
 
   /*------*/
 
+  if (paper_width_ > 0 && paper_height_ > 0 && language_level_ >= 2)
+    write("<< /PageSize [" + CStrUtil::toString(paper_width_) + " " +
+          CStrUtil::toString(paper_height_) + "] >> setpagedevice\n");
+
   /* Calculate Page Bounding Box */
 
-  file_->write("clippath pathbbox\n");
-  file_->write("/YMax exch def\n");
-  file_->write("/XMax exch def\n");
-  file_->write("/YMin exch def\n");
-  file_->write("/XMin exch def\n");
-  file_->write("newpath\n");
+  write("clippath pathbbox\n");
+  write("/YMax exch def\n");
+  write("/XMax exch def\n");
+  write("/YMin exch def\n");
+  write("/XMin exch def\n");
+  write("newpath\n");
 
   /*------*/
 
@@ -264,197 +305,197 @@ writeHeader()
 
   if (! has_range_) {
     if      (per_page_ == 4) {
-      file_->write("/HSpace XMax YMin sub 20 div def\n");
-      file_->write("/VSpace YMax YMin sub 20 div def\n");
+      write("/HSpace XMax YMin sub 20 div def\n");
+      write("/VSpace YMax YMin sub 20 div def\n");
 
-      file_->write("/Width  XMax XMin sub HSpace sub 2 div def\n");
-      file_->write("/Height YMax YMin sub VSpace sub 2 div def\n");
+      write("/Width  XMax XMin sub HSpace sub 2 div def\n");
+      write("/Height YMax YMin sub VSpace sub 2 div def\n");
 
       if (orient_ == PORTRAIT) {
-        file_->write("/XScale Width  " + CStrUtil::toString(page_width_ ) + " div def\n");
-        file_->write("/YScale Height " + CStrUtil::toString(page_height_) + " div def\n");
+        write("/XScale Width  " + CStrUtil::toString(page_width_ ) + " div def\n");
+        write("/YScale Height " + CStrUtil::toString(page_height_) + " div def\n");
       }
       else {
-        file_->write("/XScale Height " + CStrUtil::toString(page_width_ ) + " div def\n");
-        file_->write("/YScale Width  " + CStrUtil::toString(page_height_) + " div def\n");
+        write("/XScale Height " + CStrUtil::toString(page_width_ ) + " div def\n");
+        write("/YScale Width  " + CStrUtil::toString(page_height_) + " div def\n");
       }
 
-      file_->write("XScale YScale lt\n");
-      file_->write(" { /Scale XScale def }\n");
-      file_->write(" { /Scale YScale def }\n");
-      file_->write("ifelse\n");
+      write("XScale YScale lt\n");
+      write(" { /Scale XScale def }\n");
+      write(" { /Scale YScale def }\n");
+      write("ifelse\n");
 
-      file_->write("Scale 1 gt\n");
-      file_->write(" { /Scale 1 def }\n");
-      file_->write("if\n");
+      write("Scale 1 gt\n");
+      write(" { /Scale 1 def }\n");
+      write("if\n");
 
       if (orient_ == PORTRAIT) {
-        file_->write("/XOffset Width  " + CStrUtil::toString(page_width_) +
+        write("/XOffset Width  " + CStrUtil::toString(page_width_) +
                      " Scale mul sub 2 div def\n");
-        file_->write("/YOffset Height " + CStrUtil::toString(page_height_) +
+        write("/YOffset Height " + CStrUtil::toString(page_height_) +
                      " Scale mul sub 2 div def\n");
       }
       else {
-        file_->write("/XOffset Height " + CStrUtil::toString(page_width_) +
+        write("/XOffset Height " + CStrUtil::toString(page_width_) +
                      " Scale mul sub 2 div def\n");
-        file_->write("/YOffset Width  " + CStrUtil::toString(page_height_) +
+        write("/YOffset Width  " + CStrUtil::toString(page_height_) +
                      " Scale mul sub 2 div def\n");
       }
     }
     else if (per_page_ == 2) {
-      file_->write("/VSpace YMax YMin sub 20 div def\n");
+      write("/VSpace YMax YMin sub 20 div def\n");
 
-      file_->write("/Width  XMax XMin sub def\n");
-      file_->write("/Height YMax YMin sub VSpace sub 2 div def\n");
+      write("/Width  XMax XMin sub def\n");
+      write("/Height YMax YMin sub VSpace sub 2 div def\n");
 
       if (orient_ == PORTRAIT) {
-        file_->write("/XScale Height " + CStrUtil::toString(page_width_ ) + " div def\n");
-        file_->write("/YScale Width  " + CStrUtil::toString(page_height_) + " div def\n");
+        write("/XScale Height " + CStrUtil::toString(page_width_ ) + " div def\n");
+        write("/YScale Width  " + CStrUtil::toString(page_height_) + " div def\n");
       }
       else {
-        file_->write("/XScale Width  " + CStrUtil::toString(page_width_ ) + " div def\n");
-        file_->write("/YScale Height " + CStrUtil::toString(page_height_) + " div def\n");
+        write("/XScale Width  " + CStrUtil::toString(page_width_ ) + " div def\n");
+        write("/YScale Height " + CStrUtil::toString(page_height_) + " div def\n");
       }
 
-      file_->write("XScale YScale lt\n");
-      file_->write(" { /Scale XScale def }\n");
-      file_->write(" { /Scale YScale def }\n");
-      file_->write("ifelse\n");
+      write("XScale YScale lt\n");
+      write(" { /Scale XScale def }\n");
+      write(" { /Scale YScale def }\n");
+      write("ifelse\n");
 
-      file_->write("Scale 1 gt\n");
-      file_->write(" { /Scale 1 def }\n");
-      file_->write("if\n");
+      write("Scale 1 gt\n");
+      write(" { /Scale 1 def }\n");
+      write("if\n");
 
       if (orient_ == PORTRAIT) {
-        file_->write("/XOffset Height " + CStrUtil::toString(page_width_) +
+        write("/XOffset Height " + CStrUtil::toString(page_width_) +
                      " Scale mul sub 2 div def\n");
-        file_->write("/YOffset Width  " + CStrUtil::toString(page_height_) +
+        write("/YOffset Width  " + CStrUtil::toString(page_height_) +
                      " Scale mul sub 2 div def\n");
       }
       else {
-        file_->write("/XOffset Width  " + CStrUtil::toString(page_width_) +
+        write("/XOffset Width  " + CStrUtil::toString(page_width_) +
                      " Scale mul sub 2 div def\n");
-        file_->write("/YOffset Height " + CStrUtil::toString(page_height_) +
+        write("/YOffset Height " + CStrUtil::toString(page_height_) +
                      " Scale mul sub 2 div def\n");
       }
     }
     else {
-      file_->write("/Width  XMax XMin sub def\n");
-      file_->write("/Height YMax YMin sub def\n");
+      write("/Width  XMax XMin sub def\n");
+      write("/Height YMax YMin sub def\n");
 
       if (orient_ == PORTRAIT) {
-        file_->write("/XScale Width  " + CStrUtil::toString(page_width_ ) + " div def\n");
-        file_->write("/YScale Height " + CStrUtil::toString(page_height_) + " div def\n");
+        write("/XScale Width  " + CStrUtil::toString(page_width_ ) + " div def\n");
+        write("/YScale Height " + CStrUtil::toString(page_height_) + " div def\n");
       }
       else {
-        file_->write("/XScale Height " + CStrUtil::toString(page_width_ ) + " div def\n");
-        file_->write("/YScale Width  " + CStrUtil::toString(page_height_) + " div def\n");
+        write("/XScale Height " + CStrUtil::toString(page_width_ ) + " div def\n");
+        write("/YScale Width  " + CStrUtil::toString(page_height_) + " div def\n");
       }
 
-      file_->write("XScale YScale lt\n");
-      file_->write(" { /Scale XScale def }\n");
-      file_->write(" { /Scale YScale def }\n");
-      file_->write("ifelse\n");
+      write("XScale YScale lt\n");
+      write(" { /Scale XScale def }\n");
+      write(" { /Scale YScale def }\n");
+      write("ifelse\n");
 
-      file_->write("Scale 1 gt\n");
-      file_->write(" { /Scale 1 def }\n");
-      file_->write("if\n");
+      write("Scale 1 gt\n");
+      write(" { /Scale 1 def }\n");
+      write("if\n");
 
       /* Set Page Offset */
 
       if (orient_ == PORTRAIT) {
-        file_->write("/XOffset Width  " + CStrUtil::toString(page_width_) +
+        write("/XOffset Width  " + CStrUtil::toString(page_width_) +
                      " Scale mul sub 2 div def\n");
-        file_->write("/YOffset Height " + CStrUtil::toString(page_height_) +
+        write("/YOffset Height " + CStrUtil::toString(page_height_) +
                      " Scale mul sub 2 div def\n");
       }
       else {
-        file_->write("/XOffset Height " + CStrUtil::toString(page_width_) +
+        write("/XOffset Height " + CStrUtil::toString(page_width_) +
                      " Scale mul sub 2 div def\n");
-        file_->write("/YOffset Width  " + CStrUtil::toString(page_height_) +
+        write("/YOffset Width  " + CStrUtil::toString(page_height_) +
                      " Scale mul sub 2 div def\n");
       }
     }
   }
   else {
-    file_->write("/Width  XMax XMin sub def\n");
-    file_->write("/Height YMax YMin sub def\n");
+    write("/Width  XMax XMin sub def\n");
+    write("/Height YMax YMin sub def\n");
 
-    file_->write("/PlotXMin " + CStrUtil::toString(xmin_) + " def\n");
-    file_->write("/PlotYMin " + CStrUtil::toString(ymin_) + " def\n");
-    file_->write("/PlotXMax " + CStrUtil::toString(xmax_) + " def\n");
-    file_->write("/PlotYMax " + CStrUtil::toString(ymax_) + " def\n");
+    write("/PlotXMin " + CStrUtil::toString(xmin_) + " def\n");
+    write("/PlotYMin " + CStrUtil::toString(ymin_) + " def\n");
+    write("/PlotXMax " + CStrUtil::toString(xmax_) + " def\n");
+    write("/PlotYMax " + CStrUtil::toString(ymax_) + " def\n");
 
-    file_->write("/PlotWidth  PlotXMax PlotXMin sub def\n");
-    file_->write("/PlotHeight PlotYMax PlotYMin sub def\n");
+    write("/PlotWidth  PlotXMax PlotXMin sub def\n");
+    write("/PlotHeight PlotYMax PlotYMin sub def\n");
 
     /*------*/
 
     aspect = width_/height_;
 
     if (aspect <= 1.0) {
-      file_->write("/XScale Width  PlotWidth  div def\n");
-      file_->write("/YScale Height PlotHeight div def\n");
+      write("/XScale Width  PlotWidth  div def\n");
+      write("/YScale Height PlotHeight div def\n");
     }
     else {
-      file_->write("/XScale Height PlotWidth  div def\n");
-      file_->write("/YScale Width  PlotHeight div def\n");
+      write("/XScale Height PlotWidth  div def\n");
+      write("/YScale Width  PlotHeight div def\n");
     }
 
-    file_->write("XScale YScale lt\n");
-    file_->write(" { /Scale XScale def }\n");
-    file_->write(" { /Scale YScale def }\n");
-    file_->write("ifelse\n");
+    write("XScale YScale lt\n");
+    write(" { /Scale XScale def }\n");
+    write(" { /Scale YScale def }\n");
+    write("ifelse\n");
 
     if (aspect <= 1.0) {
-      file_->write("/XOffset Width  PlotWidth  Scale mul sub 2 div def\n");
-      file_->write("/YOffset Height PlotHeight Scale mul sub 2 div def\n");
+      write("/XOffset Width  PlotWidth  Scale mul sub 2 div def\n");
+      write("/YOffset Height PlotHeight Scale mul sub 2 div def\n");
     }
     else {
-      file_->write("/XOffset Height PlotWidth  Scale mul sub 2 div def\n");
-      file_->write("/YOffset Width  PlotHeight Scale mul sub 2 div def\n");
+      write("/XOffset Height PlotWidth  Scale mul sub 2 div def\n");
+      write("/YOffset Width  PlotHeight Scale mul sub 2 div def\n");
     }
   }
 
   /*------*/
 
-  file_->write("%%EndProlog\n");
+  write("%%EndProlog\n");
 
   /*------*/
 
 #if 0
-  file_->write("%%Page: 1 1\n");
+  write("%%Page: 1 1\n");
 #endif
 
   /*------*/
 
   if (has_range_) {
     if (aspect <= 1.0) {
-      file_->write("XMin YMin translate\n");
-      file_->write("XOffset YOffset translate\n");
-      file_->write("Scale dup scale\n");
-      file_->write("PlotXMin neg PlotYMin neg translate\n");
+      write("XMin YMin translate\n");
+      write("XOffset YOffset translate\n");
+      write("Scale dup scale\n");
+      write("PlotXMin neg PlotYMin neg translate\n");
     }
     else {
-      file_->write("XMax YMin translate\n");
-      file_->write("YOffset neg XOffset translate\n");
-      file_->write("Scale dup scale\n");
-      file_->write("90 rotate\n");
-      file_->write("PlotXMin neg PlotYMin neg translate\n");
+      write("XMax YMin translate\n");
+      write("YOffset neg XOffset translate\n");
+      write("Scale dup scale\n");
+      write("90 rotate\n");
+      write("PlotXMin neg PlotYMin neg translate\n");
     }
 
     /*------*/
 
-    file_->write("PlotXMin PlotYMin moveto\n");
-    file_->write("PlotXMax PlotYMin lineto\n");
-    file_->write("PlotXMax PlotYMax lineto\n");
-    file_->write("PlotXMin PlotYMax lineto\n");
-    file_->write("clip newpath\n");
+    write("PlotXMin PlotYMin moveto\n");
+    write("PlotXMax PlotYMin lineto\n");
+    write("PlotXMax PlotYMax lineto\n");
+    write("PlotXMin PlotYMax lineto\n");
+    write("clip newpath\n");
   }
 
   /*------*/
 
-  file_->write("true setstrokeadjust\n");
+  write("true setstrokeadjust\n");
 
   /*------*/
 
@@ -472,9 +513,9 @@ CPrint::
 writeFooter(bool showpage)
 {
   if (showpage)
-    file_->write("showpage\n");
+    write("showpage\n");
 
-  file_->write("%%Trailer\n");
+  write("%%Trailer\n");
 
   active_ = false;
 }
@@ -487,172 +528,172 @@ startPage(int page_no1, int page_no2)
     if (orient_ == PORTRAIT) {
       if     (page_no2 % 4 == 1) {
         if (page_no1 > 1)
-          file_->write("showpage\n");
+          write("showpage\n");
 
-        file_->write("%%%%Page: " + CStrUtil::toString(page_no1) + " " +
+        write("%%Page: " + CStrUtil::toString(page_no1) + " " +
                      CStrUtil::toString(page_no1) + "\n");
 
-        file_->write("1 setlinewidth\n");
-        file_->write("XMin YMin YMax add 2 div moveto\n");
-        file_->write("XMax YMin YMax add 2 div lineto\n");
-        file_->write("stroke\n");
-        file_->write("XMin XMax add 2 div YMin moveto\n");
-        file_->write("XMin XMax add 2 div YMax lineto\n");
-        file_->write("stroke\n");
+        write("1 setlinewidth\n");
+        write("XMin YMin YMax add 2 div moveto\n");
+        write("XMax YMin YMax add 2 div lineto\n");
+        write("stroke\n");
+        write("XMin XMax add 2 div YMin moveto\n");
+        write("XMin XMax add 2 div YMax lineto\n");
+        write("stroke\n");
 
-        file_->write("/NewX 0 def\n");
-        file_->write("/NewY Height VSpace add def\n");
+        write("/NewX 0 def\n");
+        write("/NewY Height VSpace add def\n");
       }
       else if (page_no2 % 4 == 2) {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewX Width HSpace add def\n");
-        file_->write("/NewY Height VSpace add def\n");
+        write("/NewX Width HSpace add def\n");
+        write("/NewY Height VSpace add def\n");
       }
       else if (page_no2 % 4 == 3) {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewX 0 def\n");
-        file_->write("/NewY 0 def\n");
+        write("/NewX 0 def\n");
+        write("/NewY 0 def\n");
       }
       else {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewX Width HSpace add def\n");
-        file_->write("/NewY 0 def\n");
+        write("/NewX Width HSpace add def\n");
+        write("/NewY 0 def\n");
       }
 
-      file_->write("XMin YMin translate\n");
-      file_->write("NewX NewY translate\n");
-      file_->write("XOffset YOffset translate\n");
-      file_->write("Scale dup scale\n");
+      write("XMin YMin translate\n");
+      write("NewX NewY translate\n");
+      write("XOffset YOffset translate\n");
+      write("Scale dup scale\n");
     }
     else {
       if     (page_no2 % 4 == 1) {
         if (page_no1 > 1)
-          file_->write("showpage\n");
+          write("showpage\n");
 
-        file_->write("%%%%Page: " + CStrUtil::toString(page_no1) + " " +
+        write("%%Page: " + CStrUtil::toString(page_no1) + " " +
                      CStrUtil::toString(page_no1) + "\n");
 
-        file_->write("1 setlinewidth\n");
-        file_->write("XMin YMin YMax add 2 div moveto\n");
-        file_->write("XMax YMin YMax add 2 div lineto\n");
-        file_->write("stroke\n");
-        file_->write("XMin XMax add 2 div YMin moveto\n");
-        file_->write("XMin XMax add 2 div YMax lineto\n");
-        file_->write("stroke\n");
+        write("1 setlinewidth\n");
+        write("XMin YMin YMax add 2 div moveto\n");
+        write("XMax YMin YMax add 2 div lineto\n");
+        write("stroke\n");
+        write("XMin XMax add 2 div YMin moveto\n");
+        write("XMin XMax add 2 div YMax lineto\n");
+        write("stroke\n");
 
-        file_->write("/NewX Width HSpace add def\n");
-        file_->write("/NewY 0 def\n");
+        write("/NewX Width HSpace add def\n");
+        write("/NewY 0 def\n");
       }
       else if (page_no2 % 4 == 2) {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewX 0 def\n");
-        file_->write("/NewY 0 def\n");
+        write("/NewX 0 def\n");
+        write("/NewY 0 def\n");
       }
       else if (page_no2 % 4 == 3) {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewX Width HSpace add def\n");
-        file_->write("/NewY Height VSpace add def\n");
+        write("/NewX Width HSpace add def\n");
+        write("/NewY Height VSpace add def\n");
       }
       else {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewX 0 def\n");
-        file_->write("/NewY Height VSpace add def\n");
+        write("/NewX 0 def\n");
+        write("/NewY Height VSpace add def\n");
       }
 
-      file_->write("XMax YMin translate\n");
-      file_->write("NewX neg NewY translate\n");
-      file_->write("YOffset neg XOffset translate\n");
-      file_->write("Scale dup scale\n");
-      file_->write("90 rotate\n");
+      write("XMax YMin translate\n");
+      write("NewX neg NewY translate\n");
+      write("YOffset neg XOffset translate\n");
+      write("Scale dup scale\n");
+      write("90 rotate\n");
     }
   }
   else if (per_page_ == 2) {
     if (orient_ == PORTRAIT) {
       if (page_no2 & 1) {
         if (page_no1 > 1)
-          file_->write("showpage\n");
+          write("showpage\n");
 
-        file_->write("%%%%Page: " + CStrUtil::toString(page_no1) + " " +
+        write("%%Page: " + CStrUtil::toString(page_no1) + " " +
                      CStrUtil::toString(page_no1) + "\n");
 
-        file_->write("1 setlinewidth\n");
-        file_->write("XMin YMin YMax add 2 div moveto\n");
-        file_->write("XMax YMin YMax add 2 div lineto\n");
-        file_->write("stroke\n");
+        write("1 setlinewidth\n");
+        write("XMin YMin YMax add 2 div moveto\n");
+        write("XMax YMin YMax add 2 div lineto\n");
+        write("stroke\n");
 
-        file_->write("/NewY 0 def\n");
+        write("/NewY 0 def\n");
       }
       else {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewY Height VSpace add def\n");
+        write("/NewY Height VSpace add def\n");
       }
 
-      file_->write("XMax YMin translate\n");
-      file_->write("0 NewY translate\n");
-      file_->write("YOffset neg XOffset translate\n");
-      file_->write("Scale dup scale\n");
-      file_->write("90 rotate\n");
+      write("XMax YMin translate\n");
+      write("0 NewY translate\n");
+      write("YOffset neg XOffset translate\n");
+      write("Scale dup scale\n");
+      write("90 rotate\n");
     }
     else {
       if (page_no2 & 1) {
         if (page_no1 > 1)
-          file_->write("showpage\n");
+          write("showpage\n");
 
-        file_->write("%%%%Page: " + CStrUtil::toString(page_no1) + " " +
+        write("%%Page: " + CStrUtil::toString(page_no1) + " " +
                      CStrUtil::toString(page_no1) + "\n");
 
-        file_->write("1 setlinewidth\n");
-        file_->write("XMin YMin YMax add 2 div moveto\n");
-        file_->write("XMax YMin YMax add 2 div lineto\n");
-        file_->write("stroke\n");
+        write("1 setlinewidth\n");
+        write("XMin YMin YMax add 2 div moveto\n");
+        write("XMax YMin YMax add 2 div lineto\n");
+        write("stroke\n");
 
-        file_->write("/NewY Height VSpace add def\n");
+        write("/NewY Height VSpace add def\n");
       }
       else {
-        file_->write("initgraphics\n");
+        write("initgraphics\n");
 
-        file_->write("/NewY 0 def\n");
+        write("/NewY 0 def\n");
       }
 
-      file_->write("XMin YMin translate\n");
-      file_->write("0 NewY translate\n");
-      file_->write("XOffset YOffset translate\n");
-      file_->write("Scale dup scale\n");
+      write("XMin YMin translate\n");
+      write("0 NewY translate\n");
+      write("XOffset YOffset translate\n");
+      write("Scale dup scale\n");
     }
   }
   else {
     if (page_no1 > 1)
-      file_->write("showpage\n");
+      write("showpage\n");
 
-    file_->write("%%%%Page: " + CStrUtil::toString(page_no1) + " " +
+    write("%%Page: " + CStrUtil::toString(page_no1) + " " +
                  CStrUtil::toString(page_no1) + "\n");
 
     if (orient_ == PORTRAIT) {
-      file_->write("XMin YMin translate\n");
-      file_->write("XOffset YOffset translate\n");
-      file_->write("Scale dup scale\n");
+      write("XMin YMin translate\n");
+      write("XOffset YOffset translate\n");
+      write("Scale dup scale\n");
     }
     else {
-      file_->write("XMax YMin translate\n");
-      file_->write("YOffset neg XOffset translate\n");
-      file_->write("Scale dup scale\n");
-      file_->write("90 rotate\n");
+      write("XMax YMin translate\n");
+      write("YOffset neg XOffset translate\n");
+      write("Scale dup scale\n");
+      write("90 rotate\n");
     }
   }
 
-  file_->write("0 0 moveto\n");
-  file_->write(CStrUtil::toString(page_width_) + " 0 lineto\n");
-  file_->write(CStrUtil::toString(page_width_) + " " +
+  write("0 0 moveto\n");
+  write(CStrUtil::toString(page_width_) + " 0 lineto\n");
+  write(CStrUtil::toString(page_width_) + " " +
                CStrUtil::toString(page_height_) + " lineto\n");
-  file_->write("0 " + CStrUtil::toString(page_height_) + " lineto\n");
-  file_->write("clip newpath\n");
+  write("0 " + CStrUtil::toString(page_height_) + " lineto\n");
+  write("clip newpath\n");
 }
 
 void
@@ -697,19 +738,19 @@ drawArc(double x, double y, double xr, double, double angle1, double angle2)
 {
   assert(active_);
 
-  file_->write("newpath ");
-  file_->write(CStrUtil::toString(x));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(xr));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(angle1));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(angle1 + angle2));
-  file_->write(" ");
-  file_->write(angle2 > 0 ? "arc" : "arcn");
-  file_->write(" closepath stroke\n");
+  write("newpath ");
+  write(CStrUtil::toString(x));
+  write(" ");
+  write(CStrUtil::toString(y));
+  write(" ");
+  write(CStrUtil::toString(xr));
+  write(" ");
+  write(CStrUtil::toString(angle1));
+  write(" ");
+  write(CStrUtil::toString(angle1 + angle2));
+  write(" ");
+  write(angle2 > 0 ? "arc" : "arcn");
+  write(" closepath stroke\n");
 }
 
 void
@@ -718,19 +759,19 @@ fillArc(double x, double y, double xr, double, double angle1, double angle2)
 {
   assert(active_);
 
-  file_->write("newpath ");
-  file_->write(CStrUtil::toString(x));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(xr));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(angle1));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(angle1 + angle2));
-  file_->write(" ");
-  file_->write(angle2 > 0 ? "arc" : "arcn");
-  file_->write(" closepath fill\n");
+  write("newpath ");
+  write(CStrUtil::toString(x));
+  write(" ");
+  write(CStrUtil::toString(y));
+  write(" ");
+  write(CStrUtil::toString(xr));
+  write(" ");
+  write(CStrUtil::toString(angle1));
+  write(" ");
+  write(CStrUtil::toString(angle1 + angle2));
+  write(" ");
+  write(angle2 > 0 ? "arc" : "arcn");
+  write(" closepath fill\n");
 }
 
 void
@@ -739,14 +780,14 @@ drawRectangle(double x1, double y1, double x2, double y2)
 {
   assert(active_);
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y1) + " moveto\n");
-  file_->write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y1) + " lineto\n");
-  file_->write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y2) + " lineto\n");
-  file_->write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y2) + " lineto\n");
+  write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y1) + " moveto\n");
+  write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y1) + " lineto\n");
+  write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y2) + " lineto\n");
+  write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y2) + " lineto\n");
 
-  file_->write("closepath stroke\n");
+  write("closepath stroke\n");
 }
 
 void
@@ -755,14 +796,14 @@ fillRectangle(double x1, double y1, double x2, double y2)
 {
   assert(active_);
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y1) + " moveto\n");
-  file_->write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y1) + " lineto\n");
-  file_->write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y2) + " lineto\n");
-  file_->write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y2) + " lineto\n");
+  write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y1) + " moveto\n");
+  write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y1) + " lineto\n");
+  write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y2) + " lineto\n");
+  write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y2) + " lineto\n");
 
-  file_->write("closepath fill\n");
+  write("closepath fill\n");
 }
 
 void
@@ -771,21 +812,21 @@ drawPolygon(double *x, double *y, int n)
 {
   assert(active_);
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x[0]));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y[0]));
-  file_->write(" moveto\n");
+  write(CStrUtil::toString(x[0]));
+  write(" ");
+  write(CStrUtil::toString(y[0]));
+  write(" moveto\n");
 
   for (int i = 1; i < n; i++) {
-    file_->write(CStrUtil::toString(x[i]));
-    file_->write(" ");
-    file_->write(CStrUtil::toString(y[i]));
-    file_->write(" lineto\n");
+    write(CStrUtil::toString(x[i]));
+    write(" ");
+    write(CStrUtil::toString(y[i]));
+    write(" lineto\n");
   }
 
-  file_->write("closepath stroke\n");
+  write("closepath stroke\n");
 }
 
 void
@@ -794,21 +835,21 @@ fillPolygon(double *x, double *y, int n)
 {
   assert(active_);
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x[0]));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y[0]));
-  file_->write(" moveto\n");
+  write(CStrUtil::toString(x[0]));
+  write(" ");
+  write(CStrUtil::toString(y[0]));
+  write(" moveto\n");
 
   for (int i = 1; i < n; i++) {
-    file_->write(CStrUtil::toString(x[i]));
-    file_->write(" ");
-    file_->write(CStrUtil::toString(y[i]));
-    file_->write(" lineto\n");
+    write(CStrUtil::toString(x[i]));
+    write(" ");
+    write(CStrUtil::toString(y[i]));
+    write(" lineto\n");
   }
 
-  file_->write("closepath fill\n");
+  write("closepath fill\n");
 }
 
 void
@@ -817,21 +858,21 @@ drawPath(double *x, double *y, int n)
 {
   assert(active_);
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x[0]));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y[0]));
-  file_->write(" moveto\n");
+  write(CStrUtil::toString(x[0]));
+  write(" ");
+  write(CStrUtil::toString(y[0]));
+  write(" moveto\n");
 
   for (int i = 1; i < n; i++) {
-    file_->write(CStrUtil::toString(x[i]));
-    file_->write(" ");
-    file_->write(CStrUtil::toString(y[i]));
-    file_->write(" lineto\n");
+    write(CStrUtil::toString(x[i]));
+    write(" ");
+    write(CStrUtil::toString(y[i]));
+    write(" lineto\n");
   }
 
-  file_->write("stroke\n");
+  write("stroke\n");
 }
 
 void
@@ -840,12 +881,12 @@ drawLine(double x1, double y1, double x2, double y2)
 {
   assert(active_);
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y1) + " moveto\n");
-  file_->write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y2) + " lineto\n");
+  write(CStrUtil::toString(x1) + " " + CStrUtil::toString(y1) + " moveto\n");
+  write(CStrUtil::toString(x2) + " " + CStrUtil::toString(y2) + " lineto\n");
 
-  file_->write("stroke\n");
+  write("stroke\n");
 }
 
 void
@@ -857,21 +898,21 @@ drawLines(double *x, double *y, int num_xy)
   if (num_xy <= 0)
     return;
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x[0]));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y[0]));
-  file_->write(" moveto\n");
+  write(CStrUtil::toString(x[0]));
+  write(" ");
+  write(CStrUtil::toString(y[0]));
+  write(" moveto\n");
 
   for (int i = 1; i < num_xy; i++) {
-    file_->write(CStrUtil::toString(x[i]));
-    file_->write(" ");
-    file_->write(CStrUtil::toString(y[i]));
-    file_->write(" lineto\n");
+    write(CStrUtil::toString(x[i]));
+    write(" ");
+    write(CStrUtil::toString(y[i]));
+    write(" lineto\n");
   }
 
-  file_->write("stroke\n");
+  write("stroke\n");
 }
 
 void
@@ -880,18 +921,18 @@ drawPoint(double x, double y)
 {
   assert(active_);
 
-  file_->write("newpath\n");
+  write("newpath\n");
 
-  file_->write(CStrUtil::toString(x));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y));
-  file_->write(" moveto\n");
-  file_->write(CStrUtil::toString(x));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y));
-  file_->write(" lineto\n");
+  write(CStrUtil::toString(x));
+  write(" ");
+  write(CStrUtil::toString(y));
+  write(" moveto\n");
+  write(CStrUtil::toString(x));
+  write(" ");
+  write(CStrUtil::toString(y));
+  write(" lineto\n");
 
-  file_->write("stroke\n");
+  write("stroke\n");
 }
 
 void
@@ -916,32 +957,32 @@ drawText(double x, double y, const std::string &str, int angle)
   double x1 = x + (font_ascent_ + font_descent_)*sin(angle);
   double y1 = y - (font_ascent_ + font_descent_)*cos(angle);
 
-  file_->write(CStrUtil::toString(x1));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y1));
-  file_->write(" moveto\n");
+  write(CStrUtil::toString(x1));
+  write(" ");
+  write(CStrUtil::toString(y1));
+  write(" moveto\n");
 
   if (angle) {
-    file_->write(CStrUtil::toString(angle));
-    file_->write(" rotate\n");
+    write(CStrUtil::toString(angle));
+    write(" rotate\n");
   }
 
-  file_->write("(");
-  file_->write(str1);
-  file_->write(") show\n");
+  write("(");
+  write(str1);
+  write(") show\n");
 
-  file_->write("-");
-  file_->write(CStrUtil::toString(angle));
-  file_->write(" rotate\n");
+  write("-");
+  write(CStrUtil::toString(angle));
+  write(" rotate\n");
 }
 
 void
 CPrint::
 showText(double x, double y, const std::string &str)
 {
-  file_->write(CStrUtil::toString(x) + " " + CStrUtil::toString(y) + " moveto\n");
+  write(CStrUtil::toString(x) + " " + CStrUtil::toString(y) + " moveto\n");
 
-  file_->write("(" + str + ") show\n");
+  write("(" + str + ") show\n");
 }
 
 void
@@ -951,7 +992,7 @@ fillText(double x, double y, const std::string &str, int angle)
   assert(active_);
 
   if (! fill_string_defined_) {
-    file_->write(FILL_STRING_DEF);
+    write(FILL_STRING_DEF);
 
     fill_string_defined_ = true;
   }
@@ -974,26 +1015,26 @@ fillText(double x, double y, const std::string &str, int angle)
   double x1 = x + (font_ascent_ + font_descent_)*sin(angle);
   double y1 = y - (font_ascent_ + font_descent_)*cos(angle);
 
-  file_->write(CStrUtil::toString(bg_.getRed()));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(bg_.getGreen()));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(bg_.getBlue()));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(fg_.getRed()));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(fg_.getGreen()));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(fg_.getBlue()));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(x1));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(y1));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(angle));
-  file_->write(" (");
-  file_->write(str1);
-  file_->write(") fillString\n");
+  write(CStrUtil::toString(bg_.getRed()));
+  write(" ");
+  write(CStrUtil::toString(bg_.getGreen()));
+  write(" ");
+  write(CStrUtil::toString(bg_.getBlue()));
+  write(" ");
+  write(CStrUtil::toString(fg_.getRed()));
+  write(" ");
+  write(CStrUtil::toString(fg_.getGreen()));
+  write(" ");
+  write(CStrUtil::toString(fg_.getBlue()));
+  write(" ");
+  write(CStrUtil::toString(x1));
+  write(" ");
+  write(CStrUtil::toString(y1));
+  write(" ");
+  write(CStrUtil::toString(angle));
+  write(" (");
+  write(str1);
+  write(") fillString\n");
 }
 
 void
@@ -1001,7 +1042,7 @@ CPrint::
 drawImage(const CImagePtr &image, double x, double y, int width, int height,
           bool resize, int rotate)
 {
-  file_->write("save\n");
+  write("save\n");
 
   if (resize) {
     double scale;
@@ -1018,36 +1059,36 @@ drawImage(const CImagePtr &image, double x, double y, int width, int height,
     else
       offset = (width - image->getWidth() *scale)/2.0;
 
-    file_->write(CStrUtil::toString(x + offset) + " " +
+    write(CStrUtil::toString(x + offset) + " " +
                  CStrUtil::toString(page_height_ - y - height) + " translate\n");
 
-    file_->write(CStrUtil::toString(scale) + " dup scale\n");
+    write(CStrUtil::toString(scale) + " dup scale\n");
   }
   else {
     if (rotate == 90 || rotate == 270)
-      file_->write(CStrUtil::toString(x) + " " +
+      write(CStrUtil::toString(x) + " " +
                    CStrUtil::toString(page_height_ - y - image->getWidth()) + " translate\n");
     else
-      file_->write(CStrUtil::toString(x) + " " +
+      write(CStrUtil::toString(x) + " " +
                    CStrUtil::toString(page_height_ - y - image->getHeight()) + " translate\n");
   }
 
-  file_->write("1 1 scale\n");
+  write("1 1 scale\n");
 
   if      (rotate == 90)
-    file_->write(CStrUtil::toString(image->getHeight()) + " 0 translate\n");
+    write(CStrUtil::toString(image->getHeight()) + " 0 translate\n");
   else if (rotate == 180)
-    file_->write(CStrUtil::toString(image->getWidth()) + " " +
+    write(CStrUtil::toString(image->getWidth()) + " " +
                  CStrUtil::toString(image->getHeight()) + " translate\n");
   else if (rotate == 270)
-    file_->write("0 " + CStrUtil::toString(image->getWidth()) + " translate\n");
+    write("0 " + CStrUtil::toString(image->getWidth()) + " translate\n");
 
   if (rotate != 0)
-    file_->write(CStrUtil::toString(rotate) + " rotate\n");
+    write(CStrUtil::toString(rotate) + " rotate\n");
 
   drawImage(image, 0, 0);
 
-  file_->write("restore\n");
+  write("restore\n");
 }
 
 void
@@ -1067,7 +1108,7 @@ drawSubImage(const CImagePtr &image, double src_x, double src_y,
   assert(active_);
 
   if (! color_image_defined_) {
-    file_->write(COLOR_IMAGE_DEF);
+    write(COLOR_IMAGE_DEF);
 
     color_image_defined_ = true;
   }
@@ -1083,146 +1124,130 @@ drawSubImage(const CImagePtr &image, double src_x, double src_y,
   if (src_y + height1 > height2)
     height1 = height2 - src_y;
 
-  file_->write("save\n");
+  /*------*/
 
-  file_->write(CStrUtil::toString(dst_x));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(height_ - dst_y - height2));
-  file_->write(" translate\n");
-  file_->write(CStrUtil::toString(width2));
-  file_->write(" ");
-  file_->write(CStrUtil::toString(height2));
-  file_->write(" scale\n");
+  // convert to samples for output depth
+  int bits, ncomp, row_bytes;
 
-  if (output_color_) {
-    file_->write("/buffer ");
-    file_->write(CStrUtil::toString((int) (3*width1)));
-    file_->write(" string def\n");
-
-    file_->write(CStrUtil::toString((int) width1));
-    file_->write(" ");
-    file_->write(CStrUtil::toString((int) height1));
-    file_->write(" 8\n");
-    file_->write("[");
-    file_->write(CStrUtil::toString(width2));
-    file_->write(" 0 0 ");
-    file_->write(CStrUtil::toString(-height2));
-    file_->write(" 0 ");
-    file_->write(CStrUtil::toString(height2));
-    file_->write("]\n");
-    file_->write("{currentfile buffer readhexstring pop}\n");
-
-    file_->write("false 3 colorimage\n");
-
-    double r, g, b, a;
-
-    for (int y1 = 0; y1 < (int) height1; y1++) {
-      int byte_count = 0;
-
-      for (int x1 = 0; x1 < (int) width1; x1++) {
-        image->getRGBAPixel((int) (src_x + x1), (int) (src_y + y1),
-                            &r, &g, &b, &a);
-
-        int r1 = (int) (r*255);
-        int g1 = (int) (g*255);
-        int b1 = (int) (b*255);
-
-        file_->write(CStrUtil::toHexString(r1 & 0xFF, 2));
-        file_->write(CStrUtil::toHexString(g1 & 0xFF, 2));
-        file_->write(CStrUtil::toHexString(b1 & 0xFF, 2));
-
-        if (byte_count % 19 == 18)
-          file_->write("\n");
-
-        byte_count++;
-      }
+  std::string samples;
 
-      file_->write("\n");
-    }
-  }
-  else if (output_depth_ == 8) {
-    file_->write("/buffer ");
-    file_->write(CStrUtil::toString((int) width1));
-    file_->write(" string def\n");
+  getImageSamples(image, int(src_x), int(src_y), int(width1), int(height1),
+                  samples, bits, ncomp, row_bytes);
 
-    file_->write(CStrUtil::toString((int) width1));
-    file_->write(" ");
-    file_->write(CStrUtil::toString((int) height1));
-    file_->write(" 8\n");
-    file_->write("[");
-    file_->write(CStrUtil::toString(width2));
-    file_->write(" 0 0 ");
-    file_->write(CStrUtil::toString(-height2));
-    file_->write(" 0 ");
-    file_->write(CStrUtil::toString(height2));
-    file_->write("]\n");
-    file_->write("{currentfile buffer readhexstring pop}\n");
+  /*------*/
 
-    file_->write("image\n");
+  // level 2 image data is defined once (in global VM so it survives restore)
+  std::string name;
 
-    double r, g, b, a;
+  if (language_level_ >= 2)
+    name = defineImage(samples, int(width1), int(height1), bits, ncomp);
+
+  /*------*/
+
+  write("save\n");
+
+  write(CStrUtil::toString(dst_x));
+  write(" ");
+  write(CStrUtil::toString(height_ - dst_y - height2));
+  write(" translate\n");
+  write(CStrUtil::toString(width2));
+  write(" ");
+  write(CStrUtil::toString(height2));
+  write(" scale\n");
+
+  if (language_level_ < 2) {
+    write("/buffer ");
+    write(CStrUtil::toString(row_bytes));
+    write(" string def\n");
+  }
 
-    for (int y1 = 0; y1 < (int) height1; y1++) {
-      int byte_count = 0;
+  write(CStrUtil::toString((int) width1));
+  write(" ");
+  write(CStrUtil::toString((int) height1));
+  write(" ");
+  write(CStrUtil::toString(bits));
+  write("\n");
+  write("[");
+  write(CStrUtil::toString(width2));
+  write(" 0 0 ");
+  write(CStrUtil::toString(-height2));
+  write(" 0 ");
+  write(CStrUtil::toString(height2));
+  write("]\n");
+
+  if (language_level_ < 2)
+    write("{currentfile buffer readhexstring pop}\n");
+  else {
+    // read strings of image data array through decode filter (empty string is end)
+    write("/ImageInd 0 def\n");
+    write("{ImageInd " + name + " length lt {" + name + " ImageInd get " +
+          "/ImageInd ImageInd 1 add def} {()} ifelse}\n");
+    write(language_level_ >= 3 ? "/FlateDecode filter\n" : "/RunLengthDecode filter\n");
+  }
 
-      for (int x1 = 0; x1 < (int) width1; x1++) {
-        image->getRGBAPixel((int) (src_x + x1), (int) (src_y + y1),
-                            &r, &g, &b, &a);
+  if (ncomp == 3)
+    write("false 3 colorimage\n");
+  else
+    write("image\n");
 
-        double gray = (r + g + b)/3.0;
+  if (language_level_ < 2)
+    writeHexData(samples, row_bytes);
 
-        int gray1 = (int) (gray*255);
+  write("restore\n");
+}
 
-        if (output_invert_)
-          gray1 = ~gray1;
+// get image samples (rows padded to byte boundary) for output color/depth
+void
+CPrint::
+getImageSamples(const CImagePtr &image, int src_x, int src_y, int width, int height,
+                std::string &samples, int &bits, int &ncomp, int &row_bytes)
+{
+  if (output_color_) {
+    bits  = 8;
+    ncomp = 3;
+  }
+  else {
+    bits  = (output_depth_ == 8 || output_depth_ == 4 || output_depth_ == 2 ? output_depth_ : 1);
+    ncomp = 1;
+  }
 
-        file_->write(CStrUtil::toHexString(gray1 & 0xFF, 2));
+  row_bytes = (width*bits*ncomp + 7)/8;
 
-        if (byte_count % 19 == 18)
-          file_->write("\n");
+  samples.clear();
 
-        byte_count++;
-      }
+  samples.reserve(row_bytes*height);
 
-      file_->write("\n");
-    }
-  }
-  else if (output_depth_ == 4) {
-    file_->write("/buffer ");
-    file_->write(CStrUtil::toString((int) ((width1 + 1)/2)));
-    file_->write(" string def\n");
+  double r, g, b, a;
 
-    file_->write(CStrUtil::toString((int) width1));
-    file_->write(" ");
-    file_->write(CStrUtil::toString((int) height1));
-    file_->write(" 4\n");
-    file_->write("[");
-    file_->write(CStrUtil::toString(width2));
-    file_->write(" 0 0 ");
-    file_->write(CStrUtil::toString(-height2));
-    file_->write(" 0 ");
-    file_->write(CStrUtil::toString(height2));
-    file_->write("]\n");
-    file_->write("{currentfile buffer readhexstring pop}\n");
+  for (int y1 = 0; y1 < height; y1++) {
+    int pos  = 7;
+    int byte = 0;
 
-    file_->write("image\n");
+    for (int x1 = 0; x1 < width; x1++) {
+      image->getRGBAPixel(src_x + x1, src_y + y1, &r, &g, &b, &a);
 
-    double r, g, b, a;
+      if (output_color_) {
+        samples += char(int(r*255) & 0xFF);
+        samples += char(int(g*255) & 0xFF);
+        samples += char(int(b*255) & 0xFF);
 
-    for (int y1 = 0; y1 < (int) height1; y1++) {
-      int byte_count = 0;
+        continue;
+      }
 
-      int pos  = 7;
-      int byte = 0;
+      double gray = (r + g + b)/3.0;
 
-      for (int x1 = 0; x1 < (int) width1; x1++) {
-        image->getRGBAPixel((int) (src_x + x1), (int) (src_y + y1),
-                            &r, &g, &b, &a);
+      int gray1 = (int) (gray*255);
 
-        double gray = (r + g + b)/3.0;
+      if (bits == 8) {
+        if (output_invert_)
+          gray1 = ~gray1;
 
-        int gray1 = (int) (gray*255);
+        samples += char(gray1 & 0xFF);
 
+        continue;
+      }
+
+      if      (bits == 4) {
         if      (gray1 >= 0xF0) {
           byte |= 1 << (pos    );
           byte |= 1 << (pos - 1);
@@ -1285,177 +1310,251 @@ drawSubImage(const CImagePtr &image, double src_x, double src_y,
         else if (gray1 >= 0x10) {
           byte |= 1 << (pos - 3);
         }
-
-        pos -= 4;
-
-        if (pos < 0) {
-          if (output_invert_)
-            byte = ~byte;
-
-          file_->write(CStrUtil::toHexString(byte & 0xFF, 2));
-
-          if (byte_count % 19 == 18)
-            file_->write("\n");
-
-          byte_count++;
-
-          pos  = 7;
-          byte = 0;
+      }
+      else if (bits == 2) {
+        if      (gray1 >= 0xC0) {
+          byte |= 1 << (pos    );
+          byte |= 1 << (pos - 1);
         }
+        else if (gray1 >= 0x80)
+          byte |= 1 << (pos    );
+        else if (gray1 >= 0x40)
+          byte |= 1 << (pos - 1);
+      }
+      else {
+        if (gray1 >= 0x80)
+          byte |= 1 << pos;
       }
 
-      if (pos != 7) {
+      pos -= bits;
+
+      if (pos < 0) {
         if (output_invert_)
           byte = ~byte;
 
-        file_->write(CStrUtil::toHexString(byte & 0xFF, 2));
+        samples += char(byte & 0xFF);
+
+        pos  = 7;
+        byte = 0;
       }
+    }
 
-      file_->write("\n");
+    if (bits < 8 && pos != 7) {
+      if (output_invert_)
+        byte = ~byte;
+
+      samples += char(byte & 0xFF);
     }
   }
-  else if (output_depth_ == 2) {
-    file_->write("/buffer ");
-    file_->write(CStrUtil::toString((int) ((width1 + 3)/4)));
-    file_->write(" string def\n");
+}
+
+// define image data as array of encoded strings (returns name of existing definition
+// if same samples were already output)
+std::string
+CPrint::
+defineImage(const std::string &samples, int width, int height, int bits, int ncomp)
+{
+  // FNV-1a hash of samples
+  size_t h = 14695981039346656037ULL;
+
+  for (const auto &c : samples) {
+    h ^= (unsigned char) c;
+    h *= 1099511628211ULL;
+  }
 
-    file_->write(CStrUtil::toString((int) width1));
-    file_->write(" ");
-    file_->write(CStrUtil::toString((int) height1));
-    file_->write(" 2\n");
-    file_->write("[");
-    file_->write(CStrUtil::toString(width2));
-    file_->write(" 0 0 ");
-    file_->write(CStrUtil::toString(-height2));
-    file_->write(" 0 ");
-    file_->write(CStrUtil::toString(height2));
-    file_->write("]\n");
-    file_->write("{currentfile buffer readhexstring pop}\n");
+  std::string key = CStrUtil::toString(width) + "x" + CStrUtil::toString(height) + ":" +
+                    CStrUtil::toString(bits) + ":" + CStrUtil::toString(ncomp) + ":" +
+                    std::to_string(h);
 
-    file_->write("image\n");
+  auto p = image_names_.find(key);
 
-    double r, g, b, a;
+  if (p != image_names_.end())
+    return (*p).second;
 
-    for (int y1 = 0; y1 < (int) height1; y1++) {
-      int byte_count = 0;
+  std::string name = "Image" + CStrUtil::toString(int(image_names_.size()) + 1);
 
-      int pos  = 7;
-      int byte = 0;
+  image_names_[key] = name;
 
-      for (int x1 = 0; x1 < (int) width1; x1++) {
-        image->getRGBAPixel((int) (src_x + x1), (int) (src_y + y1),
-                            &r, &g, &b, &a);
+  //---
 
-        double gray = (r + g + b)/3.0;
+  std::string data;
 
-        int gray1 = (int) (gray*255);
+  if (language_level_ >= 3) {
+    // zlib stream (qCompress prefixes uncompressed length)
+    QByteArray bytes = qCompress(QByteArray(samples.data(), int(samples.size())), 9);
 
-        if      (gray1 >= 0xC0) {
-          byte |= 1 << (pos    );
-          byte |= 1 << (pos - 1);
-        }
-        else if (gray1 >= 0x80)
-          byte |= 1 << (pos    );
-        else if (gray1 >= 0x40)
-          byte |= 1 << (pos - 1);
+    data = std::string(bytes.constData() + 4, bytes.size() - 4);
+  }
+  else
+    runLengthEncode(samples, data);
 
-        pos -= 2;
+  //---
 
-        if (pos < 0) {
-          if (output_invert_)
-            byte = ~byte;
+  // strings are limited to 65535 bytes
+  const size_t max_string_len = 32768;
 
-          file_->write(CStrUtil::toHexString(byte & 0xFF, 2));
+  write("currentglobal true setglobal\n");
+  write("globaldict /" + name + " [\n");
 
-          if (byte_count % 19 == 18)
-            file_->write("\n");
+  for (size_t i = 0; i < data.size(); i += max_string_len) {
+    write("<~");
 
-          byte_count++;
+    writeASCII85(data.substr(i, max_string_len));
 
-          pos  = 7;
-          byte = 0;
-        }
-      }
+    write("~>\n");
+  }
 
-      if (pos != 7) {
-        if (output_invert_)
-          byte = ~byte;
+  write("] put\n");
+  write("setglobal\n");
 
-        file_->write(CStrUtil::toHexString(byte & 0xFF, 2));
-      }
+  return name;
+}
+
+// RunLengthDecode encoding (runs of 2-128 same bytes, literals of 1-128 bytes)
+void
+CPrint::
+runLengthEncode(const std::string &in, std::string &out)
+{
+  size_t n = in.size();
+
+  out.reserve(out.size() + n + n/128 + 2);
+
+  size_t i = 0;
+
+  while (i < n) {
+    size_t j = i + 1;
+
+    while (j < n && j - i < 128 && in[j] == in[i])
+      ++j;
 
-      file_->write("\n");
+    if (j - i > 1) {
+      out += char(257 - (j - i));
+      out += in[i];
+
+      i = j;
+
+      continue;
     }
+
+    // literal run up to next repeat
+    j = i + 1;
+
+    while (j < n && j - i < 128 && ! (j + 1 < n && in[j] == in[j + 1]))
+      ++j;
+
+    out += char(j - i - 1);
+    out += in.substr(i, j - i);
+
+    i = j;
   }
-  else if (output_depth_ == 1) {
-    file_->write("/buffer ");
-    file_->write(CStrUtil::toString((int) ((width1 + 7)/8)));
-    file_->write(" string def\n");
 
-    file_->write(CStrUtil::toString((int) width1));
-    file_->write(" ");
-    file_->write(CStrUtil::toString((int) height1));
-    file_->write(" 1\n");
-    file_->write("[");
-    file_->write(CStrUtil::toString(width2));
-    file_->write(" 0 0 ");
-    file_->write(CStrUtil::toString(-height2));
-    file_->write(" 0 ");
-    file_->write(CStrUtil::toString(height2));
-    file_->write("]\n");
-    file_->write("{currentfile buffer readhexstring pop}\n");
+  out += char(128);
+}
+
+// ASCII85 encode data (lines of at most 75 characters)
+void
+CPrint::
+writeASCII85(const std::string &data)
+{
+  std::string str;
+
+  size_t n = data.size();
 
-    file_->write("image\n");
+  str.reserve(n*5/4 + n/60 + 8);
 
-    double r, g, b, a;
+  int line_len = 0;
 
-    for (int y1 = 0; y1 < (int) height1; y1++) {
-      int byte_count = 0;
+  auto addChar = [&](char c) {
+    str += c;
 
-      int pos  = 7;
-      int byte = 0;
+    if (++line_len >= 75) {
+      str += '\n';
 
-      for (int x1 = 0; x1 < (int) width1; x1++) {
-        image->getRGBAPixel((int) (src_x + x1), (int) (src_y + y1),
-                            &r, &g, &b, &a);
+      line_len = 0;
+    }
+  };
 
-        double gray = (r + g + b)/3.0;
+  for (size_t i = 0; i < n; i += 4) {
+    size_t m = std::min(n - i, size_t(4));
 
-        int gray1 = (int) (gray*255);
+    unsigned int word = 0;
 
-        if (gray1 >= 0x80)
-          byte |= 1 << pos;
+    for (size_t j = 0; j < 4; ++j)
+      word = (word << 8) | (j < m ? (unsigned char) data[i + j] : 0);
 
-        pos--;
+    if (word == 0 && m == 4) {
+      addChar('z');
+      continue;
+    }
 
-        if (pos < 0) {
-          if (output_invert_)
-            byte = ~byte;
+    char c[5];
 
-          file_->write(CStrUtil::toHexString(byte & 0xFF, 2));
+    for (int j = 4; j >= 0; --j) {
+      c[j] = char('!' + word % 85);
 
-          if (byte_count % 19 == 18)
-            file_->write("\n");
+      word /= 85;
+    }
 
-          byte_count++;
+    for (size_t j = 0; j < m + 1; ++j)
+      addChar(c[j]);
+  }
 
-          pos  = 7;
-          byte = 0;
-        }
-      }
+  write(str);
+}
 
-      if (pos != 7) {
-        if (output_invert_)
-          byte = ~byte;
+// level 1 hex image data (row at a time)
+void
+CPrint::
+writeHexData(const std::string &samples, int row_bytes)
+{
+  static const char *hex = "0123456789ABCDEF";
 
-        file_->write(CStrUtil::toHexString(byte & 0xFF, 2));
-      }
+  std::string str;
+
+  str.reserve(2*samples.size() + samples.size()/30 + 2);
 
-      file_->write("\n");
+  int byte_count = 0;
+
+  for (size_t i = 0; i < samples.size(); ++i) {
+    unsigned char c = samples[i];
+
+    str += hex[c >> 4];
+    str += hex[c & 0xF];
+
+    if (byte_count % 38 == 37)
+      str += '\n';
+
+    byte_count++;
+
+    if (row_bytes > 0 && (i + 1) % row_bytes == 0) {
+      str += '\n';
+
+      byte_count = 0;
     }
   }
 
-  file_->write("restore\n");
+  write(str);
+}
+
+// buffered write to file
+void
+CPrint::
+write(const std::string &str)
+{
+  buffer_ += str;
+
+  if (buffer_.size() >= 65536)
+    flush();
+}
+
+void
+CPrint::
+flush()
+{
+  if (file_ && ! buffer_.empty())
+    file_->write(buffer_);
+
+  buffer_.clear();
 }
 
 void
@@ -1465,12 +1564,12 @@ setForeground(const CRGBA &rgb)
   fg_ = rgb;
 
   if (active_) {
-    file_->write(CStrUtil::toString(fg_.getRed()));
-    file_->write(" ");
-    file_->write(CStrUtil::toString(fg_.getGreen()));
-    file_->write(" ");
-    file_->write(CStrUtil::toString(fg_.getBlue()));
-    file_->write(" setrgbcolor\n");
+    write(CStrUtil::toString(fg_.getRed()));
+    write(" ");
+    write(CStrUtil::toString(fg_.getGreen()));
+    write(" ");
+    write(CStrUtil::toString(fg_.getBlue()));
+    write(" setrgbcolor\n");
   }
 }
 
@@ -1502,8 +1601,8 @@ setGray(double gray)
   fg_ = CRGBA(gray, gray, gray);
 
   if (active_) {
-    file_->write(CStrUtil::toString(gray));
-    file_->write(" setgray\n");
+    write(CStrUtil::toString(gray));
+    write(" setgray\n");
   }
 }
 
@@ -1514,20 +1613,20 @@ setLineDash(const CILineDash &line_dash)
   line_dash_ = line_dash;
 
   if (active_) {
-    file_->write("[");
+    write("[");
 
     int num_dashes = line_dash_.getNumLengths();
 
     for (int i = 0; i < num_dashes; i++) {
-      file_->write(" ");
-      file_->write(CStrUtil::toString(line_dash_.getLength(i)));
+      write(" ");
+      write(CStrUtil::toString(line_dash_.getLength(i)));
     }
 
-    file_->write(" ]");
+    write(" ]");
 
-    file_->write(" ");
-    file_->write(CStrUtil::toString(line_dash_.getOffset()));
-    file_->write(" setdash\n");
+    write(" ");
+    write(CStrUtil::toString(line_dash_.getOffset()));
+    write(" setdash\n");
   }
 }
 
@@ -1544,8 +1643,8 @@ setLineWidth(double line_width)
 
   if (active_) {
     if (last_line_width_ < 0 || last_line_width_ != line_width_) {
-      file_->write(CStrUtil::toString(line_width_));
-      file_->write(" setlinewidth\n");
+      write(CStrUtil::toString(line_width_));
+      write(" setlinewidth\n");
     }
 
     last_line_width_ = line_width_;
@@ -1632,9 +1731,9 @@ setFont(const std::string &name, double x_size, double y_size)
 {
   if (! active_) return;
 
-  file_->write(name);
+  write(name);
 
-  file_->write(" [" + CStrUtil::toString(x_size) + " 0 0 " +
+  write(" [" + CStrUtil::toString(x_size) + " 0 0 " +
                CStrUtil::toString(y_size) + " 0 0] makefont setfont\n");
 }
 
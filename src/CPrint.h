@@ -8,6 +8,7 @@ class CFile;
 #include <CFont.h>
 #include <CImage.h>
 #include <CAutoPtr.h>
+#include <map>
 
 class CPrint {
  public:
@@ -36,7 +37,10 @@ class CPrint {
 
   void setTitle(const std::string &title);
 
-  void setPageSize(int width, int height) { page_width_ = width; page_height_ = height; }
+  void setPageSize(int width, int height);
+
+  // paper size in points (selected with setpagedevice for level 2 and above)
+  void setPaperSize(int width, int height) { paper_width_ = width; paper_height_ = height; }
 
   void setSize(double xmin, double ymin, double xmax, double ymax);
 
@@ -46,6 +50,9 @@ class CPrint {
 
   void setOutputDepth(uint depth) { output_depth_ = depth; }
 
+  // PostScript language level for images (1 : hex, 2 : ASCII85 RunLength, 3 : ASCII85 Flate)
+  void setLanguageLevel(int level) { language_level_ = level; }
+
   void init();
   void term();
 
@@ -54,6 +61,9 @@ class CPrint {
 
   void startPage(int page_no1, int page_no2);
 
+  // write buffered output to file
+  void flush();
+
   void clear();
 
   void drawCircle(double x, double y, double r);
@@ -111,12 +121,29 @@ class CPrint {
   std::string timeToDateString(time_t t);
 
  private:
+  void getImageSamples(const CImagePtr &image, int src_x, int src_y, int width, int height,
+                       std::string &samples, int &bits, int &ncomp, int &row_bytes);
+
+  std::string defineImage(const std::string &samples, int width, int height,
+                          int bits, int ncomp);
+
+  void runLengthEncode(const std::string &in, std::string &out);
+
+  void writeASCII85(const std::string &data);
+  void writeHexData(const std::string &samples, int row_bytes);
+
+  void write(const std::string &str);
+
+ private:
+  typedef std::map<std::string, std::string> ImageNames;
+
   bool            active_;
   std::string     filename_;
   CAutoPtr<CFile> file_;
   std::string     creator_;
   std::string     title_;
   int             page_width_, page_height_;
+  int             paper_width_, paper_height_;
   bool            has_range_;
   double          xmin_, ymin_, xmax_, ymax_;
   double          width_, height_;
@@ -133,6 +160,9 @@ class CPrint {
   bool            output_color_;
   uint            output_depth_;
   bool            output_invert_;
+  int             language_level_;
+  ImageNames      image_names_;
+  std::string     buffer_;
 };
 
 #endif
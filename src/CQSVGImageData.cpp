@@ -1,7 +1,425 @@
 #include <CQSVGImageData.h>
-#include <CTurbulenceUtil.h>
-#include <CGaussianBlur.h>
+#include <CQSVGImagePool.h>
+#include <CQSVGThreadPool.h>
+#include <CQSVGTurbulence.h>
 #include <QColor>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// scanline helpers (image data is always QImage::Format_ARGB32, i.e. not premultiplied)
+
+const float inv255 = 1.0f/255.0f;
+
+inline int toByte(float v) {
+  int i = int(v*255.0f + 0.5f);
+
+  return (i < 0 ? 0 : (i > 255 ? 255 : i));
+}
+
+inline QRgb packPixel(float r, float g, float b, float a) {
+  return qRgba(toByte(r), toByte(g), toByte(b), toByte(a));
+}
+
+// bit shift of component in QRgb value (-1 if invalid)
+int componentShift(CColorComponent component) {
+  if      (CRGBA(1, 0, 0, 0).getComponent(component) > 0.5) return 16;
+  else if (CRGBA(0, 1, 0, 0).getComponent(component) > 0.5) return  8;
+  else if (CRGBA(0, 0, 1, 0).getComponent(component) > 0.5) return  0;
+  else if (CRGBA(0, 0, 0, 1).getComponent(component) > 0.5) return 24;
+
+  return -1;
+}
+
+// apply byte lookup table to component of all pixels in scanline
+void applyComponentLUT(QRgb *line, int n, int shift, const uchar *lut) {
+  QRgb mask = ~(QRgb(0xff) << shift);
+
+  for (int i = 0; i < n; ++i) {
+    QRgb p = line[i];
+
+    line[i] = (p & mask) | (QRgb(lut[(p >> shift) & 0xff]) << shift);
+  }
+}
+
+// 5x4 color matrix on scanline
+void colorMatrixLine(QRgb *line, int n, const float *m) {
+#ifdef __SSE2__
+  // one pixel per register, columns of matrix (output r, g, b, a) are broadcast per input
+  const __m128 cr = _mm_setr_ps(m[0], m[5], m[10], m[15]);
+  const __m128 cg = _mm_setr_ps(m[1], m[6], m[11], m[16]);
+  const __m128 cb = _mm_setr_ps(m[2], m[7], m[12], m[17]);
+  const __m128 ca = _mm_setr_ps(m[3], m[8], m[13], m[18]);
+  const __m128 co = _mm_setr_ps(m[4], m[9], m[14], m[19]);
+
+  const __m128 s    = _mm_set1_ps(inv255);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one  = _mm_set1_ps(1.0f);
+  const __m128 k255 = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+
+  QRgb lastIn = 0, lastOut = 0;
+  bool hasLast = false;
+
+  for (int i = 0; i < n; ++i) {
+    QRgb p = line[i];
+
+    // runs of the same color are common
+    if (hasLast && p == lastIn) {
+      line[i] = lastOut;
+      continue;
+    }
+
+    __m128 r = _mm_mul_ps(_mm_set1_ps(float(qRed  (p))), s);
+    __m128 g = _mm_mul_ps(_mm_set1_ps(float(qGreen(p))), s);
+    __m128 b = _mm_mul_ps(_mm_set1_ps(float(qBlue (p))), s);
+    __m128 a = _mm_mul_ps(_mm_set1_ps(float(qAlpha(p))), s);
+
+    __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cr, r), _mm_mul_ps(cg, g)),
+                          _mm_add_ps(_mm_add_ps(_mm_mul_ps(cb, b), _mm_mul_ps(ca, a)), co));
+
+    float alpha;
+
+    _mm_store_ss(&alpha, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+
+    QRgb q = 0;
+
+    if (alpha > 0) {
+      v = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(v, zero), one), k255), half);
+
+      __m128i iv = _mm_cvttps_epi32(v);
+
+      // pack 4 x int32 (r, g, b, a) to bytes
+      iv = _mm_packs_epi32(iv, iv);
+      iv = _mm_packus_epi16(iv, iv);
+
+      uint bytes = uint(_mm_cvtsi128_si32(iv));
+
+      q = qRgba(bytes & 0xff, (bytes >> 8) & 0xff, (bytes >> 16) & 0xff, bytes >> 24);
+    }
+
+    line[i] = q;
+
+    lastIn  = p;
+    lastOut = q;
+    hasLast = true;
+  }
+#else
+  for (int i = 0; i < n; ++i) {
+    QRgb p = line[i];
+
+    float r = qRed  (p)*inv255;
+    float g = qGreen(p)*inv255;
+    float b = qBlue (p)*inv255;
+    float a = qAlpha(p)*inv255;
+
+    float a1 = m[15]*r + m[16]*g + m[17]*b + m[18]*a + m[19];
+
+    if (a1 > 0) {
+      float r1 = m[ 0]*r + m[ 1]*g + m[ 2]*b + m[ 3]*a + m[ 4];
+      float g1 = m[ 5]*r + m[ 6]*g + m[ 7]*b + m[ 8]*a + m[ 9];
+      float b1 = m[10]*r + m[11]*g + m[12]*b + m[13]*a + m[14];
+
+      line[i] = packPixel(r1, g1, b1, a1);
+    }
+    else
+      line[i] = 0;
+  }
+#endif
+}
+
+//---
+
+// straight RGBA float image (4 floats per pixel) used by multi pass filters
+struct FloatImage {
+  int                w { 0 };
+  int                h { 0 };
+  std::vector<float> data;
+
+  FloatImage() { }
+
+  FloatImage(int w, int h) :
+   w(w), h(h), data(size_t(w)*h*4, 0.0f) {
+  }
+
+  float *pixel(int x, int y) { return &data[(size_t(y)*w + x)*4]; }
+
+  const float *pixel(int x, int y) const { return &data[(size_t(y)*w + x)*4]; }
+};
+
+// float image of rect of image (whole image if null)
+void toFloatImage(const QImage &image, FloatImage &fimage, const QRect &rect=QRect()) {
+  QRect r = (rect.isNull() ? image.rect() : rect.intersected(image.rect()));
+
+  fimage = FloatImage(r.width(), r.height());
+
+  CQSVGThreadPoolInst->parallelFor(fimage.h, [&](int y1, int y2) {
+    for (int y = y1; y < y2; ++y) {
+      const QRgb *line =
+        reinterpret_cast<const QRgb *>(image.constScanLine(r.top() + y)) + r.left();
+
+      float *f = fimage.pixel(0, y);
+
+      for (int x = 0; x < fimage.w; ++x, f += 4) {
+        QRgb p = line[x];
+
+        f[0] = qRed  (p)*inv255;
+        f[1] = qGreen(p)*inv255;
+        f[2] = qBlue (p)*inv255;
+        f[3] = qAlpha(p)*inv255;
+      }
+    }
+  });
+}
+
+// store float image in image at pos
+void fromFloatImage(const FloatImage &fimage, QImage &image, const QPoint &pos=QPoint()) {
+  (void) image.bits();
+
+  int w = std::min(fimage.w, image.width () - pos.x());
+  int h = std::min(fimage.h, image.height() - pos.y());
+
+  CQSVGThreadPoolInst->parallelFor(h, [&](int y1, int y2) {
+    for (int y = y1; y < y2; ++y) {
+      QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(pos.y() + y)) + pos.x();
+
+      const float *f = fimage.pixel(0, y);
+
+      for (int x = 0; x < w; ++x, f += 4)
+        line[x] = packPixel(f[0], f[1], f[2], f[3]);
+    }
+  });
+}
+
+// 1D convolution of n pixels (stride floats apart) with kernel centered at
+// index 'center', pixels outside the line are transparent black
+void convolveLine(const float *in, float *out, int n, int stride,
+                  const std::vector<float> &kernel, int center) {
+  int nk = int(kernel.size());
+
+  for (int i = 0; i < n; ++i) {
+    float sum[4] = { 0, 0, 0, 0 };
+
+    int k1 = std::max(0, center - i);
+    int k2 = std::min(nk, n + center - i);
+
+    for (int k = k1; k < k2; ++k) {
+      const float *f = in + (i + k - center)*stride;
+
+      float kv = kernel[k];
+
+      sum[0] += kv*f[0]; sum[1] += kv*f[1]; sum[2] += kv*f[2]; sum[3] += kv*f[3];
+    }
+
+    float *o = out + i*stride;
+
+    o[0] = sum[0]; o[1] = sum[1]; o[2] = sum[2]; o[3] = sum[3];
+  }
+}
+
+// box blur of n pixels (stride floats apart) averaging [i - left, i + right] using
+// running sum, pixels outside the line are transparent black
+void boxBlurLine(const float *in, float *out, int n, int stride, int left, int right) {
+  float scale = 1.0f/(left + right + 1);
+
+  float sum[4] = { 0, 0, 0, 0 };
+
+  // initial window [-left, right] for i = 0
+  for (int j = 0; j <= right && j < n; ++j) {
+    const float *f = in + j*stride;
+
+    sum[0] += f[0]; sum[1] += f[1]; sum[2] += f[2]; sum[3] += f[3];
+  }
+
+  for (int i = 0; i < n; ++i) {
+    float *o = out + i*stride;
+
+    o[0] = sum[0]*scale; o[1] = sum[1]*scale; o[2] = sum[2]*scale; o[3] = sum[3]*scale;
+
+    int j1 = i - left;          // leaves window
+    int j2 = i + right + 1;     // enters window
+
+    if (j1 >= 0) {
+      const float *f = in + j1*stride;
+
+      sum[0] -= f[0]; sum[1] -= f[1]; sum[2] -= f[2]; sum[3] -= f[3];
+    }
+
+    if (j2 < n) {
+      const float *f = in + j2*stride;
+
+      sum[0] += f[0]; sum[1] += f[1]; sum[2] += f[2]; sum[3] += f[3];
+    }
+  }
+}
+
+// pixel radius of gaussian blur (as implemented by gaussianBlurPass)
+int blurFootprint(double stdDev) {
+  if (stdDev <= 0)
+    return 0;
+
+  if (stdDev < 2.0)
+    return int(ceil(3*stdDev));
+
+  int d = int(floor(stdDev*3*sqrt(2*M_PI)/4 + 0.5));
+
+  return 3*((d + 1)/2);
+}
+
+// gaussian blur of image in one direction (rows if horizontal, else columns)
+// using tmp as work buffer
+void gaussianBlurPass(FloatImage &fimage, FloatImage &tmp, double stdDev, bool horizontal) {
+  if (stdDev <= 0)
+    return;
+
+  int n      = (horizontal ? fimage.w : fimage.h);
+  int lines  = (horizontal ? fimage.h : fimage.w);
+  int stride = (horizontal ? 4 : 4*fimage.w);
+
+  if (tmp.w != fimage.w || tmp.h != fimage.h)
+    tmp = FloatImage(fimage.w, fimage.h);
+
+  auto lineData = [&](FloatImage &im, int l) {
+    return (horizontal ? im.pixel(0, l) : im.pixel(l, 0));
+  };
+
+  if (stdDev < 2.0) {
+    // small deviation: exact kernel
+    int r = int(ceil(3*stdDev));
+
+    std::vector<float> kernel(2*r + 1);
+
+    double sum = 0.0;
+
+    for (int i = -r; i <= r; ++i) {
+      double k = exp(-(i*i)/(2*stdDev*stdDev));
+
+      kernel[i + r] = float(k);
+
+      sum += k;
+    }
+
+    for (auto &k : kernel)
+      k = float(k/sum);
+
+    CQSVGThreadPoolInst->parallelFor(lines, [&](int l1, int l2) {
+      for (int l = l1; l < l2; ++l)
+        convolveLine(lineData(fimage, l), lineData(tmp, l), n, stride, kernel, r);
+    });
+
+    fimage.data.swap(tmp.data);
+  }
+  else {
+    // large deviation: three box blurs (as described in SVG specification)
+    int d = int(floor(stdDev*3*sqrt(2*M_PI)/4 + 0.5));
+
+    CQSVGThreadPoolInst->parallelFor(lines, [&](int l1, int l2) {
+      for (int l = l1; l < l2; ++l) {
+        float *f = lineData(fimage, l);
+        float *t = lineData(tmp   , l);
+
+        if (d & 1) {
+          int r = (d - 1)/2;
+
+          boxBlurLine(f, t, n, stride, r, r);
+          boxBlurLine(t, f, n, stride, r, r);
+          boxBlurLine(f, t, n, stride, r, r);
+        }
+        else {
+          int r = d/2;
+
+          boxBlurLine(f, t, n, stride, r    , r - 1);
+          boxBlurLine(t, f, n, stride, r - 1, r    );
+          boxBlurLine(f, t, n, stride, r    , r    );
+        }
+      }
+    });
+
+    fimage.data.swap(tmp.data);
+  }
+}
+
+// check if kernel (ysize rows of xsize values) is outer product of column and row
+bool separateKernel(const std::vector<double> &kernel, int xsize, int ysize,
+                    std::vector<float> &row, std::vector<float> &col) {
+  if (int(kernel.size()) < xsize*ysize)
+    return false;
+
+  // pivot on largest value
+  int    pi = 0;
+  double pv = 0.0;
+
+  for (int i = 0; i < xsize*ysize; ++i) {
+    if (fabs(kernel[i]) > fabs(pv)) {
+      pi = i;
+      pv = kernel[i];
+    }
+  }
+
+  if (pv == 0.0)
+    return false;
+
+  int px = pi % xsize;
+  int py = pi / xsize;
+
+  row.resize(xsize);
+  col.resize(ysize);
+
+  for (int x = 0; x < xsize; ++x)
+    row[x] = float(kernel[py*xsize + x]);
+
+  for (int y = 0; y < ysize; ++y)
+    col[y] = float(kernel[y*xsize + px]/pv);
+
+  double eps = 1E-6*fabs(pv);
+
+  for (int y = 0; y < ysize; ++y) {
+    for (int x = 0; x < xsize; ++x) {
+      if (fabs(kernel[y*xsize + x] - double(col[y])*row[x]) > eps)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+// van Herk/Gil-Werman running min or max (op) of window [i - r, i + r] for values
+// (stride apart) i in [r, n - r), O(1) per value independent of r.
+// g and h are scratch arrays of n values
+template<typename OP>
+void vanHerkLine(const uchar *in, uchar *out, int n, int stride, int r,
+                 uchar *g, uchar *h, OP op) {
+  int k = 2*r + 1;
+
+  if (n < k)
+    return;
+
+  // g: prefix op from start of each block of k, h: suffix op to end of block
+  for (int b = 0; b < n; b += k) {
+    int e = std::min(b + k, n);
+
+    g[b] = in[b*stride];
+
+    for (int i = b + 1; i < e; ++i)
+      g[i] = op(g[i - 1], in[i*stride]);
+
+    h[e - 1] = in[(e - 1)*stride];
+
+    for (int i = e - 2; i >= b; --i)
+      h[i] = op(h[i + 1], in[i*stride]);
+  }
+
+  for (int i = r; i < n - r; ++i)
+    out[i*stride] = op(h[i - r], g[i + r]);
+}
+
+}
 
 CQSVGImageData::
 CQSVGImageData() :
@@ -11,11 +429,18 @@ CQSVGImageData() :
 
 CQSVGImageData::
 CQSVGImageData(const CQSVGImageData &data) :
- CSVGImageData(data)
+ CSVGImageData(data), resizeType_(data.resizeType_), roi_(data.roi_),
+ roiOffset_(data.roiOffset_)
 {
   qimage_ = data.qimage_;
 }
 
+CQSVGImageData::
+~CQSVGImageData()
+{
+  CQSVGImagePool::release(qimage_);
+}
+
 CSVGImageData *
 CQSVGImageData::
 dup() const
@@ -23,6 +448,18 @@ dup() const
   return new CQSVGImageData(*this);
 }
 
+CQSVGImageData *
+CQSVGImageData::
+newImage(int w, int h, bool clear) const
+{
+  // copy of settings but not image data
+  CQSVGImageData *image = new CQSVGImageData(*this);
+
+  image->qimage_ = CQSVGImagePool::acquire(std::max(w, 1), std::max(h, 1), clear);
+
+  return image;
+}
+
 CImagePtr
 CQSVGImageData::
 image() const
@@ -47,6 +484,8 @@ setQImage(const QImage &qimage)
 {
   assert(! locked_);
 
+  CQSVGImagePool::release(qimage_);
+
   qimage_ = qimage;
 }
 
@@ -60,9 +499,9 @@ setSize(int w, int h)
   if (w != qimage_.width() || h != qimage_.height()) {
     assert(! locked_);
 
-    qimage_ = QImage(QSize(w, h), QImage::Format_ARGB32);
+    CQSVGImagePool::release(qimage_);
 
-    qimage_.fill(0);
+    qimage_ = CQSVGImagePool::acquire(w, h);
   }
 }
 
@@ -188,23 +627,31 @@ subCopyTo(CSVGImageData *dst, int src_x, int src_y, int width, int height, int d
   if (dst_x +  width1 > dst_width )  width1 = dst_width  - dst_x;
   if (dst_y + height1 > dst_height) height1 = dst_height - dst_y;
 
-  int ys = src_y;
-  int yd = dst_y;
+  toScanlineFormat();
 
-  for (int y = 0; y < height1; ++y, ++ys, ++yd) {
-    int xs = src_x;
-    int xd = dst_x;
+  qdst->toScanlineFormat();
 
-    for (int x = 0; x < width1; ++x, ++xs, ++xd) {
-      CRGBA rgba;
+  // copy valid source pixels (others are transparent) to valid destination pixels
+  for (int y = 0; y < height1; ++y) {
+    int ys = src_y + y;
+    int yd = dst_y + y;
 
-      if (validPixel(xs, ys))
-        rgba = getPixel(xs, ys);
-      else
-        rgba = CRGBA(0,0,0,0);
+    if (yd < 0 || yd >= dst_height)
+      continue;
+
+    QRgb *dline = reinterpret_cast<QRgb *>(qdst->qimage_.scanLine(yd));
+
+    const QRgb *sline = (ys >= 0 && ys < src_height ?
+      reinterpret_cast<const QRgb *>(qimage_.constScanLine(ys)) : nullptr);
+
+    for (int x = 0; x < width1; ++x) {
+      int xs = src_x + x;
+      int xd = dst_x + x;
 
-      if (qdst->validPixel(xd, yd))
-        qdst->setPixel(xd, yd, rgba);
+      if (xd < 0 || xd >= dst_width)
+        continue;
+
+      dline[xd] = (sline && xs >= 0 && xs < src_width ? sline[xs] : 0);
     }
   }
 }
@@ -219,9 +666,9 @@ subImage(int x, int y, int width, int height)
   if (height < 0)
     height = getHeight() - y;
 
-  CSVGImageData *image = dup();
+  CQSVGImageData *image = newImage(width, height);
 
-  image->setSize(width, height);
+  image->roiOffset_ = roiOffset_ + QPoint(x, y);
 
   subCopyTo(image, x, y, width, height, 0, 0);
 
@@ -269,13 +716,20 @@ void
 CQSVGImageData::
 scaleAlpha(double alpha)
 {
+  toScanlineFormat();
+
+  // fixed point (8.8) alpha scale
+  int ialpha = std::min(std::max(int(alpha*256 + 0.5), 0), 256);
+
+  int w = getWidth();
+
   for (int y = 0; y < getHeight(); ++y) {
-    for (int x = 0; x < getWidth(); ++x) {
-      CRGBA rgba = getPixel(x, y);
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
 
-      rgba.setAlpha(alpha*rgba.getAlpha());
+    for (int x = 0; x < w; ++x) {
+      QRgb p = line[x];
 
-      setPixel(x, y, rgba);
+      line[x] = (p & 0x00ffffff) | (QRgb((qAlpha(p)*ialpha + 128) >> 8) << 24);
     }
   }
 }
@@ -284,234 +738,243 @@ void
 CQSVGImageData::
 reshape(int width, int height)
 {
-  CSVGImageData *image = dup();
-
-  image->setSize(width, height);
-
-  //------
-
-  CImageResizeType resize_type = CIMAGE_RESIZE_NEAREST;
-
-  if      (resize_type == CIMAGE_RESIZE_BILINEAR)
-    reshapeBilinear(image);
-  else if (resize_type == CIMAGE_RESIZE_AVERAGE)
-    reshapeAverage(image);
-  else if (resize_type == CIMAGE_RESIZE_NEAREST)
-    reshapeNearest(image);
-  else
-    reshapeNearest(image);
-
-  assert(! locked_);
-
-  CQSVGImageData *qdata = dynamic_cast<CQSVGImageData *>(image);
-  assert(qdata);
-
-  qimage_ = qdata->qimage_;
-
-  delete image;
+  reshape(width, height, resizeType_);
 }
 
 void
 CQSVGImageData::
-reshapeBilinear(CSVGImageData *new_image) const
+reshape(int width, int height, CImageResizeType type)
 {
-  int width1  = getWidth ();
-  int height1 = getHeight();
-
-  int width2  = new_image->getWidth ();
-  int height2 = new_image->getHeight();
-
-  if (width2 <= 0 || height2 <= 0)
-    return;
+  assert(! locked_);
 
-  double ix = (1.0*width1 )/width2 ;
-  double iy = (1.0*height1)/height2;
+  if (width  < 1) width  = 1;
+  if (height < 1) height = 1;
 
-  double yy = 0.0;
+  toScanlineFormat();
 
-  for (int y = 0; y < height2; ++y, yy += iy) {
-    double xx = 0.0;
+  QImage image = CQSVGImagePool::acquire(width, height, /*clear*/false);
 
-    int y1 = CMathGen::RoundDown(yy);
-    int y2 = CMathGen::RoundUp  (yy);
+  if (getWidth() <= 0 || getHeight() <= 0) {
+    image.fill(0);
 
-    if (y2 >= height1) y2 = height1 - 1;
+    setQImage(image);
 
-    for (int x = 0; x < width2; ++x, xx += ix) {
-      int x1 = CMathGen::RoundDown(xx);
-      int x2 = CMathGen::RoundUp  (xx);
+    return;
+  }
 
-      if (x2 >= width1) x2 = width1 - 1;
+  //------
 
-      CRGBA c = getBilinearPixel(xx, x1, x2, yy, y1, y2);
+  if      (type == CIMAGE_RESIZE_BILINEAR)
+    reshapeBilinear(image);
+  else if (type == CIMAGE_RESIZE_AVERAGE)
+    reshapeAverage(image);
+  else
+    reshapeNearest(image);
 
-      new_image->setPixel(x, y, c);
-    }
-  }
+  setQImage(image);
 }
 
-CRGBA
+void
 CQSVGImageData::
-getBilinearPixel(double xx, double yy) const
+reshapeBilinear(QImage &image) const
 {
   int width1  = getWidth ();
   int height1 = getHeight();
 
-  int x1 = CMathGen::RoundDown(xx);
-  int x2 = CMathGen::RoundUp  (xx);
+  int width2  = image.width ();
+  int height2 = image.height();
 
-  if (x1 <  0     ) x1 = 0;
-  if (x2 >= width1) x2 = width1 - 1;
+  // per column/row source indices and 8 bit fraction of second index
+  struct Weight {
+    int i1, i2, f;
+  };
 
-  int y1 = CMathGen::RoundDown(yy);
-  int y2 = CMathGen::RoundUp  (yy);
+  auto makeWeights = [](int n1, int n2) {
+    std::vector<Weight> weights(n2);
 
-  if (y1 <  0      ) y2 = 0;
-  if (y2 >= height1) y2 = height1 - 1;
+    double d = (1.0*n1)/n2;
 
-  return getBilinearPixel(xx, x1, x2, yy, y1, y2);
-}
+    for (int i = 0; i < n2; ++i) {
+      double v = i*d;
 
-CRGBA
-CQSVGImageData::
-getBilinearPixel(double xx, int x1, int x2, double yy, int y1, int y2) const
-{
-  if (x1 != x2 || y1 != y2) {
-    double r1, g1, b1, a1;
-    double r2, g2, b2, a2;
-    double r3, g3, b3, a3;
-    double r4, g4, b4, a4;
+      int i1 = std::min(int(v), n1 - 1);
+      int i2 = std::min(i1 + 1, n1 - 1);
+
+      weights[i].i1 = i1;
+      weights[i].i2 = i2;
+      weights[i].f  = (i1 != i2 ? int((v - i1)*256 + 0.5) : 0);
+    }
 
-    getPixel(x1, y2, &r1, &g1, &b1, &a1);
-    getPixel(x2, y2, &r2, &g2, &b2, &a2);
-    getPixel(x1, y1, &r3, &g3, &b3, &a3);
-    getPixel(x2, y1, &r4, &g4, &b4, &a4);
+    return weights;
+  };
 
-    double dx  = x2 - xx;
-    double dx1 = 1.0 - dx;
-    double dy  = yy - y1;
-    double dy1 = 1.0 - dy;
+  std::vector<Weight> xweights = makeWeights(width1 , width2 );
+  std::vector<Weight> yweights = makeWeights(height1, height2);
 
-    double r12 = dx*r1 + dx1*r2;
-    double r34 = dx*r3 + dx1*r4;
+  CQSVGThreadPoolInst->parallelFor(height2, [&](int l1, int l2) {
+    for (int y = l1; y < l2; ++y) {
+      const Weight &yw = yweights[y];
 
-    double r = (dy*r12 + dy1*r34);
+      const QRgb *line1 = reinterpret_cast<const QRgb *>(qimage_.constScanLine(yw.i1));
+      const QRgb *line2 = reinterpret_cast<const QRgb *>(qimage_.constScanLine(yw.i2));
 
-    double g12 = dx*g1 + dx1*g2;
-    double g34 = dx*g3 + dx1*g4;
+      QRgb *dline = reinterpret_cast<QRgb *>(image.scanLine(y));
 
-    double g = (dy*g12 + dy1*g34);
+      int fy = yw.f, fy1 = 256 - fy;
 
-    double b12 = dx*b1 + dx1*b2;
-    double b34 = dx*b3 + dx1*b4;
+      for (int x = 0; x < width2; ++x) {
+        const Weight &xw = xweights[x];
 
-    double b = (dy*b12 + dy1*b34);
+        int fx = xw.f, fx1 = 256 - fx;
 
-    double a12 = dx*a1 + dx1*a2;
-    double a34 = dx*a3 + dx1*a4;
+        QRgb p11 = line1[xw.i1], p12 = line1[xw.i2];
+        QRgb p21 = line2[xw.i1], p22 = line2[xw.i2];
 
-    double a = (dy*a12 + dy1*a34);
+        // 16 bit fixed point interpolation of each 8 bit channel
+        auto interp = [&](int shift) {
+          int c11 = (p11 >> shift) & 0xff, c12 = (p12 >> shift) & 0xff;
+          int c21 = (p21 >> shift) & 0xff, c22 = (p22 >> shift) & 0xff;
 
-    return CRGBA(r, g, b, a);
-  }
-  else {
-    double r, g, b, a;
+          int c1 = c11*fx1 + c12*fx;
+          int c2 = c21*fx1 + c22*fx;
 
-    getPixel(x1, y1, &r, &g, &b, &a);
+          return QRgb(((c1*fy1 + c2*fy + 32768) >> 16) & 0xff) << shift;
+        };
 
-    return CRGBA(r, g, b, a);
-  }
+        dline[x] = interp(24) | interp(16) | interp(8) | interp(0);
+      }
+    }
+  }, 8);
 }
 
 void
 CQSVGImageData::
-reshapeAverage(CSVGImageData *new_image) const
+reshapeAverage(QImage &image) const
 {
   int width1  = getWidth ();
   int height1 = getHeight();
 
-  int width2  = new_image->getWidth ();
-  int height2 = new_image->getHeight();
+  int width2  = image.width ();
+  int height2 = image.height();
 
-  if (width2 <= 0 || height2 <= 0)
-    return;
+  // per column/row inclusive source range
+  auto makeRanges = [](int n1, int n2) {
+    std::vector<std::pair<int, int>> ranges(n2);
 
-  double dx = (1.0*width1 )/width2 ;
-  double dy = (1.0*height1)/height2;
+    double d = (1.0*n1)/n2;
 
-  int xx1, yy1, xx2, yy2;
+    double v1 = 0.0;
+    double v2 = d;
 
-  double y1 = 0.0;
-  double y2 = dy;
+    for (int i = 0; i < n2; ++i, v1 = v2, v2 += d) {
+      int i1 = std::min(std::max(CMathGen::Round(v1), 0), n1 - 1);
+      int i2 = std::min(std::max(CMathGen::Round(v2), 0), n1 - 1);
 
-  for (int y = 0; y < height2; ++y, y1 = y2, y2 += dy) {
-    yy1 = std::min(std::max(CMathGen::Round(y1), 0), height1 - 1);
-    yy2 = std::min(std::max(CMathGen::Round(y2), 0), height1 - 1);
+      ranges[i] = std::make_pair(i1, i2);
+    }
+
+    return ranges;
+  };
 
-    double x1 = 0.0;
-    double x2 = dx;
+  std::vector<std::pair<int, int>> xranges = makeRanges(width1 , width2 );
+  std::vector<std::pair<int, int>> yranges = makeRanges(height1, height2);
 
-    for (int x = 0; x < width2; ++x, x1 = x2, x2 += dx) {
-      xx1 = std::min(std::max(CMathGen::Round(x1), 0), width1 - 1);
-      xx2 = std::min(std::max(CMathGen::Round(x2), 0), width1 - 1);
+  CQSVGThreadPoolInst->parallelFor(height2, [&](int l1, int l2) {
+    // per source row prefix sums (4 channels) and per destination column sums
+    std::vector<uint> prefix((width1 + 1)*4);
+    std::vector<uint> sums  (width2*4);
 
-      CRGBA rgba;
+    for (int y = l1; y < l2; ++y) {
+      int yy1 = yranges[y].first;
+      int yy2 = yranges[y].second;
+
+      std::fill(sums.begin(), sums.end(), 0);
 
       for (int yy = yy1; yy <= yy2; ++yy) {
-        for (int xx = xx1; xx <= xx2; ++xx) {
-          CRGBA rgba1 = getPixel(xx, yy);
+        const QRgb *line = reinterpret_cast<const QRgb *>(qimage_.constScanLine(yy));
+
+        for (int x = 0; x < width1; ++x) {
+          QRgb p = line[x];
 
-          rgba += rgba1;
+          uint *p1 = &prefix[x*4];
+          uint *p2 = p1 + 4;
+
+          p2[0] = p1[0] + qRed  (p);
+          p2[1] = p1[1] + qGreen(p);
+          p2[2] = p1[2] + qBlue (p);
+          p2[3] = p1[3] + qAlpha(p);
+        }
+
+        for (int x = 0; x < width2; ++x) {
+          const uint *p1 = &prefix[ xranges[x].first       *4];
+          const uint *p2 = &prefix[(xranges[x].second + 1)*4];
+
+          uint *s = &sums[x*4];
+
+          s[0] += p2[0] - p1[0];
+          s[1] += p2[1] - p1[1];
+          s[2] += p2[2] - p1[2];
+          s[3] += p2[3] - p1[3];
         }
       }
 
-      int n = (xx2 - xx1 + 1)*(yy2 - yy1 + 1);
+      QRgb *dline = reinterpret_cast<QRgb *>(image.scanLine(y));
+
+      for (int x = 0; x < width2; ++x) {
+        uint n = (xranges[x].second - xranges[x].first + 1)*(yy2 - yy1 + 1);
 
-      rgba /= n;
+        const uint *s = &sums[x*4];
 
-      new_image->setPixel(x, y, rgba);
+        dline[x] = qRgba((s[0] + n/2)/n, (s[1] + n/2)/n, (s[2] + n/2)/n, (s[3] + n/2)/n);
+      }
     }
-  }
+  }, 4);
 }
 
 void
 CQSVGImageData::
-reshapeNearest(CSVGImageData *new_image) const
+reshapeNearest(QImage &image) const
 {
   int width1  = getWidth ();
   int height1 = getHeight();
 
-  if (width1 <= 0 || height1 <= 0)
-    return;
-
-  int width2  = new_image->getWidth ();
-  int height2 = new_image->getHeight();
-
-  if (width2 <= 0 || height2 <= 0)
-    return;
+  int width2  = image.width ();
+  int height2 = image.height();
 
   double dx = (1.0*width1 )/width2 ;
   double dy = (1.0*height1)/height2;
 
-  double y1 = 0.0;
+  // source column of each destination column
+  std::vector<int> xindex(width2);
 
-  for (int y = 0; y < height2; ++y, y1 += dy) {
-    double x1 = 0.0;
+  double x1 = 0.0;
 
-    for (int x = 0; x < width2; ++x, x1 += dx) {
-      int x2 = std::min(std::max(int(x1), 0), width1  - 1);
-      int y2 = std::min(std::max(int(y1), 0), height1 - 1);
+  for (int x = 0; x < width2; ++x, x1 += dx)
+    xindex[x] = std::min(std::max(int(x1), 0), width1 - 1);
 
-      CRGBA rgba = getPixel(x2, y2);
+  CQSVGThreadPoolInst->parallelFor(height2, [&](int l1, int l2) {
+    for (int y = l1; y < l2; ++y) {
+      int y1 = std::min(std::max(int(y*dy), 0), height1 - 1);
 
-      new_image->setPixel(x, y, rgba);
+      const QRgb *sline = reinterpret_cast<const QRgb *>(qimage_.constScanLine(y1));
+      QRgb       *dline = reinterpret_cast<QRgb *>(image.scanLine(y));
+
+      for (int x = 0; x < width2; ++x)
+        dline[x] = sline[xindex[x]];
     }
-  }
+  }, 16);
 }
 
 void
 CQSVGImageData::
 reshapeKeepAspect(int width, int height)
+{
+  reshapeKeepAspect(width, height, resizeType_);
+}
+
+void
+CQSVGImageData::
+reshapeKeepAspect(int width, int height, CImageResizeType type)
 {
   if (getWidth() <= 0 || getHeight() <= 0)
     return;
@@ -520,33 +983,33 @@ reshapeKeepAspect(int width, int height)
   double yfactor = (1.0*height)/getHeight();
 
   if (xfactor < yfactor)
-    reshapeWidth(width);
+    reshapeWidth(width, type);
   else
-    reshapeHeight(height);
+    reshapeHeight(height, type);
 }
 
 void
 CQSVGImageData::
-reshapeWidth(int width)
+reshapeWidth(int width, CImageResizeType type)
 {
   if (getWidth() <= 0)
     return;
 
   int height = (width*getHeight())/getWidth();
 
-  reshape(width, height);
+  reshape(width, height, type);
 }
 
 void
 CQSVGImageData::
-reshapeHeight(int height)
+reshapeHeight(int height, CImageResizeType type)
 {
   if (getHeight() <= 0)
     return;
 
   int width = (height*getWidth())/getHeight();
 
-  reshape(width, height);
+  reshape(width, height, type);
 }
 
 void
@@ -653,8 +1116,13 @@ convolve(CSVGImageData *in, const CImageConvolveData &data)
 
   //---
 
-  int xborder = (xsize - 1)/2;
-  int yborder = (ysize - 1)/2;
+  // kernel target (origin) is (xsize - 1)/2, (ysize - 1)/2 so for an even order kernel
+  // there is one more tap right of/below the target than left of/above it
+  int targetX = (xsize - 1)/2;
+  int targetY = (ysize - 1)/2;
+
+  int xborder1 = targetX, xborder2 = xsize - 1 - targetX;
+  int yborder1 = targetY, yborder2 = ysize - 1 - targetY;
 
   double divisor = data.divisor;
 
@@ -670,74 +1138,157 @@ convolve(CSVGImageData *in, const CImageConvolveData &data)
 
   //---
 
-  int wx1, wy1, wx2, wy2;
+  toScanlineFormat();
 
-  getWindow(&wx1, &wy1, &wx2, &wy2);
+  dst->toScanlineFormat();
+
+  int w = std::min(getWidth (), dst->getWidth ());
+  int h = std::min(getHeight(), dst->getHeight());
 
-  int y = wy1;
+  if (w <= 0 || h <= 0)
+    return;
 
-  for ( ; y < yborder; ++y) {
-    int x = wx1;
+  // only compute region of interest (pixels within border of it are read)
+  int footprint = std::max(std::max(xborder1, xborder2), std::max(yborder1, yborder2));
 
-    for ( ; x <= wx2 - xborder; ++x) {
-      CRGBA rgba = getPixel(x, y);
+  addFootprint(footprint);
+
+  QRect wrect = roiRect().intersected(QRect(0, 0, w, h));
+
+  if (wrect.isEmpty())
+    return;
+
+  int wx1 = wrect.left(), wx2 = wrect.right ();
+  int wy1 = wrect.top (), wy2 = wrect.bottom();
 
-      dst->setPixel(x, y, rgba);
+  // pixels within border of edge are copied unchanged
+  int ix1 = xborder1, ix2 = w - 1 - xborder2;
+  int iy1 = yborder1, iy2 = h - 1 - yborder2;
+
+  for (int y = wy1; y <= wy2; ++y) {
+    const QRgb *sline = reinterpret_cast<const QRgb *>(qimage_.constScanLine(y));
+    QRgb       *dline = reinterpret_cast<QRgb *>(dst->qimage_.scanLine(y));
+
+    if (y < iy1 || y > iy2)
+      memcpy(dline + wx1, sline + wx1, (wx2 - wx1 + 1)*sizeof(QRgb));
+    else {
+      for (int x = wx1; x <= std::min(ix1 - 1, wx2); ++x)
+        dline[x] = sline[x];
+
+      for (int x = std::max(ix2 + 1, wx1); x <= wx2; ++x)
+        dline[x] = sline[x];
     }
   }
 
-  for ( ; y <= wy2 - yborder; ++y) {
-    int x = wx1;
+  // interior pixels in region of interest
+  int cx1 = std::max(ix1, wx1), cx2 = std::min(ix2, wx2);
+  int cy1 = std::max(iy1, wy1), cy2 = std::min(iy2, wy2);
 
-    for ( ; x < xborder; ++x) {
-      CRGBA rgba = getPixel(x, y);
+  if (cx1 > cx2 || cy1 > cy2)
+    return;
+
+  //---
+
+  // float copy of used source pixels (sx, sy is origin)
+  QRect srect(QPoint(cx1 - xborder1, cy1 - yborder1), QPoint(cx2 + xborder2, cy2 + yborder2));
+
+  FloatImage src;
+
+  toFloatImage(qimage_, src, srect);
+
+  int sx = srect.left();
+  int sy = srect.top ();
+
+  int nx = cx2 - cx1 + 1;
+  int ny = cy2 - cy1 + 1;
+
+  float scale = float(1.0/divisor);
+
+  // write convolved interior pixel sums of row y to destination
+  auto storeRow = [&](int y, const float *sums) {
+    QRgb *dline = reinterpret_cast<QRgb *>(dst->qimage_.scanLine(y));
+
+    for (int i = 0; i < nx; ++i, sums += 4) {
+      int x = cx1 + i;
+
+      float a = (data.preserveAlpha ? src.pixel(x - sx, y - sy)[3] : sums[3]*scale);
 
-      dst->setPixel(x, y, rgba);
+      dline[x] = packPixel(sums[0]*scale, sums[1]*scale, sums[2]*scale, a);
     }
+  };
+
+  std::vector<float> row, col;
 
-    for ( ; x <= wx2 - xborder; ++x) {
-      CRGBA sum;
+  if (separateKernel(data.kernel, xsize, ysize, row, col)) {
+    // two pass: horizontal (all source rows) then vertical (interior rows)
+    FloatImage hsum(nx, src.h);
 
-      int k = 0;
+    CQSVGThreadPoolInst->parallelFor(src.h, [&](int y1, int y2) {
+      for (int y = y1; y < y2; ++y) {
+        float *o = hsum.pixel(0, y);
 
-      for (int yk = -yborder; yk <= yborder; ++yk) {
-        for (int xk = -xborder; xk <= xborder; ++xk) {
-          CRGBA rgba = getPixel(x + xk, y + yk);
+        for (int i = 0; i < nx; ++i, o += 4) {
+          const float *f = src.pixel(i, y);
 
-          sum += rgba*data.kernel[k];
+          float s[4] = { 0, 0, 0, 0 };
 
-          ++k;
+          for (int k = 0; k < xsize; ++k, f += 4) {
+            s[0] += row[k]*f[0]; s[1] += row[k]*f[1]; s[2] += row[k]*f[2]; s[3] += row[k]*f[3];
+          }
+
+          o[0] = s[0]; o[1] = s[1]; o[2] = s[2]; o[3] = s[3];
         }
       }
+    });
+
+    CQSVGThreadPoolInst->parallelFor(ny, [&](int l1, int l2) {
+      std::vector<float> sums(nx*4);
 
-      sum /= divisor;
+      for (int l = l1; l < l2; ++l) {
+        std::fill(sums.begin(), sums.end(), 0.0f);
 
-      sum.clamp();
+        for (int k = 0; k < ysize; ++k) {
+          const float *f = hsum.pixel(0, l + k);
 
-      if (data.preserveAlpha) {
-        CRGBA rgba = getPixel(x, y);
+          float c = col[k];
 
-        sum.setAlpha(rgba.getAlpha());
+          for (int i = 0; i < nx*4; ++i)
+            sums[i] += c*f[i];
+        }
+
+        storeRow(cy1 + l, &sums[0]);
       }
+    });
+  }
+  else {
+    // general kernel
+    std::vector<float> kernel(data.kernel.begin(), data.kernel.end());
 
-      dst->setPixel(x, y, sum);
-    }
+    kernel.resize(xsize*ysize, 0.0f);
 
-    for ( ; x <= wx2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+    CQSVGThreadPoolInst->parallelFor(ny, [&](int l1, int l2) {
+      std::vector<float> sums(nx*4);
 
-      dst->setPixel(x, y, rgba);
-    }
-  }
+      for (int l = l1; l < l2; ++l) {
+        std::fill(sums.begin(), sums.end(), 0.0f);
 
-  for ( ; y <= wy2; ++y) {
-    int x = wx1;
+        for (int yk = 0; yk < ysize; ++yk) {
+          for (int xk = 0; xk < xsize; ++xk) {
+            float kv = kernel[yk*xsize + xk];
 
-    for ( ; x <= wx2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+            if (kv == 0.0f)
+              continue;
 
-      dst->setPixel(x, y, rgba);
-    }
+            const float *f = src.pixel(xk, l + yk);
+
+            for (int i = 0; i < nx*4; ++i)
+              sums[i] += kv*f[i];
+          }
+        }
+
+        storeRow(cy1 + l, &sums[0]);
+      }
+    });
   }
 }
 
@@ -747,32 +1298,21 @@ applyColorMatrix(const std::vector<double> &m)
 {
   assert(m.size() == 20);
 
-  int x1, y1, x2, y2;
-
-  getWindow(&x1, &y1, &x2, &y2);
-
-  for (int y = y1; y <= y2; ++y) {
-    for (int x = x1; x <= x2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+  toScanlineFormat();
 
-      double r, g, b, a;
+  float fm[20];
 
-      rgba.getRGBA(&r, &g, &b, &a);
+  for (int i = 0; i < 20; ++i)
+    fm[i] = float(m[i]);
 
-      double a1 = m[15]*r + m[16]*g + m[17]*b + m[18]*a + m[19];
+  int x1, y1, x2, y2;
 
-      if (a1 > 0) {
-        double r1 = m[ 0]*r + m[ 1]*g + m[ 2]*b + m[ 3]*a + m[ 4];
-        double g1 = m[ 5]*r + m[ 6]*g + m[ 7]*b + m[ 8]*a + m[ 9];
-        double b1 = m[10]*r + m[11]*g + m[12]*b + m[13]*a + m[14];
+  getWindow(&x1, &y1, &x2, &y2);
 
-        CRGBA rgba1(r1, g1, b1, a1);
+  for (int y = y1; y <= y2; ++y) {
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
 
-        setPixel(x, y, rgba1);
-      }
-      else
-        setPixel(x, y, CRGBA(0,0,0,0));
-    }
+    colorMatrixLine(line + x1, x2 - x1 + 1, fm);
   }
 }
 
@@ -780,25 +1320,41 @@ void
 CQSVGImageData::
 saturate(double ds)
 {
+  toScanlineFormat();
+
   int x1, y1, x2, y2;
 
   getWindow(&x1, &y1, &x2, &y2);
 
+  QRgb lastIn = 0, lastOut = 0;
+  bool hasLast = false;
+
   for (int y = y1; y <= y2; ++y) {
-    for (int x = x1; x <= x2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
 
-      CHSV hsv = CRGBUtil::RGBtoHSV(rgba.getRGB());
+    for (int x = x1; x <= x2; ++x) {
+      QRgb p = line[x];
 
-      double s = hsv.getSaturation();
+      // HSV conversion is expensive so reuse result for runs of the same color
+      if (hasLast && p == lastIn) {
+        line[x] = lastOut;
+        continue;
+      }
 
-      s *= ds;
+      CHSV hsv = CRGBUtil::RGBtoHSV(CRGB(qRed(p)*inv255, qGreen(p)*inv255, qBlue(p)*inv255));
 
-      hsv.setSaturation(s);
+      hsv.setSaturation(hsv.getSaturation()*ds);
 
       CRGB rgb = CRGBUtil::HSVtoRGB(hsv);
 
-      setPixel(x, y, CRGBA(rgb, rgba.getAlpha()));
+      QRgb q = qRgba(toByte(rgb.getRed()), toByte(rgb.getGreen()), toByte(rgb.getBlue()),
+                     qAlpha(p));
+
+      line[x] = q;
+
+      lastIn  = p;
+      lastOut = q;
+      hasLast = true;
     }
   }
 }
@@ -807,19 +1363,30 @@ void
 CQSVGImageData::
 rotateHue(double dh)
 {
+  toScanlineFormat();
+
   int x1, y1, x2, y2;
 
   getWindow(&x1, &y1, &x2, &y2);
 
+  QRgb lastIn = 0, lastOut = 0;
+  bool hasLast = false;
+
   for (int y = y1; y <= y2; ++y) {
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
+
     for (int x = x1; x <= x2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+      QRgb p = line[x];
 
-      CHSV hsv = CRGBUtil::RGBtoHSV(rgba.getRGB());
+      // HSV conversion is expensive so reuse result for runs of the same color
+      if (hasLast && p == lastIn) {
+        line[x] = lastOut;
+        continue;
+      }
 
-      double h = hsv.getHue();
+      CHSV hsv = CRGBUtil::RGBtoHSV(CRGB(qRed(p)*inv255, qGreen(p)*inv255, qBlue(p)*inv255));
 
-      h += dh;
+      double h = hsv.getHue() + dh;
 
       while (h <  0    ) h += 360.0;
       while (h >= 360.0) h -= 360.0;
@@ -828,7 +1395,14 @@ rotateHue(double dh)
 
       CRGB rgb = CRGBUtil::HSVtoRGB(hsv);
 
-      setPixel(x, y, CRGBA(rgb, rgba.getAlpha()));
+      QRgb q = qRgba(toByte(rgb.getRed()), toByte(rgb.getGreen()), toByte(rgb.getBlue()),
+                     qAlpha(p));
+
+      line[x] = q;
+
+      lastIn  = p;
+      lastOut = q;
+      hasLast = true;
     }
   }
 }
@@ -837,25 +1411,30 @@ void
 CQSVGImageData::
 luminanceToAlpha()
 {
+  toScanlineFormat();
+
+  // fixed point (16 bit) luminance factors
+  const int kr = int(0.2125*65536 + 0.5);
+  const int kg = int(0.7154*65536 + 0.5);
+  const int kb = int(0.0721*65536 + 0.5);
+
   int x1, y1, x2, y2;
 
   getWindow(&x1, &y1, &x2, &y2);
 
   for (int y = y1; y <= y2; ++y) {
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
+
     for (int x = x1; x <= x2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+      QRgb p = line[x];
 
-      //CHSV hsv = CRGBUtil::RGBtoHSV(rgba.getRGB()();
-      //double a1 = hsv.getValue();
-      //double a1 = rgba.getGray();
-      double a = 0.2125*rgba.getRed() + 0.7154*rgba.getGreen() + 0.0721*rgba.getBlue();
-      double a1 = a*rgba.getAlpha();
+      // luminance (0-255 << 16) scaled by alpha (0-255)
+      uint l  = uint(kr*qRed(p) + kg*qGreen(p) + kb*qBlue(p));
+      uint a1 = uint((qulonglong(l)*qAlpha(p)/255 + 32768) >> 16);
 
-      //rgba.setAlpha(a1);
-      //setPixel(x, y, rgba);
+      if (a1 > 255) a1 = 255;
 
-      CRGBA rgba1(a1, a1, a1, a1);
-      setPixel(x, y, rgba1);
+      line[x] = qRgba(a1, a1, a1, a1);
     }
   }
 }
@@ -864,22 +1443,28 @@ void
 CQSVGImageData::
 linearFunc(CColorComponent component, double scale, double offset)
 {
-  int x1, y1, x2, y2;
+  int shift = componentShift(component);
+  if (shift < 0) return;
 
-  getWindow(&x1, &y1, &x2, &y2);
+  toScanlineFormat();
 
-  for (int y = y1; y <= y2; ++y) {
-    for (int x = x1; x <= x2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+  // function only depends on component byte value so apply as lookup table
+  uchar lut[256];
 
-      double value = rgba.getComponent(component);
+  for (int i = 0; i < 256; ++i) {
+    double value = i/255.0;
+
+    lut[i] = toByte(value*scale + offset);
+  }
 
-      value = value*scale + offset;
+  int x1, y1, x2, y2;
 
-      rgba.setComponent(component, value);
+  getWindow(&x1, &y1, &x2, &y2);
 
-      setPixel(x, y, rgba.clamp());
-    }
+  for (int y = y1; y <= y2; ++y) {
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
+
+    applyComponentLUT(line + x1, x2 - x1 + 1, shift, lut);
   }
 }
 
@@ -887,22 +1472,28 @@ void
 CQSVGImageData::
 gammaFunc(CColorComponent component, double amplitude, double exponent, double offset)
 {
-  int x1, y1, x2, y2;
+  int shift = componentShift(component);
+  if (shift < 0) return;
 
-  getWindow(&x1, &y1, &x2, &y2);
+  toScanlineFormat();
 
-  for (int y = y1; y <= y2; ++y) {
-    for (int x = x1; x <= x2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+  // function only depends on component byte value so apply as lookup table
+  uchar lut[256];
+
+  for (int i = 0; i < 256; ++i) {
+    double value = i/255.0;
 
-      double value = rgba.getComponent(component);
+    lut[i] = toByte(amplitude*pow(value, exponent) + offset);
+  }
 
-      value = amplitude*pow(value, exponent) + offset,
+  int x1, y1, x2, y2;
 
-      rgba.setComponent(component, value);
+  getWindow(&x1, &y1, &x2, &y2);
 
-      setPixel(x, y, rgba.clamp());
-    }
+  for (int y = y1; y <= y2; ++y) {
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
+
+    applyComponentLUT(line + x1, x2 - x1 + 1, shift, lut);
   }
 }
 
@@ -916,40 +1507,48 @@ tableFunc(CColorComponent component, const std::vector<double> &values)
 
   double delta = 1.0/num_ranges;
 
-  int x1, y1, x2, y2;
+  int shift = componentShift(component);
+  if (shift < 0) return;
 
-  getWindow(&x1, &y1, &x2, &y2);
+  toScanlineFormat();
 
-  for (int y = y1; y <= y2; ++y) {
-    for (int x = x1; x <= x2; ++x) {
-      // get component color value
-      CRGBA rgba = getPixel(x, y);
+  // function only depends on component byte value so apply as lookup table
+  uchar lut[256];
 
-      double value = rgba.getComponent(component);
+  for (int i = 0; i < 256; ++i) {
+    double value = i/255.0;
 
-      // get associated range index
-      int    i = 0;
-      double value1, value2;
+    // get associated range index
+    int    j = 0;
+    double value1 = 0.0, value2 = 0.0;
 
-      for ( ; i < num_ranges; ++i) {
-        value1 = i*delta;
-        value2 = value1 + delta;
+    for ( ; j < num_ranges; ++j) {
+      value1 = j*delta;
+      value2 = value1 + delta;
 
-        if (value >= value1 && value < value2) break;
-      }
+      if (value >= value1 && value < value2) break;
+    }
+
+    // outside ranges is unchanged
+    if (j >= num_ranges) {
+      lut[i] = i;
+      continue;
+    }
 
-      if (i >= num_ranges) continue;
+    // remap to new range
+    double m = (values[j + 1] - values[j])/(value2 - value1);
 
-      // remap to new range
-      double m = (values[i + 1] - values[i])/(value2 - value1);
+    lut[i] = toByte((value - value1)*m + values[j]);
+  }
 
-      value = (value - value1)*m + values[i];
+  int x1, y1, x2, y2;
 
-      // update color
-      rgba.setComponent(component, value);
+  getWindow(&x1, &y1, &x2, &y2);
 
-      setPixel(x, y, rgba.clamp());
-    }
+  for (int y = y1; y <= y2; ++y) {
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
+
+    applyComponentLUT(line + x1, x2 - x1 + 1, shift, lut);
   }
 }
 
@@ -963,37 +1562,44 @@ discreteFunc(CColorComponent component, const std::vector<double> &values)
 
   double delta = 1.0/num_ranges;
 
-  int x1, y1, x2, y2;
+  int shift = componentShift(component);
+  if (shift < 0) return;
 
-  getWindow(&x1, &y1, &x2, &y2);
+  toScanlineFormat();
 
-  for (int y = y1; y <= y2; ++y) {
-    for (int x = x1; x <= x2; ++x) {
-      // get component color value
-      CRGBA rgba = getPixel(x, y);
+  // function only depends on component byte value so apply as lookup table
+  uchar lut[256];
 
-      double value = rgba.getComponent(component);
+  for (int i = 0; i < 256; ++i) {
+    double value = i/255.0;
 
-      // get associated range index
-      uint i = 0;
+    // get associated range index
+    uint j = 0;
 
-      for ( ; i < num_ranges; ++i) {
-        double value1 = i*delta;
-        double value2 = value1 + delta;
+    for ( ; j < num_ranges; ++j) {
+      double value1 = j*delta;
+      double value2 = value1 + delta;
 
-        if (value >= value1 && value < value2) break;
-      }
+      if (value >= value1 && value < value2) break;
+    }
+
+    // outside ranges is unchanged
+    if (j >= num_ranges) {
+      lut[i] = i;
+      continue;
+    }
 
-      if (i >= num_ranges) continue;
+    lut[i] = toByte(values[j]);
+  }
 
-      // set to new value
-      value = values[i];
+  int x1, y1, x2, y2;
 
-      // update color
-      rgba.setComponent(component, value);
+  getWindow(&x1, &y1, &x2, &y2);
 
-      setPixel(x, y, rgba.clamp());
-    }
+  for (int y = y1; y <= y2; ++y) {
+    QRgb *line = reinterpret_cast<QRgb *>(qimage_.scanLine(y));
+
+    applyComponentLUT(line + x1, x2 - x1 + 1, shift, lut);
   }
 }
 
@@ -1004,7 +1610,9 @@ displacementMap(CSVGImageData *in, CColorComponent xcolor, CColorComponent ycolo
   CQSVGImageData *dispImage = dynamic_cast<CQSVGImageData *>(in);
   assert(dispImage);
 
-  CSVGImageData *dst = dup();
+  CSVGImageData *dst = newImage(getWidth(), getHeight());
+
+  addFootprint(int(ceil(fabs(scale)/2)));
 
   int wx1, wy1, wx2, wy2;
 
@@ -1049,213 +1657,273 @@ void
 CQSVGImageData::
 gaussianBlur(CSVGImageData *in, double stdDevX, double stdDevY)
 {
-  class CImageWrapper {
-   public:
-    CImageWrapper(CQSVGImageData *image) :
-     image_(image) {
-    }
+  CQSVGImageData *qin = dynamic_cast<CQSVGImageData *>(in);
+  assert(qin);
 
-    void getPixelRange(int *x1, int *y1, int *x2, int *y2) const {
-      *x1 = 0;
-      *y1 = 0;
-      *x2 = image_->getWidth () - 1;
-      *y2 = image_->getHeight() - 1;
-    }
+  toScanlineFormat();
 
-    void getWindow(int *x1, int *y1, int *x2, int *y2) const {
-      image_->getWindow(x1, y1, x2, y2);
-    }
+  qin->toScanlineFormat();
 
-    void getRGBA(int x, int y, double *r, double *g, double *b, double *a) const {
-      CRGBA rgba = image_->getPixel(x, y);
+  int footprint = std::max(blurFootprint(stdDevX), blurFootprint(stdDevY));
 
-      *r = rgba.getRed  ();
-      *g = rgba.getGreen();
-      *b = rgba.getBlue ();
-      *a = rgba.getAlpha();
-    }
+  addFootprint(footprint);
 
-    void setRGBA(int x, int y, double r, double g, double b, double a) {
-      image_->setPixel(x, y, CRGBA(r, g, b, a));
-    }
+  // only blur region of interest and the pixels within the blur radius which it uses
+  QRect rect = roiRect(footprint);
 
-   private:
-    CQSVGImageData *image_;
-  };
+  if (rect.isEmpty())
+    return;
 
-  //---
+  // separable: blur rows then columns (outside of image is transparent)
+  FloatImage fimage;
 
-  CQSVGImageData *qin = dynamic_cast<CQSVGImageData *>(in);
-  assert(qin);
+  toFloatImage(qimage_, fimage, rect);
 
-  CGaussianBlur<CImageWrapper> blur;
+  FloatImage tmp;
 
-  CImageWrapper wsrc(this);
-  CImageWrapper wdst(qin);
+  gaussianBlurPass(fimage, tmp, stdDevX, true );
+  gaussianBlurPass(fimage, tmp, stdDevY, false);
 
-  blur.blur(wsrc, wdst, stdDevX, stdDevY, 0, 0);
+  fromFloatImage(fimage, qin->qimage_, rect.topLeft());
 }
 
 CSVGImageData *
 CQSVGImageData::
 erode(int r, bool isAlpha)
 {
-  int r1 = 2*r + 1;
-  int r2 = r1*r1;
-
-  std::vector<int> mask;
-
-  mask.resize(r2);
-
-  for (int i = 0, iy = -r; iy <= r; ++iy) {
-    for (int ix = -r; ix <= r; ++ix, ++i) {
-      double r1 = hypot(ix, iy);
-
-      mask[i] = (r1 <= r ? 1 : 0);
-    }
-  }
-
-  return erode(mask, isAlpha);
+  // feMorphology uses rectangular structuring element
+  return erodeDilateRect(r, isAlpha, true);
 }
 
 CSVGImageData *
 CQSVGImageData::
-erode(const std::vector<int> &mask, bool isAlpha) const
+dilate(int r, bool isAlpha)
 {
-  return erodeDilate(mask, isAlpha, true);
+  // feMorphology uses rectangular structuring element
+  return erodeDilateRect(r, isAlpha, false);
 }
 
 CSVGImageData *
 CQSVGImageData::
-dilate(int r, bool isAlpha)
+erodeDilateRect(int r, bool isAlpha, bool isErode)
 {
-  int r1 = 2*r + 1;
-  int r2 = r1*r1;
+  int w = getWidth ();
+  int h = getHeight();
+
+  if (r < 0)
+    r = 0;
 
-  std::vector<int> mask;
+  addFootprint(r);
 
-  mask.resize(r2);
+  // only process region of interest and the pixels within radius which it uses
+  QRect rect = roiRect(r);
 
-  for (int i = 0, iy = -r; iy <= r; ++iy) {
-    for (int ix = -r; ix <= r; ++ix, ++i) {
-      double r1 = hypot(ix, iy);
+  if (rect != QRect(0, 0, w, h)) {
+    CQSVGImageData *image = newImage(w, h, /*clear*/false);
 
-      mask[i] = (r1 <= r ? 1 : 0);
+    image->qimage_.fill(isAlpha ? qRgba(0, 0, 0, 0) : qRgba(0, 0, 0, 255));
+
+    if (! rect.isEmpty()) {
+      CQSVGImageData *sub = static_cast<CQSVGImageData *>(
+        subImage(rect.x(), rect.y(), rect.width(), rect.height()));
+
+      sub->roi_.reset();
+
+      CSVGImageData *subResult = sub->erodeDilateRect(r, isAlpha, isErode);
+
+      subResult->subCopyTo(image, 0, 0, rect.width(), rect.height(), rect.x(), rect.y());
+
+      delete subResult;
+      delete sub;
     }
+
+    return image;
   }
 
-  return dilate(mask, isAlpha);
-}
+  //---
 
-CSVGImageData *
-CQSVGImageData::
-dilate(const std::vector<int> &mask, bool isAlpha) const
-{
-  return erodeDilate(mask, isAlpha, false);
-}
+  CQSVGImageData *image = newImage(w, h, /*clear*/false);
 
-CSVGImageData *
-CQSVGImageData::
-erodeDilate(const std::vector<int> &mask, bool isAlpha, bool isErode) const
-{
-  int r = (sqrt(mask.size()) - 1)/2;
+  toScanlineFormat();
 
-  // count mask bits
-  int num_hits = 0;
+  int k = 2*r + 1;
 
-  for (const auto &m : mask)
-    num_hits += m;
+  // pixels within r of edge are unset
+  if (w < k || h < k) {
+    image->qimage_.fill(isAlpha ? qRgba(0, 0, 0, 0) : qRgba(0, 0, 0, 255));
+    return image;
+  }
 
   //---
 
-  int width  = getWidth ();
-  int height = getHeight();
+  // hit (1) if alpha (or gray) > 0.5
+  std::vector<uchar> hits(size_t(w)*h);
 
-  CSVGImageData *image = dup();
+  CQSVGThreadPoolInst->parallelFor(h, [&](int y1, int y2) {
+    for (int y = y1; y < y2; ++y) {
+      const QRgb *line = reinterpret_cast<const QRgb *>(qimage_.constScanLine(y));
 
-  image->setSize(width, height);
+      uchar *hline = &hits[size_t(y)*w];
 
-  int x1, y1, x2, y2;
+      for (int x = 0; x < w; ++x) {
+        QRgb p = line[x];
 
-  getWindow(&x1, &y1, &x2, &y2);
+        if (isAlpha)
+          hline[x] = (qAlpha(p) > 127 ? 1 : 0);
+        else
+          hline[x] = (CRGBA(qRed(p)*inv255, qGreen(p)*inv255, qBlue(p)*inv255).getGray() > 0.5);
+      }
+    }
+  });
 
-  for (int y = y1; y <= y2; ++y) {
-    bool yinside = (y >= y1 + r && y <= y2 - r);
+  //---
 
-    for (int x = x1; x <= x2; ++x) {
-      bool xinside = (x >= x1 + r && x <= x2 - r);
+  // erode is set if all hit (min), dilate if any hit (max). Separable so run
+  // rows then columns
+  std::vector<uchar> rowHits(size_t(w)*h), setHits(size_t(w)*h, 0);
 
-      bool isSet = (xinside && yinside);
+  auto opMin = [](uchar a, uchar b) { return std::min(a, b); };
+  auto opMax = [](uchar a, uchar b) { return std::max(a, b); };
 
-      CRGBA rgba;
+  CQSVGThreadPoolInst->parallelFor(h, [&](int y1, int y2) {
+    std::vector<uchar> g(w), gh(w);
 
-      if (isSet) {
-        // count mask hits
-        int hits = 0;
+    for (int y = y1; y < y2; ++y) {
+      size_t o = size_t(y)*w;
 
-        for (int i = 0, ix = -r; ix <= r; ++ix)
-          for (int iy = -r; iy <= r; ++iy, ++i)
-            if (mask[i] && isErodePixel(x + ix, y + iy, isAlpha, rgba))
-              ++hits;
+      if (isErode)
+        vanHerkLine(&hits[o], &rowHits[o], w, 1, r, &g[0], &gh[0], opMin);
+      else
+        vanHerkLine(&hits[o], &rowHits[o], w, 1, r, &g[0], &gh[0], opMax);
+    }
+  });
 
-        if (isErode)
-          isSet = (hits == num_hits);
-        else
-          isSet = (hits > 0);
+  CQSVGThreadPoolInst->parallelFor(w - 2*r, [&](int x1, int x2) {
+    std::vector<uchar> g(h), gh(h);
+
+    for (int x = r + x1; x < r + x2; ++x) {
+      if (isErode)
+        vanHerkLine(&rowHits[x], &setHits[x], h, w, r, &g[0], &gh[0], opMin);
+      else
+        vanHerkLine(&rowHits[x], &setHits[x], h, w, r, &g[0], &gh[0], opMax);
+    }
+  });
+
+  //---
+
+  if (! isAlpha) {
+    CQSVGThreadPoolInst->parallelFor(h, [&](int y1, int y2) {
+      for (int y = y1; y < y2; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image->qimage_.scanLine(y));
+
+        const uchar *sline = &setHits[size_t(y)*w];
+
+        for (int x = 0; x < w; ++x)
+          line[x] = (sline[x] ? qRgba(255, 255, 255, 255) : qRgba(0, 0, 0, 255));
       }
+    });
+
+    return image;
+  }
+
+  //---
+
+  // set pixel color is sum of hit pixel colors in window divided by window size.
+  // Window sums use running sums of rows then columns
+  int num_hits = k*k;
 
-      int x2 = x - x1;
-      int y2 = y - y1;
+  image->qimage_.fill(qRgba(0, 0, 0, 0));
 
-      if (isAlpha) {
-        if (isSet) {
-          rgba /= num_hits;
+  std::vector<uint> rowSums(size_t(w)*h*4, 0);
 
-          image->setPixel(x2, y2, rgba);
+  CQSVGThreadPoolInst->parallelFor(h, [&](int y1, int y2) {
+    for (int y = y1; y < y2; ++y) {
+      const QRgb  *line  = reinterpret_cast<const QRgb *>(qimage_.constScanLine(y));
+      const uchar *hline = &hits[size_t(y)*w];
+
+      uint *sums = &rowSums[size_t(y)*w*4];
+
+      uint s[4] = { 0, 0, 0, 0 };
+
+      for (int x = 0; x < w; ++x) {
+        if (hline[x]) {
+          QRgb p = line[x];
+
+          s[0] += qRed(p); s[1] += qGreen(p); s[2] += qBlue(p); s[3] += qAlpha(p);
+        }
+
+        int x0 = x - k;
+
+        if (x0 >= 0 && hline[x0]) {
+          QRgb p = line[x0];
+
+          s[0] -= qRed(p); s[1] -= qGreen(p); s[2] -= qBlue(p); s[3] -= qAlpha(p);
+        }
+
+        // sum of window ending at x stored at window center
+        if (x >= k - 1) {
+          uint *o = &sums[(x - r)*4];
+
+          o[0] = s[0]; o[1] = s[1]; o[2] = s[2]; o[3] = s[3];
         }
-        else
-          image->setPixel(x2, y2, CRGBA(0, 0, 0, 0));
-      }
-      else {
-        if (isSet)
-          image->setPixel(x2, y2, CRGBA(1, 1, 1));
-        else
-          image->setPixel(x2, y2, CRGBA(0, 0, 0));
       }
     }
-  }
+  });
 
-  return image;
-}
+  CQSVGThreadPoolInst->parallelFor(w - 2*r, [&](int x1, int x2) {
+    int nx = x2 - x1;
 
-bool
-CQSVGImageData::
-isErodePixel(int x, int y, bool isAlpha, CRGBA &rgba) const
-{
-  CRGBA rgba1 = getPixel(x, y);
+    std::vector<qulonglong> s(nx*4, 0);
+
+    for (int y = 0; y < h; ++y) {
+      const uint *sums = &rowSums[(size_t(y)*w + r + x1)*4];
+
+      for (int i = 0; i < nx*4; ++i)
+        s[i] += sums[i];
+
+      int y0 = y - k;
+
+      if (y0 >= 0) {
+        const uint *sums0 = &rowSums[(size_t(y0)*w + r + x1)*4];
+
+        for (int i = 0; i < nx*4; ++i)
+          s[i] -= sums0[i];
+      }
+
+      if (y < k - 1)
+        continue;
+
+      int yc = y - r;
+
+      QRgb *line = reinterpret_cast<QRgb *>(image->qimage_.scanLine(yc));
+
+      const uchar *sline = &setHits[size_t(yc)*w];
 
-  if (isAlpha) {
-    if (rgba1.getAlpha() > 0.5) {
-      rgba += rgba1;
+      for (int i = 0; i < nx; ++i) {
+        int x = r + x1 + i;
 
-      return true;
+        if (! sline[x])
+          continue;
+
+        const qulonglong *si = &s[i*4];
+
+        line[x] = qRgba(int((si[0] + num_hits/2)/num_hits), int((si[1] + num_hits/2)/num_hits),
+                        int((si[2] + num_hits/2)/num_hits), int((si[3] + num_hits/2)/num_hits));
+      }
     }
-  }
-  else {
-    if (rgba1.getGray() > 0.5)
-      return true;
-  }
+  });
 
-  return false;
+  return image;
 }
 
 CSVGImageData *
 CQSVGImageData::
 tile(int width, int height, const CImageTile &tile)
 {
-  CSVGImageData *image = dup();
+  CQSVGImageData *image = newImage(width, height, /*clear*/false);
 
-  image->setSize(width, height);
+  // tiled image is not a sub image of this one
+  image->roiOffset_ = QPoint();
 
   //------
 
@@ -1287,18 +1955,16 @@ tile(int width, int height, const CImageTile &tile)
 
   //------
 
+  toScanlineFormat();
+
   for (int y = 0; y < height; ++y) {
     int y1 = (y + y_offset) % getHeight();
 
-    for (int x = 0; x < width; ++x) {
-      int x1 = (x + x_offset) % getWidth();
+    const QRgb *sline = reinterpret_cast<const QRgb *>(qimage_.constScanLine(y1));
+    QRgb       *dline = reinterpret_cast<QRgb *>(image->qimage_.scanLine(y));
 
-      double r, g, b, a;
-
-      getPixel(x1, y1, &r, &g, &b, &a);
-
-      image->setPixel(x, y, CRGBA(r, g, b, a));
-    }
+    for (int x = 0; x < width; ++x)
+      dline[x] = sline[(x + x_offset) % getWidth()];
   }
 
   //------
@@ -1310,47 +1976,44 @@ void
 CQSVGImageData::
 turbulence(bool fractal, double baseFreqX, double baseFreqY, int numOctaves, int seed)
 {
-  CTurbulenceUtil turbulence(seed);
+  toScanlineFormat();
+
+  CQSVGTurbulence::Params params;
 
-  double r, g, b, a, point[2];
+  params.fractal    = fractal;
+  params.baseFreqX  = baseFreqX;
+  params.baseFreqY  = baseFreqY;
+  params.numOctaves = numOctaves;
+  params.seed       = seed;
+  params.width      = getWidth ();
+  params.height     = getHeight();
 
   int wx1, wy1, wx2, wy2;
 
   getWindow(&wx1, &wy1, &wx2, &wy2);
 
-  for (int y = wy1; y <= wy2; ++y) {
-    for (int x = wx1; x <= wx2; ++x) {
-      CRGBA rgba = getPixel(x, y);
+  // only generate noise for window pixels in region of interest
+  QRect rect = roiRect().intersected(QRect(QPoint(wx1, wy1), QPoint(wx2, wy2)));
 
-      if (rgba.isTransparent())
-        continue;
+  if (rect.isEmpty())
+    return;
 
-      //TODO: keep alpha ?
-      //double a = rgba.getAlpha();
+  params.rect = rect;
 
-      point[0] = x;
-      point[1] = y;
+  QImage noise = CQSVGTurbulence::image(params);
 
-      r = turbulence.turbulence(0, point, baseFreqX, baseFreqY, numOctaves, fractal);
-      g = turbulence.turbulence(1, point, baseFreqX, baseFreqY, numOctaves, fractal);
-      b = turbulence.turbulence(2, point, baseFreqX, baseFreqY, numOctaves, fractal);
-      a = turbulence.turbulence(3, point, baseFreqX, baseFreqY, numOctaves, fractal);
+  // replace non-transparent pixels with noise
+  CQSVGThreadPoolInst->parallelFor(rect.height(), [&](int l1, int l2) {
+    for (int y = l1; y < l2; ++y) {
+      const QRgb *nline = reinterpret_cast<const QRgb *>(noise.constScanLine(y));
+      QRgb       *line  = reinterpret_cast<QRgb *>(qimage_.scanLine(rect.y() + y));
 
-      if (fractal) {
-        r = (r + 1.0) / 2.0;
-        g = (g + 1.0) / 2.0;
-        b = (b + 1.0) / 2.0;
-        a = (a + 1.0) / 2.0;
+      for (int x = 0; x < rect.width(); ++x) {
+        if (qAlpha(line[rect.x() + x]))
+          line[rect.x() + x] = nline[x];
       }
-
-      r = std::min(std::max(r, 0.0), 1.0);
-      g = std::min(std::max(g, 0.0), 1.0);
-      b = std::min(std::max(b, 0.0), 1.0);
-      a = std::min(std::max(a, 0.0), 1.0);
-
-      setPixel(x, y, CRGBA(r, g, b, a));
     }
-  }
+  });
 }
 
 void
@@ -1508,9 +2171,9 @@ CSVGImageData *
 CQSVGImageData::
 createRGBAMask()
 {
-  CSVGImageData *image = dup();
+  toScanlineFormat();
 
-  image->setSize(getWidth(), getHeight());
+  CQSVGImageData *image = newImage(getWidth(), getHeight(), /*clear*/false);
 
   //---
 
@@ -1528,17 +2191,28 @@ createRGBAMask()
   g /= sum;
   b /= sum;
 
+  // fixed point (16 bit) factors
+  const int kr = int(r*65536 + 0.5);
+  const int kg = int(g*65536 + 0.5);
+  const int kb = int(b*65536 + 0.5);
+
   //---
 
+  int w = getWidth();
+
   for (int y = 0; y < getHeight(); ++y) {
-    for (int x = 0; x < getWidth(); ++x) {
-      double r1, g1, b1, a1;
+    const QRgb *line1 = reinterpret_cast<const QRgb *>(qimage_.constScanLine(y));
+    QRgb       *line2 = reinterpret_cast<QRgb *>(image->qimage_.scanLine(y));
+
+    for (int x = 0; x < w; ++x) {
+      QRgb p = line1[x];
 
-      getPixel(x, y, &r1, &g1, &b1, &a1);
+      uint l  = uint(kr*qRed(p) + kg*qGreen(p) + kb*qBlue(p));
+      uint a1 = uint((qulonglong(l)*qAlpha(p)/255 + 32768) >> 16);
 
-      a = a1*(r*r1 + g*g1 + b*b1);
+      if (a1 > 255) a1 = 255;
 
-      image->setPixel(x, y, CRGBA(r1, g1, b1, a));
+      line2[x] = (p & 0x00ffffff) | (a1 << 24);
     }
   }
 
@@ -1558,10 +2232,53 @@ void
 CQSVGImageData::
 getWindow(int *x1, int *y1, int *x2, int *y2) const
 {
-  *x1 = 0;
-  *y1 = 0;
-  *x2 = getWidth () - 1;
-  *y2 = getHeight() - 1;
+  QRect rect = roiRect();
+
+  *x1 = rect.left  ();
+  *y1 = rect.top   ();
+  *x2 = rect.right ();
+  *y2 = rect.bottom();
+}
+
+QRect
+CQSVGImageData::
+roiRect(int footprint) const
+{
+  QRect irect(0, 0, getWidth(), getHeight());
+
+  if (! roi_ || roi_->rect.isNull())
+    return irect;
+
+  // only images of the same size (or sub images) are known to share coordinates
+  // with the image the region was set on
+  if (roiOffset_.isNull() && irect.size() != roi_->size)
+    return irect;
+
+  QRect rect = roi_->rect.translated(-roiOffset_);
+
+  return rect.adjusted(-footprint, -footprint, footprint, footprint).intersected(irect);
+}
+
+void
+CQSVGImageData::
+addFootprint(int footprint)
+{
+  if (roi_)
+    roi_->footprint += footprint;
+}
+
+void
+CQSVGImageData::
+toScanlineFormat()
+{
+  if (qimage_.format() != QImage::Format_ARGB32) {
+    assert(! locked_);
+
+    qimage_ = qimage_.convertToFormat(QImage::Format_ARGB32);
+  }
+
+  // detach shared data now so scanlines can be written from worker threads
+  (void) qimage_.bits();
 }
 
 bool
@@ -3,16 +3,33 @@
 
 #include <CSVGImageData.h>
 #include <QImage>
+#include <memory>
 
 class CQSVGImageData : public CSVGImageData {
+ public:
+  // region of interest of filter primitives. Shared by all images derived from the
+  // image it is set on (rect is in that image's coordinates) and records the sum of the
+  // footprints (pixel radius) of the primitives evaluated so the caller can inflate
+  // the next region to keep its pixels exact
+  struct ROI {
+    QRect rect;
+    QSize size;
+    int   footprint { 0 };
+  };
+
+  typedef std::shared_ptr<ROI> ROIP;
+
  public:
   CQSVGImageData();
   CQSVGImageData(const CQSVGImageData &data);
 
- ~CQSVGImageData() { }
+ ~CQSVGImageData();
 
   CSVGImageData *dup() const override;
 
+  // new image with same settings and (pooled) image data of specified size
+  CQSVGImageData *newImage(int w, int h, bool clear=true) const;
+
   CImagePtr image() const override;
   void setImage(CImagePtr &image) override;
 
@@ -22,6 +39,9 @@ class CQSVGImageData : public CSVGImageData {
   QImage *lockImage() { locked_ = true; return &qimage_; }
   void unlockImage() { assert(locked_); locked_ = false; }
 
+  const ROIP &roi() const { return roi_; }
+  void setROI(const ROIP &roi) { roi_ = roi; roiOffset_ = QPoint(); }
+
   void setSize(int w, int h) override;
 
   int getWidth () const override;
@@ -48,9 +68,15 @@ class CQSVGImageData : public CSVGImageData {
 
   void scaleAlpha(double alpha);
 
+  // resample type used by reshape (nearest is fastest, average best for reduction)
+  CImageResizeType resizeType() const { return resizeType_; }
+  void setResizeType(CImageResizeType type) { resizeType_ = type; }
+
   void reshape(int w, int h) override;
+  void reshape(int w, int h, CImageResizeType type);
 
   void reshapeKeepAspect(int w, int h) override;
+  void reshapeKeepAspect(int w, int h, CImageResizeType type);
 
   void clipOutside(int x1, int y1, int x2, int y2) override;
 
@@ -98,32 +124,35 @@ class CQSVGImageData : public CSVGImageData {
  private:
   void getPixel(int x, int y, double *r, double *g, double *b, double *a) const;
 
-  void reshapeBilinear(CSVGImageData *new_image) const;
-  void reshapeAverage (CSVGImageData *new_image) const;
-  void reshapeNearest (CSVGImageData *new_image) const;
+  void reshapeBilinear(QImage &image) const;
+  void reshapeAverage (QImage &image) const;
+  void reshapeNearest (QImage &image) const;
 
-  void reshapeWidth (int width );
-  void reshapeHeight(int height);
+  void reshapeWidth (int width , CImageResizeType type);
+  void reshapeHeight(int height, CImageResizeType type);
 
-  CRGBA getBilinearPixel(double xx, double yy) const;
-  CRGBA getBilinearPixel(double xx, int x1, int x2, double yy, int y1, int y2) const;
+  CSVGImageData *erodeDilateRect(int r, bool isAlpha, bool isErode);
 
-  CSVGImageData *erode (const std::vector<int> &mask, bool isAlpha) const;
-  CSVGImageData *dilate(const std::vector<int> &mask, bool isAlpha) const;
+  void getGrayPixel(int x, int y, double *gray) const;
 
-  CSVGImageData *erodeDilate(const std::vector<int> &mask, bool isAlpha, bool isErode) const;
+  void getWindow(int *x1, int *y1, int *x2, int *y2) const;
 
-  bool isErodePixel(int x, int y, bool isAlpha, CRGBA &rgba) const;
+  // part of image needed for region of interest of primitive with specified footprint
+  QRect roiRect(int footprint=0) const;
 
-  void getGrayPixel(int x, int y, double *gray) const;
+  void addFootprint(int footprint);
 
-  void getWindow(int *x1, int *y1, int *x2, int *y2) const;
+  // ensure image is ARGB32 (and unshared) for direct scanline access
+  void toScanlineFormat();
 
   bool validPixel(int x, int y) const;
 
  private:
-  QImage qimage_;
-  bool   locked_ { false };
+  QImage           qimage_;
+  bool             locked_ { false };
+  CImageResizeType resizeType_ { CIMAGE_RESIZE_NEAREST };
+  ROIP             roi_;
+  QPoint           roiOffset_;
 };
 
 #endif
@@ -0,0 +1,80 @@
+#include <CQSVGImagePool.h>
+
+namespace {
+
+// small images are cheap to allocate so are not pooled
+const int minPoolPixels = 64*64;
+
+// maximum memory held by pool
+const size_t maxPoolBytes = 64*1024*1024;
+
+}
+
+CQSVGImagePool::Images CQSVGImagePool::images_;
+size_t                 CQSVGImagePool::bytes_ = 0;
+std::mutex             CQSVGImagePool::mutex_;
+
+QImage
+CQSVGImagePool::
+acquire(int w, int h, bool clear)
+{
+  QImage image;
+
+  if (w*h >= minPoolPixels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto p = images_.begin(); p != images_.end(); ++p) {
+      if ((*p).width() == w && (*p).height() == h) {
+        image = *p;
+
+        bytes_ -= image.byteCount();
+
+        images_.erase(p);
+
+        break;
+      }
+    }
+  }
+
+  if (image.isNull())
+    image = QImage(QSize(w, h), QImage::Format_ARGB32);
+
+  if (clear)
+    image.fill(0);
+
+  return image;
+}
+
+void
+CQSVGImagePool::
+release(QImage &image)
+{
+  if (! image.isNull() && image.isDetached() && image.format() == QImage::Format_ARGB32 &&
+      image.width()*image.height() >= minPoolPixels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // most recently released at front, oldest dropped when over limit
+    images_.push_front(image);
+
+    bytes_ += image.byteCount();
+
+    while (bytes_ > maxPoolBytes && ! images_.empty()) {
+      bytes_ -= images_.back().byteCount();
+
+      images_.pop_back();
+    }
+  }
+
+  image = QImage();
+}
+
+void
+CQSVGImagePool::
+clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  images_.clear();
+
+  bytes_ = 0;
+}
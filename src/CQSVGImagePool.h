@@ -0,0 +1,32 @@
+#ifndef CQSVGImagePool_H
+#define CQSVGImagePool_H
+
+#include <QImage>
+#include <mutex>
+#include <list>
+
+// pool of ARGB32 image buffers reused by SVG filter intermediate images
+//
+// Images released to the pool (when no longer shared) are handed out again for
+// the same size, so a filter chain reuses a few buffers instead of allocating (and
+// page faulting) a new full size buffer for each primitive result.
+class CQSVGImagePool {
+ public:
+  // get image of size, cleared to transparent if clear is set
+  static QImage acquire(int w, int h, bool clear=true);
+
+  // return image buffer to pool (image is reset)
+  static void release(QImage &image);
+
+  // drop all pooled buffers
+  static void clear();
+
+ private:
+  typedef std::list<QImage> Images;
+
+  static Images     images_;
+  static size_t     bytes_;
+  static std::mutex mutex_;
+};
+
+#endif
@@ -0,0 +1,355 @@
+#include <CQSVGPath.h>
+#include <QPainterPathStroker>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+// maximum bytes of cached stroke outlines (least recently used dropped when reached)
+const size_t maxEntryBytes = 64*1024*1024;
+
+// maximum bytes of cached glyph outlines (least recently used dropped when reached)
+const size_t maxGlyphBytes = 8*1024*1024;
+
+// approximate bytes of painter path data
+size_t pathBytes(const QPainterPath &path) {
+  return sizeof(QPainterPath) + path.elementCount()*sizeof(QPainterPath::Element);
+}
+
+// copy of path which shares no data with path
+QPainterPath detachedPath(const QPainterPath &path) {
+  QPainterPath path1;
+
+  path1.addPath(path);
+
+  path1.setFillRule(path.fillRule());
+
+  return path1;
+}
+
+// combine value into hash
+size_t hashValue(size_t h, double value) {
+  uint64_t bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+
+  return h ^ (size_t(bits) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+}
+
+//---
+
+// stroke outline of path for pen (paths are deep copies only accessed under cache lock)
+struct CQSVGPath::Entry {
+  size_t              hash { 0 };
+  QPainterPath        path;
+  std::vector<double> strokeKey;
+  QPainterPath        stroke;
+  size_t              bytes { 0 };
+};
+
+CQSVGPath::EntryList CQSVGPath::entries_;
+CQSVGPath::EntryMap  CQSVGPath::entryMap_;
+size_t               CQSVGPath::entriesBytes_ { 0 };
+std::mutex           CQSVGPath::mutex_;
+
+void
+CQSVGPath::
+init()
+{
+  path_ = QPainterPath();
+  hash_ = 0;
+
+  start_   = QPointF();
+  current_ = QPointF();
+  empty_   = true;
+}
+
+void
+CQSVGPath::
+moveTo(const QPointF &p)
+{
+  path_.moveTo(p);
+
+  addValue(0);
+  addValue(p.x()); addValue(p.y());
+
+  start_   = p;
+  current_ = p;
+  empty_   = false;
+}
+
+void
+CQSVGPath::
+lineTo(const QPointF &p)
+{
+  path_.lineTo(p);
+
+  addValue(1);
+  addValue(p.x()); addValue(p.y());
+
+  current_ = p;
+  empty_   = false;
+}
+
+void
+CQSVGPath::
+quadTo(const QPointF &p1, const QPointF &p2)
+{
+  path_.quadTo(p1, p2);
+
+  addValue(2);
+  addValue(p1.x()); addValue(p1.y());
+  addValue(p2.x()); addValue(p2.y());
+
+  current_ = p2;
+  empty_   = false;
+}
+
+void
+CQSVGPath::
+cubicTo(const QPointF &p1, const QPointF &p2, const QPointF &p3)
+{
+  path_.cubicTo(p1, p2, p3);
+
+  addValue(3);
+  addValue(p1.x()); addValue(p1.y());
+  addValue(p2.x()); addValue(p2.y());
+  addValue(p3.x()); addValue(p3.y());
+
+  current_ = p3;
+  empty_   = false;
+}
+
+void
+CQSVGPath::
+arcTo(const QRectF &rect, double startAngle, double sweepLength)
+{
+  path_.arcTo(rect, startAngle, sweepLength);
+
+  addValue(4);
+  addValue(rect.x()); addValue(rect.y()); addValue(rect.width()); addValue(rect.height());
+  addValue(startAngle); addValue(sweepLength);
+
+  // end of arc (angles are in degrees counter clockwise with y down)
+  double a = (startAngle + sweepLength)*M_PI/180.0;
+
+  current_ = QPointF(rect.center().x() + rect.width ()*cos(a)/2,
+                     rect.center().y() - rect.height()*sin(a)/2);
+  empty_   = false;
+}
+
+void
+CQSVGPath::
+addText(const QPointF &p, const QFont &font, const QString &str)
+{
+  std::string key;
+
+  QPainterPath glyphs = glyphPath(font, str, key);
+
+  path_.addPath(glyphs.translated(p));
+
+  addValue(5);
+  addValue(p.x()); addValue(p.y());
+
+  hash_ = hashValue(hash_, double(std::hash<std::string>()(key)));
+
+  // current position is end of last glyph outline
+  int n = glyphs.elementCount();
+
+  if (n > 0) {
+    QPainterPath::Element e = glyphs.elementAt(n - 1);
+
+    current_ = p + QPointF(e.x, e.y);
+  }
+
+  empty_ = false;
+}
+
+void
+CQSVGPath::
+closeSubpath()
+{
+  path_.closeSubpath();
+
+  addValue(6);
+
+  current_ = start_;
+  empty_   = false;
+}
+
+void
+CQSVGPath::
+addValue(double value)
+{
+  hash_ = hashValue(hash_, value);
+}
+
+QPainterPath
+CQSVGPath::
+path(Qt::FillRule fillRule) const
+{
+  if (fillRule == Qt::WindingFill)
+    return path_;
+
+  QPainterPath path = path_;
+
+  path.setFillRule(fillRule);
+
+  return path;
+}
+
+QPainterPath
+CQSVGPath::
+strokeOutline(const QPen &pen)
+{
+  std::vector<double> strokeKey;
+
+  strokeKey.push_back(pen.widthF());
+  strokeKey.push_back(int(pen.capStyle()));
+  strokeKey.push_back(int(pen.joinStyle()));
+  strokeKey.push_back(pen.miterLimit());
+  strokeKey.push_back(pen.dashOffset());
+
+  for (const auto &d : pen.dashPattern())
+    strokeKey.push_back(d);
+
+  size_t h = hash_;
+
+  for (const auto &k : strokeKey)
+    h = hashValue(h, k);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto range = entryMap_.equal_range(h);
+
+    for (auto p = range.first; p != range.second; ++p) {
+      EntryList::iterator pe = (*p).second;
+
+      const EntryP &e = *pe;
+
+      if (e->strokeKey == strokeKey && e->path == path_) {
+        // move to front (most recently used)
+        entries_.splice(entries_.begin(), entries_, pe);
+
+        return detachedPath(e->stroke);
+      }
+    }
+  }
+
+  // not cached so build
+  QPainterPathStroker stroker;
+
+  stroker.setCapStyle   (pen.capStyle());
+  stroker.setDashOffset (pen.dashOffset());
+  stroker.setDashPattern(pen.dashPattern());
+  stroker.setJoinStyle  (pen.joinStyle());
+  stroker.setMiterLimit (pen.miterLimit());
+  stroker.setWidth      (pen.widthF());
+
+  QPainterPath stroke = stroker.createStroke(path_);
+
+  EntryP e = std::make_shared<Entry>();
+
+  e->hash      = h;
+  e->path      = detachedPath(path_);
+  e->strokeKey = strokeKey;
+  e->stroke    = detachedPath(stroke);
+  e->bytes     = sizeof(Entry) + strokeKey.size()*sizeof(double) +
+                 pathBytes(e->path) + pathBytes(e->stroke);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  entries_.push_front(e);
+
+  entryMap_.insert(EntryMap::value_type(h, entries_.begin()));
+
+  entriesBytes_ += e->bytes;
+
+  // drop least recently used entries over limit
+  while (entriesBytes_ > maxEntryBytes && ! entries_.empty()) {
+    EntryList::iterator pe = std::prev(entries_.end());
+
+    auto range = entryMap_.equal_range((*pe)->hash);
+
+    for (auto p = range.first; p != range.second; ++p) {
+      if ((*p).second == pe) {
+        entryMap_.erase(p);
+        break;
+      }
+    }
+
+    entriesBytes_ -= (*pe)->bytes;
+
+    entries_.erase(pe);
+  }
+
+  return stroke;
+}
+
+QPainterPath
+CQSVGPath::
+glyphPath(const QFont &font, const QString &str, std::string &key)
+{
+  typedef std::pair<std::string, QPainterPath>                 Glyph;
+  typedef std::list<Glyph>                                     GlyphList;
+  typedef std::unordered_map<std::string, GlyphList::iterator> GlyphMap;
+
+  static GlyphList  glyphList; // most recently used first
+  static GlyphMap   glyphMap;
+  static size_t     glyphBytes;
+  static std::mutex glyphMutex;
+
+  key = font.key().toStdString() + "\n" + str.toStdString();
+
+  std::lock_guard<std::mutex> lock(glyphMutex);
+
+  auto p = glyphMap.find(key);
+
+  if (p != glyphMap.end()) {
+    // move to front (most recently used)
+    glyphList.splice(glyphList.begin(), glyphList, (*p).second);
+
+    return detachedPath(glyphList.front().second);
+  }
+
+  QPainterPath path;
+
+  path.addText(QPointF(0, 0), font, str);
+
+  glyphList.push_front(Glyph(key, detachedPath(path)));
+
+  glyphMap[key] = glyphList.begin();
+
+  glyphBytes += 2*key.size() + pathBytes(path);
+
+  // drop least recently used outlines over limit
+  while (glyphBytes > maxGlyphBytes && ! glyphList.empty()) {
+    const Glyph &glyph = glyphList.back();
+
+    glyphBytes -= 2*glyph.first.size() + pathBytes(glyph.second);
+
+    glyphMap.erase(glyph.first);
+
+    glyphList.pop_back();
+  }
+
+  return path;
+}
+
+void
+CQSVGPath::
+clearCache()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  entries_ .clear();
+  entryMap_.clear();
+
+  entriesBytes_ = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef CQSVGPath_H
+#define CQSVGPath_H
+
+#include <QPainterPath>
+#include <QFont>
+#include <QPen>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// path built by the SVG renderer
+//
+// The QPainterPath is built as commands are added. Stroke outlines (much more expensive
+// to build than the path) are cached by path and pen so the unchanged shapes of a redraw
+// reuse their outline, and text glyph outlines are cached by font and string. Both
+// caches drop their least recently used entries when over a byte limit.
+//
+// QPainterPath computes its bounds lazily in const calls so cached paths are only
+// accessed under the cache lock and callers are given deep copies.
+class CQSVGPath {
+ public:
+  CQSVGPath() { }
+
+  void init();
+
+  bool isEmpty() const { return empty_; }
+
+  const QPointF &currentPosition() const { return current_; }
+
+  void moveTo (const QPointF &p);
+  void lineTo (const QPointF &p);
+  void quadTo (const QPointF &p1, const QPointF &p2);
+  void cubicTo(const QPointF &p1, const QPointF &p2, const QPointF &p3);
+  void arcTo  (const QRectF &rect, double startAngle, double sweepLength);
+
+  void addText(const QPointF &p, const QFont &font, const QString &str);
+
+  void closeSubpath();
+
+  // painter path for added commands
+  QPainterPath path(Qt::FillRule fillRule=Qt::WindingFill) const;
+
+  // stroke outline of path for pen (as filled by QPainter::strokePath)
+  QPainterPath strokeOutline(const QPen &pen);
+
+  // drop all cached stroke outlines
+  static void clearCache();
+
+ private:
+  struct Entry;
+
+  typedef std::shared_ptr<Entry>                               EntryP;
+  typedef std::list<EntryP>                                    EntryList;
+  typedef std::unordered_multimap<size_t, EntryList::iterator> EntryMap;
+
+  void addValue(double value);
+
+  static QPainterPath glyphPath(const QFont &font, const QString &str, std::string &key);
+
+ private:
+  QPainterPath path_;
+  size_t       hash_ { 0 };
+  QPointF      start_;
+  QPointF      current_;
+  bool         empty_ { true };
+
+  static EntryList  entries_;      // most recently used first
+  static EntryMap   entryMap_;     // entries by path and pen hash
+  static size_t     entriesBytes_;
+  static std::mutex mutex_;
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include <CQSVGRenderer.h>
 #include <CQSVGImageData.h>
+#include <CQSVGThreadPool.h>
 #include <CQSVGFontObj.h>
 #include <CSVGFontDef.h>
 #include <CQUtil.h>
@@ -7,23 +8,6 @@
 #include <CRadialGradient.h>
 
 namespace {
-  CRGBA getPixel(const QImage &image, int x, int y) {
-    QRgb rgb = image.pixel(x, y);
-
-    double r = qRed  (rgb)/255.0;
-    double g = qGreen(rgb)/255.0;
-    double b = qBlue (rgb)/255.0;
-    double a = qAlpha(rgb)/255.0;
-
-    return CRGBA(r, g, b, a);
-  }
-
-  void setPixel(QImage &image, int x, int y, const CRGBA &rgba) {
-    QRgb rgb = qRgba(rgba.getRedI(), rgba.getGreenI(), rgba.getBlueI(), rgba.getAlphaI());
-
-    image.setPixel(x, y, rgb);
-  }
-
   void clipOutside(QImage &image, int x1, int y1, int x2, int y2) {
     QRgb rgb = qRgba(0, 0, 0, 0);
 
@@ -62,26 +46,6 @@ namespace {
     return image1;
   }
 #endif
-
-  QImage opacityImage(const QImage &image, double opacity) {
-    QImage image1 = createImage(image.width(), image.height());
-
-    for (int y = 0; y < image.height(); ++y) {
-      for (int x = 0; x < image.width(); ++x) {
-        QRgb rgb = image.pixel(x, y);
-
-        int r = qRed  (rgb);
-        int g = qGreen(rgb);
-        int b = qBlue (rgb);
-        int a = qAlpha(rgb)*opacity;
-
-        if (a > 0)
-          image1.setPixel(x, y, qRgba(r, g, b, a));
-      }
-    }
-
-    return image1;
-  }
 }
 
 //------
@@ -113,7 +77,6 @@ CQSVGRenderer::
 {
   delete imageData_;
 
-  delete path_;
   delete savePath_;
 }
 
@@ -121,7 +84,33 @@ CQSVGRenderer *
 CQSVGRenderer::
 dup() const
 {
-  return new CQSVGRenderer;
+  CQSVGRenderer *renderer = new CQSVGRenderer;
+
+  // filter buffers share region of interest
+  renderer->imageData_->setROI(imageData_->roi());
+
+  return renderer;
+}
+
+void
+CQSVGRenderer::
+setRegionOfInterest(const QRect &rect)
+{
+  CQSVGImageData::ROIP roi = std::make_shared<CQSVGImageData::ROI>();
+
+  roi->rect = rect;
+  roi->size = QSize(imageData_->getWidth(), imageData_->getHeight());
+
+  imageData_->setROI(roi);
+}
+
+int
+CQSVGRenderer::
+regionFootprint() const
+{
+  const CQSVGImageData::ROIP &roi = imageData_->roi();
+
+  return (roi ? roi->footprint : 0);
 }
 
 void
@@ -291,93 +280,71 @@ void
 CQSVGRenderer::
 pathInit()
 {
-  delete path_;
-
-  path_ = new QPainterPath;
-
-  path_->setFillRule(Qt::WindingFill);
-
-  pathEmpty_ = true;
+  path_.init();
 }
 
 void
 CQSVGRenderer::
 pathMoveTo(const CPoint2D &p)
 {
-  path_->moveTo(p.x, p.y);
-
-  pathEmpty_ = false;
+  path_.moveTo(CQUtil::toQPoint(p));
 }
 
 void
 CQSVGRenderer::
 pathRMoveTo(const CPoint2D &p)
 {
-  CPoint2D c = CQUtil::fromQPoint(path_->currentPosition());
-
-  path_->moveTo(c.x + p.x, c.y + p.y);
+  CPoint2D c = CQUtil::fromQPoint(path_.currentPosition());
 
-  pathEmpty_ = false;
+  path_.moveTo(CQUtil::toQPoint(c + p));
 }
 
 void
 CQSVGRenderer::
 pathLineTo(const CPoint2D &p)
 {
-  path_->lineTo(p.x, p.y);
-
-  pathEmpty_ = false;
+  path_.lineTo(CQUtil::toQPoint(p));
 }
 
 void
 CQSVGRenderer::
 pathRLineTo(const CPoint2D &p)
 {
-  CPoint2D c = CQUtil::fromQPoint(path_->currentPosition());
-
-  path_->lineTo(c.x + p.x, c.y + p.y);
+  CPoint2D c = CQUtil::fromQPoint(path_.currentPosition());
 
-  pathEmpty_ = false;
+  path_.lineTo(CQUtil::toQPoint(c + p));
 }
 
 void
 CQSVGRenderer::
 pathCurveTo(const CPoint2D &p1, const CPoint2D &p2)
 {
-  path_->quadTo(CQUtil::toQPoint(p1), CQUtil::toQPoint(p2));
-
-  pathEmpty_ = false;
+  path_.quadTo(CQUtil::toQPoint(p1), CQUtil::toQPoint(p2));
 }
 
 void
 CQSVGRenderer::
 pathRCurveTo(const CPoint2D &p1, const CPoint2D &p2)
 {
-  CPoint2D c = CQUtil::fromQPoint(path_->currentPosition());
-
-  path_->quadTo(CQUtil::toQPoint(c + p1), CQUtil::toQPoint(c + p2));
+  CPoint2D c = CQUtil::fromQPoint(path_.currentPosition());
 
-  pathEmpty_ = false;
+  path_.quadTo(CQUtil::toQPoint(c + p1), CQUtil::toQPoint(c + p2));
 }
 
 void
 CQSVGRenderer::
 pathCurveTo(const CPoint2D &p1, const CPoint2D &p2, const CPoint2D &p3)
 {
-  path_->cubicTo(CQUtil::toQPoint(p1), CQUtil::toQPoint(p2), CQUtil::toQPoint(p3));
-
-  pathEmpty_ = false;
+  path_.cubicTo(CQUtil::toQPoint(p1), CQUtil::toQPoint(p2), CQUtil::toQPoint(p3));
 }
 
 void
 CQSVGRenderer::
 pathRCurveTo(const CPoint2D &p1, const CPoint2D &p2, const CPoint2D &p3)
 {
-  CPoint2D c = CQUtil::fromQPoint(path_->currentPosition());
-
-  path_->cubicTo(CQUtil::toQPoint(c + p1), CQUtil::toQPoint(c + p2), CQUtil::toQPoint(c + p3));
+  CPoint2D c = CQUtil::fromQPoint(path_.currentPosition());
 
-  pathEmpty_ = false;
+  path_.cubicTo(CQUtil::toQPoint(c + p1), CQUtil::toQPoint(c + p2), CQUtil::toQPoint(c + p3));
 }
 
 void
@@ -389,9 +356,7 @@ pathArcTo(const CPoint2D &c, double xr, double yr, double angle1, double angle2)
   double a1 = -CMathGen::RadToDeg(angle1);
   double a2 = -CMathGen::RadToDeg(angle2);
 
-  path_->arcTo(rect, a1, a2 - a1);
-
-  pathEmpty_ = false;
+  path_.arcTo(rect, a1, a2 - a1);
 }
 
 void
@@ -400,30 +365,27 @@ pathText(const std::string &str)
 {
   QString qstr = QString::fromUtf8(str.c_str());
 
-  QPointF c = path_->currentPosition();
-
-  path_->addText(c, qfont_, qstr);
+  QPointF c = path_.currentPosition();
 
-  pathEmpty_ = false;
+  // glyph outlines are cached by font and string
+  path_.addText(c, qfont_, qstr);
 }
 
 void
 CQSVGRenderer::
 pathClose()
 {
-  path_->closeSubpath();
-
-  pathEmpty_ = false;
+  path_.closeSubpath();
 }
 
 bool
 CQSVGRenderer::
 pathGetCurrentPoint(CPoint2D &p)
 {
-  if (pathEmpty_)
+  if (path_.isEmpty())
     return false;
 
-  p = CQUtil::fromQPoint(path_->currentPosition());
+  p = CQUtil::fromQPoint(path_.currentPosition());
 
   return true;
 }
@@ -434,21 +396,15 @@ pathStroke()
 {
   assert(drawing_);
 
-  if (strokeFilled_) {
-    QPainterPathStroker stroker;
-
-    stroker.setCapStyle   (pen_.capStyle());
-    stroker.setDashOffset (pen_.dashOffset());
-    stroker.setDashPattern(pen_.dashPattern());
-    stroker.setJoinStyle  (pen_.joinStyle());
-    stroker.setMiterLimit (pen_.miterLimit());
-    stroker.setWidth      (pen_.widthF());
-
-    painter_->fillPath(stroker.createStroke(*path_), strokeBrush_);
-  }
-  else {
-    painter_->strokePath(*path_, pen_);
-  }
+  // stroke outline is cached by path and pen (cosmetic pens are drawn by the paint engine)
+  if      (strokeFilled_)
+    painter_->fillPath(path_.strokeOutline(pen_), strokeBrush_);
+  else if (pen_.style() == Qt::NoPen)
+    return;
+  else if (! pen_.isCosmetic())
+    painter_->fillPath(path_.strokeOutline(pen_), pen_.brush());
+  else
+    painter_->strokePath(path_.path(), pen_);
 }
 
 void
@@ -457,9 +413,9 @@ pathFill()
 {
   assert(drawing_);
 
-  path_->setFillRule(fillType_ == FILL_TYPE_EVEN_ODD ? Qt::OddEvenFill : Qt::WindingFill);
+  Qt::FillRule fillRule = (fillType_ == FILL_TYPE_EVEN_ODD ? Qt::OddEvenFill : Qt::WindingFill);
 
-  painter_->fillPath(*path_, fillBrush_);
+  painter_->fillPath(path_.path(fillRule), fillBrush_);
 }
 
 void
@@ -468,7 +424,7 @@ savePath(const CMatrix2D &m)
 {
   QTransform matrix = CQUtil::toQTransform(m);
 
-  QList<QPolygonF> polygons = path_->toSubpathPolygons(matrix);
+  QList<QPolygonF> polygons = path_.path().toSubpathPolygons(matrix);
 
   delete savePath_;
 
@@ -491,7 +447,7 @@ pathClip(CSVGRenderer *renderer)
     painter_->setClipPath(*qrenderer->savePath_);
   }
   else
-    painter_->setClipPath(*path_);
+    painter_->setClipPath(path_.path());
 }
 
 void
@@ -508,7 +464,7 @@ pathEoclip(CSVGRenderer *renderer)
     painter_->setClipPath(*qrenderer->savePath_);
   }
   else
-    painter_->setClipPath(*path_);
+    painter_->setClipPath(path_.path());
 }
 
 void
@@ -529,7 +485,7 @@ void
 CQSVGRenderer::
 pathBBox(CBBox2D &bbox)
 {
-  bbox = CQUtil::fromQRect(path_->boundingRect());
+  bbox = CQUtil::fromQRect(path_.path().boundingRect());
 }
 
 void
@@ -905,26 +861,23 @@ combine(int ix, int iy, CSVGRenderer *r)
   int w = std::max(iwidth1 , ix + iwidth2 );
   int h = std::max(iheight1, iy + iheight2);
 
-  QImage image2 = qr->qimage();
+  // opacity is applied while blending (no intermediate image)
+  const QImage &image2 = qr->qimage();
 
-  if (qr->opacity() < 1)
-    image2 = opacityImage(image2, qr->opacity());
+  double opacity = std::min(std::max(qr->opacity(), 0.0), 1.0);
 
   if (w > iwidth1 || h > iheight1) {
-    QImage image1 = imageData_->qimage();
     QImage image3 = createImage(w, h);
 
-    image3.fill(0);
-
-    combineImage(image3,  0,  0, image1);
-    combineImage(image3, ix, iy, image2);
+    combineImage(image3,  0,  0, imageData_->qimage());
+    combineImage(image3, ix, iy, image2, opacity);
 
     setQImage(image3);
   }
   else {
     QImage *qimage = imageData_->lockImage();
 
-    combineImage(*qimage, ix, iy, image2);
+    combineImage(*qimage, ix, iy, image2, opacity);
 
     imageData_->unlockImage();
   }
@@ -932,47 +885,75 @@ combine(int ix, int iy, CSVGRenderer *r)
 
 void
 CQSVGRenderer::
-combineImage(QImage &image1, int x, int y, const QImage &image2)
+combineImage(QImage &image1, int x, int y, const QImage &image2, double opacity,
+             const QRect &rect2)
 {
-  // combine image2 into image1 at (x, y)
+  // source over blend of image2 (or rect2 of image2) into image1 at (x, y), done in place
+  // on scanlines. Images are non-premultiplied ARGB32
+  if (image1.format() != QImage::Format_ARGB32)
+    image1 = image1.convertToFormat(QImage::Format_ARGB32);
 
-  CRGBA rgba1, rgba2;
+  // detach before writing scanlines from worker threads
+  (void) image1.bits();
 
-  int w1 = image1.width ();
-  int h1 = image1.height();
+  const QImage &src = (image2.format() == QImage::Format_ARGB32 ? image2 :
+                       image2.convertToFormat(QImage::Format_ARGB32));
 
-  int w2 = image2.width ();
-  int h2 = image2.height();
+  int iopacity = int(opacity*255 + 0.5);
 
-  int w = std::min(w1, w2);
-  int h = std::min(h1, h2);
+  if (iopacity <= 0)
+    return;
 
-  for (int y1 = 0; y1 < h; ++y1) {
-    int y2 = y1 + y;
+  QRect srect = (rect2.isNull() ? src.rect() : rect2.intersected(src.rect()));
 
-    if (y2 < 0 || y2 >= h1) continue;
+  // clip source rect to destination
+  QRect drect = srect.translated(x, y).intersected(image1.rect());
 
-    for (int x1 = 0; x1 < w; ++x1) {
-      int x2 = x1 + x;
+  if (drect.isEmpty())
+    return;
 
-      if (x2 < 0 || x2 >= w1) continue;
+  int sx = drect.left() - x;
+  int sy = drect.top () - y;
+  int w  = drect.width ();
+  int h  = drect.height();
 
-      CRGBA rgba1 = getPixel(image2, x1, y1);
+  CQSVGThreadPoolInst->parallelFor(h, [&](int l1, int l2) {
+    for (int l = l1; l < l2; ++l) {
+      const QRgb *sline = reinterpret_cast<const QRgb *>(src.constScanLine(sy + l)) + sx;
+      QRgb       *dline = reinterpret_cast<QRgb *>(image1.scanLine(drect.top() + l)) + drect.left();
 
-      if (! rgba1.getAlphaI())
-        continue;
+      for (int i = 0; i < w; ++i) {
+        QRgb sp = sline[i];
 
-      CRGBA rgba2 = getPixel(image1, x2, y2);
+        int sa = qAlpha(sp);
 
-      if (! rgba2.getAlphaI())
-        setPixel(image1, x2, y2, rgba1);
-      else {
-        CRGBA rgba = rgba2.combined(rgba1);
+        if (iopacity < 255)
+          sa = (sa*iopacity + 127)/255;
 
-        setPixel(image1, x2, y2, rgba);
+        if (! sa)
+          continue;
+
+        QRgb dp = dline[i];
+
+        int da = qAlpha(dp);
+
+        if (sa == 255 || ! da) {
+          dline[i] = (sp & 0x00ffffff) | (QRgb(sa) << 24);
+          continue;
+        }
+
+        // alpha (x 255): sa + da*(1 - sa)
+        int da1 = da*(255 - sa);
+        int oa  = sa*255 + da1;
+
+        int r = (qRed  (sp)*sa*255 + qRed  (dp)*da1 + oa/2)/oa;
+        int g = (qGreen(sp)*sa*255 + qGreen(dp)*da1 + oa/2)/oa;
+        int b = (qBlue (sp)*sa*255 + qBlue (dp)*da1 + oa/2)/oa;
+
+        dline[i] = qRgba(r, g, b, (oa + 127)/255);
       }
     }
-  }
+  }, 32);
 }
 
 void
@@ -1007,13 +988,11 @@ addClippedImage(CSVGRenderer *src, int x, int y, int px1, int py1, int px2, int
   CQSVGRenderer *qsrc = dynamic_cast<CQSVGRenderer *>(src);
   assert(qsrc);
 
-  QImage qimage1 = qsrc->qimage();
-
-  clipOutside(qimage1, px1, py1, px2, py2);
-
+  // only blend clip rect of source
   QImage *qimage = imageData_->lockImage();
 
-  combineImage(*qimage, x - px1, y - py1, qimage1);
+  combineImage(*qimage, x - px1, y - py1, qsrc->qimage(), 1.0,
+               QRect(QPoint(px1, py1), QPoint(px2, py2)));
 
   imageData_->unlockImage();
 }
@@ -2,6 +2,7 @@
 #define CQSVG_RENDERER_H
 
 #include <CSVGRenderer.h>
+#include <CQSVGPath.h>
 #include <CDisplayTransform2D.h>
 
 #include <QImage>
@@ -27,6 +28,13 @@ class CQSVGRenderer : public CSVGRenderer {
   bool isDrawing() const { return drawing_; }
   void setDrawing(bool b) { drawing_ = b; }
 
+  // region of interest for filter primitives in pixels (null rect is whole image).
+  // Shared with renderers (and images) created from this one
+  void setRegionOfInterest(const QRect &rect);
+
+  // sum of footprints of filter primitives evaluated since region of interest was set
+  int regionFootprint() const;
+
   void setSize(int width, int height) override;
   void getSize(int *width, int *height) const override;
 
@@ -144,13 +152,13 @@ class CQSVGRenderer : public CSVGRenderer {
   void paint(QPainter *painter);
 
  private:
-  static void combineImage(QImage &image1, int x, int y, const QImage &image2);
+  static void combineImage(QImage &image1, int x, int y, const QImage &image2,
+                           double opacity=1.0, const QRect &rect2=QRect());
 
  private:
   CQSVGImageData* imageData_;
   QPainter*       painter_ { 0 };
-  QPainterPath*   path_ { 0 };
-  bool            pathEmpty_ { true };
+  CQSVGPath       path_;
   QPainterPath*   savePath_ { 0 };
   QPen            pen_;
   QFont           qfont_;
@@ -0,0 +1,136 @@
+#include <CQSVGThreadPool.h>
+#include <algorithm>
+
+namespace {
+
+// set for pool workers (and caller while running) to detect nested calls
+thread_local bool inPool = false;
+
+}
+
+CQSVGThreadPool *
+CQSVGThreadPool::
+getInstance()
+{
+  static CQSVGThreadPool *instance;
+
+  if (! instance)
+    instance = new CQSVGThreadPool;
+
+  return instance;
+}
+
+CQSVGThreadPool::
+CQSVGThreadPool()
+{
+  int n = int(std::thread::hardware_concurrency());
+
+  for (int i = 1; i < n; ++i)
+    threads_.emplace_back(&CQSVGThreadPool::workerProc, this);
+}
+
+CQSVGThreadPool::
+~CQSVGThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    stop_ = true;
+  }
+
+  startCond_.notify_all();
+
+  for (auto &thread : threads_)
+    thread.join();
+}
+
+void
+CQSVGThreadPool::
+parallelFor(int n, const RangeProc &proc, int minChunk)
+{
+  if (n <= 0)
+    return;
+
+  // run serially if small, no workers, nested or pool in use
+  if (threads_.empty() || n <= minChunk || inPool || ! runMutex_.try_lock()) {
+    proc(0, n);
+    return;
+  }
+
+  std::lock_guard<std::mutex> runLock(runMutex_, std::adopt_lock);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // several chunks per thread to balance uneven rows
+    proc_  = &proc;
+    n_     = n;
+    chunk_ = std::max(minChunk, n/(4*numThreads()));
+    next_  = 0;
+    busy_  = int(threads_.size());
+
+    ++generation_;
+  }
+
+  startCond_.notify_all();
+
+  inPool = true;
+
+  runChunks();
+
+  inPool = false;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  doneCond_.wait(lock, [this]() { return busy_ == 0; });
+
+  proc_ = nullptr;
+}
+
+void
+CQSVGThreadPool::
+workerProc()
+{
+  inPool = true;
+
+  unsigned int generation = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      startCond_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+
+      if (stop_)
+        return;
+
+      generation = generation_;
+    }
+
+    runChunks();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      --busy_;
+    }
+
+    doneCond_.notify_one();
+  }
+}
+
+void
+CQSVGThreadPool::
+runChunks()
+{
+  while (true) {
+    int i1 = next_.fetch_add(chunk_);
+
+    if (i1 >= n_)
+      break;
+
+    int i2 = std::min(i1 + chunk_, n_);
+
+    (*proc_)(i1, i2);
+  }
+}
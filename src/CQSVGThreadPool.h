@@ -0,0 +1,55 @@
+#ifndef CQSVGThreadPool_H
+#define CQSVGThreadPool_H
+
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define CQSVGThreadPoolInst CQSVGThreadPool::getInstance()
+
+// fixed size worker pool for splitting image rows/columns across cores
+//
+// parallelFor blocks until the whole range is processed (the calling thread also
+// processes chunks). Nested or concurrent calls run serially on the calling thread.
+class CQSVGThreadPool {
+ public:
+  typedef std::function<void(int, int)> RangeProc;
+
+ public:
+  static CQSVGThreadPool *getInstance();
+
+ ~CQSVGThreadPool();
+
+  int numThreads() const { return int(threads_.size()) + 1; }
+
+  // call proc(i1, i2) for sub ranges [i1, i2) of [0, n)
+  void parallelFor(int n, const RangeProc &proc, int minChunk=16);
+
+ private:
+  CQSVGThreadPool();
+
+  void workerProc();
+
+  void runChunks();
+
+ private:
+  typedef std::vector<std::thread> Threads;
+
+  Threads                 threads_;
+  std::mutex              runMutex_;
+  std::mutex              mutex_;
+  std::condition_variable startCond_;
+  std::condition_variable doneCond_;
+  const RangeProc*        proc_ { nullptr };
+  int                     n_ { 0 };
+  int                     chunk_ { 1 };
+  std::atomic<int>        next_ { 0 };
+  int                     busy_ { 0 };
+  unsigned int            generation_ { 0 };
+  bool                    stop_ { false };
+};
+
+#endif
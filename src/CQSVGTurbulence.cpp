@@ -0,0 +1,282 @@
+#include <CQSVGTurbulence.h>
+#include <CQSVGThreadPool.h>
+#include <cmath>
+
+namespace {
+
+const long RAND_m = 2147483647;
+const long RAND_a = 16807;
+const long RAND_q = 127773; // m / a
+const long RAND_r = 2836;   // m % a
+
+long setupSeed(long seed) {
+  if (seed <= 0) seed = -(seed % (RAND_m - 1)) + 1;
+
+  if (seed > RAND_m - 1) seed = RAND_m - 1;
+
+  return seed;
+}
+
+long nextRandom(long seed) {
+  long result = RAND_a*(seed % RAND_q) - RAND_r*(seed / RAND_q);
+
+  if (result <= 0) result += RAND_m;
+
+  return result;
+}
+
+inline double sCurve(double t) { return t*t*(3.0 - 2.0*t); }
+
+inline double lerp(double t, double a, double b) { return a + t*(b - a); }
+
+// maximum memory held by cached noise images
+const size_t maxCacheBytes = 32*1024*1024;
+
+}
+
+//---
+
+CQSVGTurbulence::Cache CQSVGTurbulence::cache_;
+size_t                 CQSVGTurbulence::cacheBytes_ = 0;
+std::mutex             CQSVGTurbulence::cacheMutex_;
+
+QImage
+CQSVGTurbulence::
+image(const Params &params)
+{
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+
+    for (auto p = cache_.begin(); p != cache_.end(); ++p) {
+      if ((*p).first == params) {
+        // move to front (most recently used)
+        cache_.splice(cache_.begin(), cache_, p);
+
+        return cache_.front().second;
+      }
+    }
+  }
+
+  QImage image = generate(params);
+
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+
+  // most recently used at front, oldest dropped when over limit
+  cache_.push_front(CacheEntry(params, image));
+
+  cacheBytes_ += image.byteCount();
+
+  while (cacheBytes_ > maxCacheBytes && ! cache_.empty()) {
+    cacheBytes_ -= cache_.back().second.byteCount();
+
+    cache_.pop_back();
+  }
+
+  return image;
+}
+
+QImage
+CQSVGTurbulence::
+generate(const Params &params)
+{
+  QRect rect = params.genRect();
+
+  QImage image(rect.width(), rect.height(), QImage::Format_ARGB32);
+
+  CQSVGTurbulence turbulence(params.seed);
+
+  auto toByte = [](double v) {
+    int i = int(v*255.0 + 0.5);
+
+    return (i < 0 ? 0 : (i > 255 ? 255 : i));
+  };
+
+  // only rect rows/columns are generated (noise value is independent of rect)
+  CQSVGThreadPoolInst->parallelFor(rect.height(), [&](int y1, int y2) {
+    double rgba[4];
+
+    for (int y = y1; y < y2; ++y) {
+      QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+
+      for (int x = 0; x < rect.width(); ++x) {
+        turbulence.turbulence(params, rect.x() + x, rect.y() + y, rgba);
+
+        if (params.fractal) {
+          for (int i = 0; i < 4; ++i)
+            rgba[i] = (rgba[i] + 1.0)/2.0;
+        }
+
+        line[x] = qRgba(toByte(rgba[0]), toByte(rgba[1]), toByte(rgba[2]), toByte(rgba[3]));
+      }
+    }
+  }, 4);
+
+  return image;
+}
+
+//---
+
+CQSVGTurbulence::
+CQSVGTurbulence(int seed)
+{
+  long lseed = setupSeed(seed);
+
+  int i, j, k;
+
+  for (k = 0; k < 4; ++k) {
+    for (i = 0; i < BSize; ++i) {
+      latticeSelector_[i] = i;
+
+      for (j = 0; j < 2; ++j)
+        gradient_[i][k][j] = double(((lseed = nextRandom(lseed)) % (BSize + BSize)) - BSize)/BSize;
+
+      double s = sqrt(gradient_[i][k][0]*gradient_[i][k][0] +
+                      gradient_[i][k][1]*gradient_[i][k][1]);
+
+      if (s > 0) {
+        gradient_[i][k][0] /= s;
+        gradient_[i][k][1] /= s;
+      }
+    }
+  }
+
+  while (--i) {
+    k = latticeSelector_[i];
+
+    latticeSelector_[i] = latticeSelector_[j = (lseed = nextRandom(lseed)) % BSize];
+    latticeSelector_[j] = k;
+  }
+
+  for (i = 0; i < BSize + 2; ++i) {
+    latticeSelector_[BSize + i] = latticeSelector_[i];
+
+    for (k = 0; k < 4; ++k)
+      for (j = 0; j < 2; ++j)
+        gradient_[BSize + i][k][j] = gradient_[i][k][j];
+  }
+}
+
+void
+CQSVGTurbulence::
+turbulence(const Params &params, double x, double y, double rgba[4]) const
+{
+  StitchInfo  stitch;
+  StitchInfo *pstitch = nullptr;
+
+  double baseFreqX = params.baseFreqX;
+  double baseFreqY = params.baseFreqY;
+
+  // adjust base frequencies so tile is an integral number of noise periods
+  if (params.stitch && params.width > 0 && params.height > 0) {
+    if (baseFreqX != 0.0) {
+      double lo = floor(params.width*baseFreqX)/params.width;
+      double hi = ceil (params.width*baseFreqX)/params.width;
+
+      baseFreqX = ((baseFreqX/lo < hi/baseFreqX) ? lo : hi);
+    }
+
+    if (baseFreqY != 0.0) {
+      double lo = floor(params.height*baseFreqY)/params.height;
+      double hi = ceil (params.height*baseFreqY)/params.height;
+
+      baseFreqY = ((baseFreqY/lo < hi/baseFreqY) ? lo : hi);
+    }
+
+    pstitch = &stitch;
+
+    stitch.width  = int(params.width *baseFreqX + 0.5);
+    stitch.height = int(params.height*baseFreqY + 0.5);
+    stitch.wrapX  = stitch.width  + PerlinN;
+    stitch.wrapY  = stitch.height + PerlinN;
+  }
+
+  rgba[0] = rgba[1] = rgba[2] = rgba[3] = 0.0;
+
+  double vec[2] = { x*baseFreqX, y*baseFreqY };
+
+  double ratio = 1.0;
+
+  double noise[4];
+
+  for (int octave = 0; octave < params.numOctaves; ++octave) {
+    noise2(vec, pstitch, noise);
+
+    if (params.fractal) {
+      for (int i = 0; i < 4; ++i)
+        rgba[i] += noise[i]/ratio;
+    }
+    else {
+      for (int i = 0; i < 4; ++i)
+        rgba[i] += fabs(noise[i])/ratio;
+    }
+
+    vec[0] *= 2;
+    vec[1] *= 2;
+
+    ratio *= 2;
+
+    if (pstitch) {
+      // update stitch values, subtracting PerlinN before the multiplication and
+      // adding it afterward simplifies to subtracting it once
+      stitch.width  *= 2;
+      stitch.wrapX   = 2*stitch.wrapX - PerlinN;
+      stitch.height *= 2;
+      stitch.wrapY   = 2*stitch.wrapY - PerlinN;
+    }
+  }
+}
+
+void
+CQSVGTurbulence::
+noise2(const double vec[2], const StitchInfo *stitch, double rgba[4]) const
+{
+  double t = vec[0] + PerlinN;
+
+  int bx0 = int(t);
+  int bx1 = bx0 + 1;
+
+  double rx0 = t - int(t);
+  double rx1 = rx0 - 1.0;
+
+  t = vec[1] + PerlinN;
+
+  int by0 = int(t);
+  int by1 = by0 + 1;
+
+  double ry0 = t - int(t);
+  double ry1 = ry0 - 1.0;
+
+  // if stitching, adjust lattice points accordingly
+  if (stitch) {
+    if (bx0 >= stitch->wrapX) bx0 -= stitch->width;
+    if (bx1 >= stitch->wrapX) bx1 -= stitch->width;
+    if (by0 >= stitch->wrapY) by0 -= stitch->height;
+    if (by1 >= stitch->wrapY) by1 -= stitch->height;
+  }
+
+  bx0 &= BM; bx1 &= BM;
+  by0 &= BM; by1 &= BM;
+
+  // lattice lookups and interpolation weights are shared by all channels
+  int i = latticeSelector_[bx0];
+  int j = latticeSelector_[bx1];
+
+  int b00 = latticeSelector_[i + by0];
+  int b10 = latticeSelector_[j + by0];
+  int b01 = latticeSelector_[i + by1];
+  int b11 = latticeSelector_[j + by1];
+
+  double sx = sCurve(rx0);
+  double sy = sCurve(ry0);
+
+  for (int k = 0; k < 4; ++k) {
+    const double *q;
+
+    q = gradient_[b00][k]; double u1 = rx0*q[0] + ry0*q[1];
+    q = gradient_[b10][k]; double v1 = rx1*q[0] + ry0*q[1];
+    q = gradient_[b01][k]; double u2 = rx0*q[0] + ry1*q[1];
+    q = gradient_[b11][k]; double v2 = rx1*q[0] + ry1*q[1];
+
+    rgba[k] = lerp(sy, lerp(sx, u1, v1), lerp(sx, u2, v2));
+  }
+}
@@ -0,0 +1,73 @@
+#ifndef CQSVGTurbulence_H
+#define CQSVGTurbulence_H
+
+#include <QImage>
+#include <mutex>
+#include <list>
+
+// feTurbulence noise generator (reference algorithm from SVG specification)
+//
+// All four color channels are computed together from shared lattice lookups and
+// generated images are cached (up to a memory limit) so repeated draws of the same
+// texture are free.
+class CQSVGTurbulence {
+ public:
+  struct Params {
+    bool   fractal    { false };
+    double baseFreqX  { 0.0 };
+    double baseFreqY  { 0.0 };
+    int    numOctaves { 1 };
+    int    seed       { 0 };
+    bool   stitch     { false };
+    int    width      { 0 };
+    int    height     { 0 };
+    QRect  rect;        // generated region of width x height tile (null for all)
+
+    QRect genRect() const {
+      return (rect.isNull() ? QRect(0, 0, width, height) : rect);
+    }
+
+    bool operator==(const Params &p) const {
+      return (fractal == p.fractal && baseFreqX == p.baseFreqX && baseFreqY == p.baseFreqY &&
+              numOctaves == p.numOctaves && seed == p.seed && stitch == p.stitch &&
+              width == p.width && height == p.height && genRect() == p.genRect());
+    }
+  };
+
+ public:
+  // get (cached) ARGB32 noise image of params rect (pixel 0,0 is rect top left)
+  static QImage image(const Params &params);
+
+ public:
+  explicit CQSVGTurbulence(int seed);
+
+  // turbulence value of each channel (r, g, b, a) at point
+  void turbulence(const Params &params, double x, double y, double rgba[4]) const;
+
+ private:
+  enum { BSize = 0x100, BM = 0xff, PerlinN = 0x1000 };
+
+  struct StitchInfo {
+    int width;  // How much to subtract to wrap for stitching.
+    int height;
+    int wrapX;  // Minimum value to wrap.
+    int wrapY;
+  };
+
+  void noise2(const double vec[2], const StitchInfo *stitch, double rgba[4]) const;
+
+  static QImage generate(const Params &params);
+
+ private:
+  typedef std::pair<Params, QImage> CacheEntry;
+  typedef std::list<CacheEntry>     Cache;
+
+  static Cache      cache_;
+  static size_t     cacheBytes_;
+  static std::mutex cacheMutex_;
+
+  int    latticeSelector_[BSize + BSize + 2];
+  double gradient_[BSize + BSize + 2][4][2];
+};
+
+#endif